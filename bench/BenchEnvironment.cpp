@@ -0,0 +1,108 @@
+#include "BenchEnvironment.h"
+#include <cstdlib>
+#include <mutex>
+
+namespace {
+
+std::string envOr(const char* name, const std::string& fallback) {
+    const char* value = std::getenv(name);
+    return (value && *value) ? std::string(value) : fallback;
+}
+
+int envIntOr(const char* name, int fallback) {
+    const char* value = std::getenv(name);
+    if (!value || !*value) {
+        return fallback;
+    }
+    try {
+        return std::stoi(value);
+    } catch (...) {
+        return fallback;
+    }
+}
+
+double envDoubleOr(const char* name, double fallback) {
+    const char* value = std::getenv(name);
+    if (!value || !*value) {
+        return fallback;
+    }
+    try {
+        return std::stod(value);
+    } catch (...) {
+        return fallback;
+    }
+}
+
+// 进程内共享一个代理实例，所有基准测试的连接都经过它
+std::unique_ptr<NetworkProxy> g_proxy;
+std::mutex g_proxyMutex;
+
+} // namespace
+
+const BenchEnvironment& BenchEnvironment::get() {
+    static const BenchEnvironment env = []() {
+        BenchEnvironment e;
+        e.host = envOr("ADJUSTBIAS_BENCH_HOST", e.host);
+        e.port = envIntOr("ADJUSTBIAS_BENCH_PORT", e.port);
+        e.username = envOr("ADJUSTBIAS_BENCH_USER", envOr("USERNAME", envOr("USER", "")));
+        e.password = envOr("ADJUSTBIAS_BENCH_PASSWORD", "");
+        e.keyPath = envOr("ADJUSTBIAS_BENCH_KEY", "");
+        e.useAgent = !envOr("ADJUSTBIAS_BENCH_AGENT", "").empty();
+        e.remoteDir = envOr("ADJUSTBIAS_BENCH_REMOTE_DIR", e.remoteDir);
+        NetworkProxy::namedProfile(envOr("ADJUSTBIAS_BENCH_PROFILE", ""), e.profile);
+        e.profile.rttMs = envIntOr("ADJUSTBIAS_BENCH_RTT_MS", e.profile.rttMs);
+        e.profile.jitterMs = envIntOr("ADJUSTBIAS_BENCH_JITTER_MS", e.profile.jitterMs);
+        e.profile.bandwidthKbps = envIntOr("ADJUSTBIAS_BENCH_BW_KBPS", static_cast<int>(e.profile.bandwidthKbps));
+        e.profile.lossPercent = envDoubleOr("ADJUSTBIAS_BENCH_LOSS_PCT", e.profile.lossPercent);
+        e.verbose = !envOr("ADJUSTBIAS_BENCH_VERBOSE", "").empty();
+        return e;
+    }();
+    return env;
+}
+
+std::unique_ptr<SSHManager> connectBenchSession(std::string& error) {
+    return connectBenchSession(error, TransportProfileRegistry::forHost(BenchEnvironment::get().host,
+                                                                       TransportProfile::libssh2Default()));
+}
+
+std::unique_ptr<SSHManager> connectBenchSession(std::string& error, const TransportProfile& transport) {
+    const BenchEnvironment& env = BenchEnvironment::get();
+    std::string host = env.host;
+    int port = env.port;
+
+    try {
+        if (env.useProxy()) {
+            std::lock_guard<std::mutex> lock(g_proxyMutex);
+            if (!g_proxy) {
+                g_proxy = std::make_unique<NetworkProxy>(env.host, env.port, env.profile);
+                g_proxy->start();
+            }
+            host = "127.0.0.1";
+            port = g_proxy->getListenPort();
+        }
+        SSHAuthOptions auth = SSHAuthOptions::withPassword(env.password);
+        auth.useAgent = env.useAgent;
+        auth.key = SSHKeyCache::load(env.keyPath);
+        return std::make_unique<SSHManager>(host, env.username, auth, port, transport);
+    } catch (const std::exception& e) {
+        error = std::string("connect ") + env.host + ":" + std::to_string(env.port) + " failed: " + e.what();
+        return nullptr;
+    }
+}
+
+std::string makeBenchConfigContent(size_t size) {
+    std::string content =
+        "xsense_data_roll=0.0\n"
+        "xsense_data_pitch=0.0\n"
+        "x_vel_offset=0.0\n"
+        "y_vel_offset=0.0\n"
+        "yaw_vel_offset=0.0\n"
+        "x_vel_offset_run=0.0\n"
+        "y_vel_offset_run=0.0\n"
+        "yaw_vel_offset_run=0.0\n";
+    // 用与真实策略文件相似的键值行填充到目标大小
+    for (size_t i = 0; content.size() < size; ++i) {
+        content += "policy_weight_" + std::to_string(i) + "=0.123456789\n";
+    }
+    return content;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include "SSHManager.h"
+#include "NetworkProxy.h"
+
+// ===== adjustBias_bench 运行环境 =====
+// 所有基准测试共享的连接参数，全部来自环境变量，便于在 CI 或开发机上切换目标：
+//   ADJUSTBIAS_BENCH_HOST        目标 sshd 地址（默认 127.0.0.1，即本机 OpenSSH）
+//   ADJUSTBIAS_BENCH_PORT        目标端口（默认 22）
+//   ADJUSTBIAS_BENCH_USER        用户名（默认取 USERNAME / USER）
+//   ADJUSTBIAS_BENCH_PASSWORD    密码
+//   ADJUSTBIAS_BENCH_KEY         私钥文件（设置后先尝试公钥认证，失败再用密码）
+//   ADJUSTBIAS_BENCH_AGENT       非空时先尝试 ssh-agent
+//   ADJUSTBIAS_BENCH_REMOTE_DIR  远端工作目录（默认 /tmp/adjustBias_bench）
+//   ADJUSTBIAS_BENCH_PROFILE     NetworkProxy 预置场景名（如 wifi-lossy），下列变量可逐项覆盖
+//   ADJUSTBIAS_BENCH_RTT_MS      通过 NetworkProxy 注入的往返时延（默认 0，不经过代理）
+//   ADJUSTBIAS_BENCH_JITTER_MS   通过 NetworkProxy 注入的随机抖动
+//   ADJUSTBIAS_BENCH_BW_KBPS     通过 NetworkProxy 注入的单向带宽上限（默认 0，不限速）
+//   ADJUSTBIAS_BENCH_LOSS_PCT    通过 NetworkProxy 注入的丢包重传概率（%）
+//   ADJUSTBIAS_BENCH_VERBOSE     非空时保留 qDebug 输出
+struct BenchEnvironment {
+    std::string host = "127.0.0.1";
+    int port = 22;
+    std::string username;
+    std::string password;
+    std::string keyPath;
+    bool useAgent = false;
+    std::string remoteDir = "/tmp/adjustBias_bench";
+    NetworkProxy::Profile profile;
+    bool verbose = false;
+
+    // 是否需要经过延迟代理
+    bool useProxy() const {
+        return profile.rttMs > 0 || profile.jitterMs > 0 || profile.bandwidthKbps > 0 ||
+               profile.lossPercent > 0.0 || profile.halfOpenPercent > 0.0;
+    }
+
+    // 远端基准配置文件路径
+    std::string remoteConfigPath() const { return remoteDir + "/rl_control_new.txt"; }
+
+    static const BenchEnvironment& get();
+};
+
+// 建立一个基准测试用的 SSH 会话；启用代理时连接经过进程内的 NetworkProxy。
+// 失败时返回 nullptr 并把原因写入 error，调用方应 SkipWithError 而不是让整个套件失败。
+std::unique_ptr<SSHManager> connectBenchSession(std::string& error);
+
+// 同上，但使用指定的传输方案（算法偏好 / 压缩）
+std::unique_ptr<SSHManager> connectBenchSession(std::string& error, const TransportProfile& transport);
+
+// 生成约 size 字节、格式与 rl_control_new.txt 相同的配置内容
+std::string makeBenchConfigContent(size_t size);
@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "BiasEstimator.h"
+#include "DriftLogStore.h"
+
+// ===== 漂移日志解析与偏置估计基准（纯 CPU，无需 sshd）=====
+// 1kHz 记录约 17 分钟即为百万样本；估计在界面线程中同步执行，整体需保持在一秒以内。
+
+namespace {
+
+std::string makeDriftCsv(size_t lines) {
+    std::string csv = "t,vx,vy,wz,cmd_vx,cmd_vy,cmd_wz,gait\n";
+    char line[160];
+    for (size_t i = 0; i < lines; ++i) {
+        const bool run = (i / 50000) % 2 == 1;
+        const double cmd = ((i / 2000) % 5) * 0.1;
+        const double noise = ((i * 2654435761u) % 1000) * 1e-5 - 0.005;
+        int len = std::snprintf(line, sizeof(line), "%.3f,%.5f,%.5f,%.6f,%.2f,0,0,%s\n", i * 0.001,
+                                (run ? 0.03 : 0.02) + 0.95 * cmd + noise, -0.011 + noise, 0.0008 + noise * 0.1, cmd,
+                                run ? "run" : "walk");
+        csv.append(line, static_cast<size_t>(len));
+    }
+    return csv;
+}
+
+const std::string& driftCsv() {
+    static const std::string csv = makeDriftCsv(1000000);
+    return csv;
+}
+
+// 写入临时目录并转换一次，之后各基准共用同一个映射的分析文件
+const DriftLogStore& driftStore() {
+    static const DriftLogStore store = [] {
+        const std::string path = (std::filesystem::temp_directory_path() / "adjustBias_bench_drift.csv").string();
+        std::ofstream(path, std::ios::binary) << driftCsv();
+        DriftLogStore::convert(path, path + DriftLogStore::kExtension);
+        return DriftLogStore::open(path + DriftLogStore::kExtension);
+    }();
+    return store;
+}
+
+} // namespace
+
+static void BM_DriftLogParse(benchmark::State& state) {
+    const std::string& csv = driftCsv();
+    for (auto _ : state) {
+        DriftLog log = DriftLog::parse(csv.data(), csv.size());
+        benchmark::DoNotOptimize(log.vx.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(csv.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 1000000);
+}
+BENCHMARK(BM_DriftLogParse)->Unit(benchmark::kMillisecond);
+
+// 只测求解（日志已解析为列式数组），包含按步态拆分与批矩累加
+static void BM_BiasEstimate(benchmark::State& state) {
+    const std::string& csv = driftCsv();
+    const DriftLog log = DriftLog::parse(csv.data(), csv.size());
+    const std::map<std::string, double> current = {{"x_vel_offset", 0.0}, {"x_vel_offset_run", 0.0}};
+    for (auto _ : state) {
+        BiasEstimator::Result result = BiasEstimator::estimate(log, current);
+        benchmark::DoNotOptimize(result.estimates.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(log.size()));
+}
+BENCHMARK(BM_BiasEstimate)->Unit(benchmark::kMillisecond);
+
+// 文本 -> 列式文件的一次性转换（含写盘）
+static void BM_DriftStoreConvert(benchmark::State& state) {
+    driftStore();
+    const std::string path = (std::filesystem::temp_directory_path() / "adjustBias_bench_drift.csv").string();
+    for (auto _ : state) {
+        DriftLogStore::ConvertStats stats = DriftLogStore::convert(path, path + ".convert" + DriftLogStore::kExtension);
+        benchmark::DoNotOptimize(stats.rows);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(driftCsv().size()));
+}
+BENCHMARK(BM_DriftStoreConvert)->Unit(benchmark::kMillisecond);
+
+// “指令为零且步态为走时的平均 wz”：两个条件的掩码扫描，arg0 = 0 标量 / 1 AVX2
+static void BM_DriftStoreMaskedMean(benchmark::State& state) {
+    const DriftLogStore::Impl impl = state.range(0) ? DriftLogStore::Impl::AVX2 : DriftLogStore::Impl::Scalar;
+    if (!DriftLogStore::isSupported(impl)) {
+        state.SkipWithError("impl not supported on this CPU");
+        return;
+    }
+    const DriftLogStore& store = driftStore();
+    DriftLogStore::Condition zeroCommand{"cmd_vx", DriftLogStore::Condition::AbsLe, 0.0};
+    DriftLogStore::Condition walking{"gait", DriftLogStore::Condition::Eq, 0.0};
+    for (auto _ : state) {
+        DriftLogStore::Stats stats = store.statsWith(impl, "wz", {zeroCommand, walking},
+                                                     -std::numeric_limits<double>::infinity(),
+                                                     std::numeric_limits<double>::infinity());
+        benchmark::DoNotOptimize(stats.mean);
+    }
+    state.SetLabel(DriftLogStore::implName(impl));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(store.rows()));
+}
+BENCHMARK(BM_DriftStoreMaskedMean)->ArgName("avx2")->Arg(0)->Arg(1);
@@ -0,0 +1,223 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "BenchEnvironment.h"
+#include "ForwardManager.h"
+
+// ===== 端口转发基准 =====
+// 不依赖机器人上的任何服务：在本进程内起一个回显服务，
+//   远程转发  目标机 127.0.0.1:<sshd 分配的端口> -> 本机回显服务
+//   本地转发  本机 127.0.0.1:<L> -> 目标机 127.0.0.1:<上面的端口>
+// 写入 L 的数据经 SSH 到达目标机，再经同一会话回到本机回显服务并原路返回，
+// 因此每个字节在 SSH 链路上往返两次。目标 sshd 需要 AllowTcpForwarding yes。
+
+namespace {
+
+// 本机 TCP 回显服务，每个连接一个线程
+class EchoServer {
+public:
+    ~EchoServer() { stop(); }
+
+    int start() {
+        listenSock = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in sin{};
+        sin.sin_family = AF_INET;
+        sin.sin_port = 0;
+        inet_pton(AF_INET, "127.0.0.1", &sin.sin_addr);
+        if (listenSock == INVALID_SOCKET || bind(listenSock, reinterpret_cast<sockaddr*>(&sin), sizeof(sin)) ||
+            listen(listenSock, 16)) {
+            return 0;
+        }
+        socklen_t len = sizeof(sin);
+        getsockname(listenSock, reinterpret_cast<sockaddr*>(&sin), &len);
+        acceptThread = std::thread([this] { acceptLoop(); });
+        return ntohs(sin.sin_port);
+    }
+
+    void stop() {
+        if (listenSock != INVALID_SOCKET) {
+            shutdown(listenSock, SD_BOTH);
+            closesocket(listenSock);
+            listenSock = INVALID_SOCKET;
+        }
+        if (acceptThread.joinable()) {
+            acceptThread.join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (SOCKET s : clients) {
+                shutdown(s, SD_BOTH);
+            }
+        }
+        for (auto& t : echoThreads) {
+            t.join();
+        }
+        echoThreads.clear();
+        for (SOCKET s : clients) {
+            closesocket(s);
+        }
+        clients.clear();
+    }
+
+private:
+    void acceptLoop() {
+        SOCKET client;
+        while ((client = accept(listenSock, nullptr, nullptr)) != INVALID_SOCKET) {
+            std::lock_guard<std::mutex> lock(mutex);
+            clients.push_back(client);
+            echoThreads.emplace_back([client] {
+                std::vector<char> buffer(64 * 1024);
+                int n;
+                while ((n = recv(client, buffer.data(), static_cast<int>(buffer.size()), 0)) > 0) {
+                    for (int sent = 0, rc; sent < n; sent += rc) {
+                        if ((rc = send(client, buffer.data() + sent, n - sent, 0)) <= 0) {
+                            return;
+                        }
+                    }
+                }
+            });
+        }
+    }
+
+    SOCKET listenSock = INVALID_SOCKET;
+    std::thread acceptThread;
+    std::mutex mutex;
+    std::vector<SOCKET> clients;
+    std::vector<std::thread> echoThreads;
+};
+
+struct ForwardLoop {
+    std::unique_ptr<SSHManager> manager;
+    std::unique_ptr<ForwardManager> forwards;
+    EchoServer echo;
+    SOCKET client = INVALID_SOCKET;
+
+    ~ForwardLoop() {
+        if (client != INVALID_SOCKET) {
+            closesocket(client);
+        }
+        if (forwards) {
+            forwards->stop();
+        }
+        echo.stop();
+    }
+
+    bool open(benchmark::State& state) {
+        std::string error;
+        manager = connectBenchSession(error);
+        if (!manager) {
+            state.SkipWithError(error.c_str());
+            return false;
+        }
+        int echoPort = echo.start();
+        if (echoPort == 0) {
+            state.SkipWithError("echo server failed to start");
+            return false;
+        }
+        try {
+            forwards = std::make_unique<ForwardManager>(manager.get());
+            int remotePort = forwards->addRemoteForward(0, "127.0.0.1", echoPort);
+            int localPort = forwards->addLocalForward("127.0.0.1", remotePort);
+            forwards->start();
+
+            client = socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in sin{};
+            sin.sin_family = AF_INET;
+            sin.sin_port = htons(static_cast<u_short>(localPort));
+            inet_pton(AF_INET, "127.0.0.1", &sin.sin_addr);
+            if (client == INVALID_SOCKET || connect(client, reinterpret_cast<sockaddr*>(&sin), sizeof(sin))) {
+                state.SkipWithError("connect to local forward failed");
+                return false;
+            }
+            int flag = 1;
+            setsockopt(client, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&flag), sizeof(flag));
+        } catch (const std::exception& e) {
+            state.SkipWithError(e.what());
+            return false;
+        }
+        return true;
+    }
+};
+
+bool recvAll(SOCKET s, char* data, size_t size) {
+    for (size_t got = 0; got < size;) {
+        int n = recv(s, data + got, static_cast<int>(size - got), 0);
+        if (n <= 0) {
+            return false;
+        }
+        got += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool sendAll(SOCKET s, const char* data, size_t size) {
+    for (size_t sent = 0; sent < size;) {
+        int n = send(s, data + sent, static_cast<int>(size - sent), 0);
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+// 批量吞吐：每次迭代经转发环路回显 4MB，第一个参数为单次 send 的块大小
+static void BM_ForwardThroughput(benchmark::State& state) {
+    ForwardLoop loop;
+    if (!loop.open(state)) {
+        return;
+    }
+
+    const size_t chunk = static_cast<size_t>(state.range(0));
+    const size_t total = 4 * 1024 * 1024;
+    std::vector<char> out(chunk, 'x');
+    std::vector<char> in(chunk);
+
+    for (auto _ : state) {
+        // 写与读必须并发，否则两端缓冲区填满后互相等待
+        bool sendOk = true;
+        std::thread writer([&] {
+            for (size_t sent = 0; sent < total && sendOk; sent += chunk) {
+                sendOk = sendAll(loop.client, out.data(), std::min(chunk, total - sent));
+            }
+        });
+        bool recvOk = true;
+        for (size_t got = 0; got < total && recvOk; got += chunk) {
+            recvOk = recvAll(loop.client, in.data(), std::min(chunk, total - got));
+        }
+        writer.join();
+        if (!sendOk || !recvOk) {
+            state.SkipWithError("forward loop broken");
+            return;
+        }
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(total));
+    ForwardManager::Stats stats = loop.forwards->getStats();
+    state.counters["connections"] = static_cast<double>(stats.connections);
+}
+BENCHMARK(BM_ForwardThroughput)->ArgName("chunk")->Arg(4 * 1024)->Arg(64 * 1024)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 遥测小包往返：一帧 IMU / 里程计数据量级的消息经转发环路的往返时间
+static void BM_ForwardRoundTrip(benchmark::State& state) {
+    ForwardLoop loop;
+    if (!loop.open(state)) {
+        return;
+    }
+
+    std::vector<char> message(static_cast<size_t>(state.range(0)), 't');
+    std::vector<char> reply(message.size());
+    for (auto _ : state) {
+        if (!sendAll(loop.client, message.data(), message.size()) ||
+            !recvAll(loop.client, reply.data(), reply.size())) {
+            state.SkipWithError("forward loop broken");
+            return;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_ForwardRoundTrip)->ArgName("bytes")->Arg(64)->Arg(1024)->Unit(benchmark::kMicrosecond)->UseRealTime();
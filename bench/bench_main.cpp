@@ -0,0 +1,25 @@
+#include <benchmark/benchmark.h>
+#include <QtGlobal>
+#include "BenchEnvironment.h"
+
+// ConfigReader/SSHManager 会大量输出 qDebug，基准运行时默认丢弃以免影响计时
+static void quietMessageHandler(QtMsgType type, const QMessageLogContext&, const QString& msg) {
+    if (type == QtDebugMsg || type == QtInfoMsg) {
+        return;
+    }
+    fprintf(stderr, "%s\n", msg.toLocal8Bit().constData());
+}
+
+int main(int argc, char** argv) {
+    if (!BenchEnvironment::get().verbose) {
+        qInstallMessageHandler(quietMessageHandler);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,258 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SessionReactor.h"
+#include <ws2tcpip.h>
+#ifdef _WIN32
+#include <Windows.h>
+#include <psapi.h>
+#include <tlhelp32.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <unistd.h>
+#endif
+
+// ===== 会话监视开销基准 =====
+// 比较两种断线检测方式的线程数与常驻内存（不需要 SSH 服务器，用本机回环 TCP 连接对代替会话 socket）：
+//   ThreadPerSession  旧做法：每个会话一个监控线程，条件变量定时唤醒后 select + peek
+//   Reactor           SessionReactor：一个 WSAPoll 线程 + 固定数量的工作线程
+// 每轮：建立 N 个会话并注册监视 -> 采样线程数 / 内存 -> 关闭全部对端 -> 等待全部检测到断线 -> 注销。
+// 计时为整轮耗时；计数器：
+//   threads              监视期间进程比开始前多出的线程数
+//   rss_kb_per_session   监视期间常驻内存增量 / N（含 socket 缓冲区等两种方式相同的部分）
+//   detect_ms            关闭对端到全部检测到断线的耗时
+// 旧做法的检测周期本是 30 秒，这里缩短为 10 毫秒，只比较资源占用而不是检测延迟。
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+size_t residentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.WorkingSetSize : 0;
+#else
+    std::ifstream statm("/proc/self/statm");
+    size_t size = 0;
+    size_t resident = 0;
+    statm >> size >> resident;
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+int threadCount() {
+#ifdef _WIN32
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+    if (snapshot == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+    int count = 0;
+    THREADENTRY32 entry;
+    entry.dwSize = sizeof(entry);
+    for (BOOL ok = Thread32First(snapshot, &entry); ok; ok = Thread32Next(snapshot, &entry)) {
+        count += entry.th32OwnerProcessID == GetCurrentProcessId() ? 1 : 0;
+    }
+    CloseHandle(snapshot);
+    return count;
+#else
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 8, "Threads:") == 0) {
+            return std::stoi(line.substr(8));
+        }
+    }
+    return 0;
+#endif
+}
+
+// N 对回环 TCP 连接：local 一侧交给监视方，remote 一侧代表对端（关闭即模拟机器人断线）
+struct SocketPairs {
+    std::vector<SOCKET> local;
+    std::vector<SOCKET> remote;
+
+    bool open(int n) {
+        SOCKET listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in sin{};
+        sin.sin_family = AF_INET;
+        sin.sin_port = 0;
+        inet_pton(AF_INET, "127.0.0.1", &sin.sin_addr);
+        socklen_t len = sizeof(sin);
+        if (listener == INVALID_SOCKET || bind(listener, reinterpret_cast<sockaddr*>(&sin), sizeof(sin)) ||
+            listen(listener, SOMAXCONN) || getsockname(listener, reinterpret_cast<sockaddr*>(&sin), &len)) {
+            closesocket(listener);
+            return false;
+        }
+        for (int i = 0; i < n; ++i) {
+            SOCKET client = socket(AF_INET, SOCK_STREAM, 0);
+            if (client == INVALID_SOCKET || connect(client, reinterpret_cast<sockaddr*>(&sin), sizeof(sin))) {
+                closesocket(client);
+                break;
+            }
+            // 与 libssh2 握手后一致：会话 socket 为非阻塞
+            u_long nonBlocking = 1;
+            ioctlsocket(client, FIONBIO, &nonBlocking);
+            local.push_back(client);
+            remote.push_back(accept(listener, nullptr, nullptr));
+        }
+        closesocket(listener);
+        return static_cast<int>(local.size()) == n;
+    }
+
+    void closeRemote() {
+        for (SOCKET& s : remote) {
+            closesocket(s);
+            s = INVALID_SOCKET;
+        }
+    }
+
+    ~SocketPairs() {
+        closeRemote();
+        for (SOCKET s : local) {
+            closesocket(s);
+        }
+    }
+};
+
+bool waitFor(const std::atomic<int>& counter, int target) {
+    const auto deadline = Clock::now() + std::chrono::seconds(10);
+    while (counter.load() < target) {
+        if (Clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// 旧的监控线程：条件变量定时唤醒，select + peek 检查 socket
+class MonitorThread {
+public:
+    MonitorThread(SOCKET sock, std::atomic<int>& lost) : sock(sock), lost(lost) {
+        worker = std::thread([this]() { run(); });
+    }
+    ~MonitorThread() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        cv.notify_one();
+        worker.join();
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!cv.wait_for(lock, std::chrono::milliseconds(10), [this]() { return !running; })) {
+            if (reported) {
+                continue;
+            }
+            fd_set readfds;
+            FD_ZERO(&readfds);
+            FD_SET(sock, &readfds);
+            timeval tv{0, 0};
+            char byte;
+            if (select(static_cast<int>(sock + 1), &readfds, nullptr, nullptr, &tv) > 0 &&
+                recv(sock, &byte, 1, MSG_PEEK) == 0) {
+                reported = true;
+                ++lost;
+            }
+        }
+    }
+
+    SOCKET sock;
+    std::atomic<int>& lost;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool running = true;
+    bool reported = false;
+    std::thread worker;
+};
+
+void report(benchmark::State& state, int threadsBefore, size_t rssBefore, int threadsDuring, size_t rssDuring,
+            double detectMs) {
+    const double sessions = static_cast<double>(state.range(0));
+    state.counters["threads"] = threadsDuring - threadsBefore;
+    state.counters["rss_kb_per_session"] =
+        (static_cast<double>(rssDuring) - static_cast<double>(rssBefore)) / 1024.0 / sessions;
+    state.counters["detect_ms"] = detectMs;
+}
+
+void BM_ThreadPerSession(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        SocketPairs pairs;
+        if (!pairs.open(n)) {
+            state.SkipWithError("无法建立回环连接（检查打开文件数上限）");
+            return;
+        }
+        const int threadsBefore = threadCount();
+        const size_t rssBefore = residentBytes();
+
+        std::atomic<int> lost{0};
+        std::vector<std::unique_ptr<MonitorThread>> monitors;
+        for (SOCKET s : pairs.local) {
+            monitors.push_back(std::make_unique<MonitorThread>(s, lost));
+        }
+        const int threadsDuring = threadCount();
+        const size_t rssDuring = residentBytes();
+
+        const auto closed = Clock::now();
+        pairs.closeRemote();
+        if (!waitFor(lost, n)) {
+            state.SkipWithError("断线检测超时");
+            return;
+        }
+        const double detectMs = std::chrono::duration<double, std::milli>(Clock::now() - closed).count();
+        monitors.clear();
+        report(state, threadsBefore, rssBefore, threadsDuring, rssDuring, detectMs);
+    }
+}
+
+void BM_Reactor(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        SocketPairs pairs;
+        if (!pairs.open(n)) {
+            state.SkipWithError("无法建立回环连接（检查打开文件数上限）");
+            return;
+        }
+        const int threadsBefore = threadCount();
+        const size_t rssBefore = residentBytes();
+
+        std::atomic<int> lost{0};
+        SessionReactor reactor{SessionReactor::Options()};
+        std::vector<SessionReactor::Id> ids;
+        for (SOCKET s : pairs.local) {
+            SessionReactor::Callbacks callbacks;
+            callbacks.keepalive = [](int intervalSec) { return intervalSec; };
+            callbacks.disconnected = [&lost]() { ++lost; };
+            ids.push_back(reactor.add(s, callbacks));
+        }
+        const int threadsDuring = threadCount();
+        const size_t rssDuring = residentBytes();
+
+        const auto closed = Clock::now();
+        pairs.closeRemote();
+        if (!waitFor(lost, n)) {
+            state.SkipWithError("断线检测超时");
+            return;
+        }
+        const double detectMs = std::chrono::duration<double, std::milli>(Clock::now() - closed).count();
+        for (SessionReactor::Id id : ids) {
+            reactor.remove(id);
+        }
+        report(state, threadsBefore, rssBefore, threadsDuring, rssDuring, detectMs);
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_ThreadPerSession)->Arg(8)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Reactor)->Arg(8)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond)->UseRealTime();
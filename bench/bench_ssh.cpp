@@ -0,0 +1,264 @@
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include "BenchEnvironment.h"
+#include "ConfigReader.h"
+#include "FileHandler.h"
+#include "ParameterStreamer.h"
+
+// ===== SSH 端到端基准 =====
+// 针对本机 OpenSSH（或 ADJUSTBIAS_BENCH_HOST 指定的任意 sshd）测量
+// ConfigReader 的三条关键路径。连接在计时循环外建立，只计量操作本身。
+
+namespace {
+
+// 为基准准备会话和远端目录；失败时返回 nullptr 并跳过该基准
+std::unique_ptr<SSHManager> prepareSession(benchmark::State& state) {
+    std::string error;
+    auto manager = connectBenchSession(error);
+    if (!manager) {
+        state.SkipWithError(error.c_str());
+        return nullptr;
+    }
+
+    const BenchEnvironment& env = BenchEnvironment::get();
+    ConfigReader setup(manager.get(), env.remoteConfigPath());
+    setup.executeRemoteCommand("mkdir -p " + env.remoteDir);
+    if (!setup.atomicWriteRemoteFile(makeBenchConfigContent(0))) {
+        state.SkipWithError("failed to seed remote config file");
+        return nullptr;
+    }
+
+    state.counters["rtt_ms"] = env.profile.rttMs;
+    state.counters["bw_kbps"] = static_cast<double>(env.profile.bandwidthKbps);
+    return manager;
+}
+
+} // namespace
+
+// 建立连接：TCP connect + 握手 + 认证
+static void BM_SSHConnect(benchmark::State& state) {
+    for (auto _ : state) {
+        std::string error;
+        auto manager = connectBenchSession(error);
+        if (!manager) {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+        state.SetLabel(manager->getAuthMethod());
+        benchmark::DoNotOptimize(manager.get());
+    }
+}
+BENCHMARK(BM_SSHConnect)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 单条远端命令：arg0 = 0 每条命令打开通道 + exec，1 经常驻远端代理一次帧往返
+static void BM_RemoteCommand(benchmark::State& state) {
+    auto manager = prepareSession(state);
+    if (!manager) {
+        return;
+    }
+
+    manager->enableRemoteAgent(state.range(0) != 0);
+    if (state.range(0) != 0 && !manager->getRemoteAgent()) {
+        state.SkipWithError("remote agent failed to start");
+        return;
+    }
+    ConfigReader reader(manager.get(), BenchEnvironment::get().remoteConfigPath());
+    for (auto _ : state) {
+        std::string output = reader.executeRemoteCommand("echo ok");
+        benchmark::DoNotOptimize(output.data());
+    }
+}
+BENCHMARK(BM_RemoteCommand)->ArgName("agent")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 加载配置：存在性检查 + 读取 + 解析/去重 + 补充缺失参数
+static void BM_LoadConfig(benchmark::State& state) {
+    auto manager = prepareSession(state);
+    if (!manager) {
+        return;
+    }
+
+    manager->enableRemoteAgent(state.range(0) != 0);
+    ConfigReader reader(manager.get(), BenchEnvironment::get().remoteConfigPath());
+    for (auto _ : state) {
+        if (!reader.loadConfig()) {
+            state.SkipWithError("loadConfig failed");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_LoadConfig)->ArgName("agent")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 保存配置：读取 + 批量替换 10 个参数 + 原子写回
+static void BM_UpdateMultipleParameters(benchmark::State& state) {
+    auto manager = prepareSession(state);
+    if (!manager) {
+        return;
+    }
+
+    manager->enableRemoteAgent(state.range(0) != 0);
+    ConfigReader reader(manager.get(), BenchEnvironment::get().remoteConfigPath());
+    double value = 0.0;
+    for (auto _ : state) {
+        // 每轮改变取值，确保每次都真实写入新内容
+        value += 0.001;
+        if (!reader.updateMultipleParameters(value, value, value, value, value,
+                                             value, value, value, 0.5, 1.0)) {
+            state.SkipWithError("updateMultipleParameters failed");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_UpdateMultipleParameters)->ArgName("agent")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 保存 -> 控制器确认 的端到端延迟：需要在目标机器上运行 tools/fake_controller.sh --ack <文件>，
+// 并设置 ADJUSTBIAS_CONFIG_NOTIFY（通知方式，",ack=" 指向同一个文件）；notify 在控制器确认后才返回
+static void BM_SaveWithLiveReload(benchmark::State& state) {
+    auto notifier = IConfigNotifier::fromEnvironment();
+    if (!notifier) {
+        state.SkipWithError("ADJUSTBIAS_CONFIG_NOTIFY not set");
+        return;
+    }
+    auto manager = prepareSession(state);
+    if (!manager) {
+        return;
+    }
+
+    manager->enableRemoteAgent(state.range(0) != 0);
+    ConfigReader reader(manager.get(), BenchEnvironment::get().remoteConfigPath());
+    reader.setNotifier(std::move(notifier));
+    double value = 0.0;
+    for (auto _ : state) {
+        value += 0.001;
+        if (!reader.updateMultipleParameters(value, value, value, value, value,
+                                             value, value, value, 0.5, 1.0) || !reader.wasLiveUpdated()) {
+            state.SkipWithError("save failed or controller did not acknowledge reload");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_SaveWithLiveReload)->ArgName("agent")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 实时调节：一次“按键连发”（arg0 次 push）到收到 ACK 的端到端延迟。
+// 需要目标机器上运行 tools/fake_controller.sh --stream <端口>，并设置 ADJUSTBIAS_BENCH_STREAM_PORT
+static void BM_ParameterStream(benchmark::State& state) {
+    const char* portEnv = std::getenv("ADJUSTBIAS_BENCH_STREAM_PORT");
+    if (!portEnv || !*portEnv) {
+        state.SkipWithError("ADJUSTBIAS_BENCH_STREAM_PORT not set");
+        return;
+    }
+    auto manager = prepareSession(state);
+    if (!manager) {
+        return;
+    }
+
+    ParameterStreamer streamer(manager.get());
+    ParameterStreamer::Options options;
+    options.remotePort = std::atoi(portEnv);
+    try {
+        streamer.start(options);
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+
+    const int burst = static_cast<int>(state.range(0));
+    double value = 0.0;
+    for (auto _ : state) {
+        const uint64_t ackedBefore = streamer.stats().acked;
+        for (int i = 0; i < burst; ++i) {
+            value += 0.001;
+            streamer.push("x_vel_offset", value);
+        }
+        // 连发的多次 push 合并为一条消息，等待它被确认
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (streamer.stats().acked == ackedBefore) {
+            if (!streamer.tick() || std::chrono::steady_clock::now() > deadline) {
+                state.SkipWithError("stream not acknowledged");
+                return;
+            }
+            manager->waitSocket(5);
+        }
+    }
+
+    ParameterStreamer::Stats stats = streamer.stats();
+    state.counters["messages"] = static_cast<double>(stats.messagesSent);
+    state.counters["updates"] = static_cast<double>(stats.updates);
+    state.counters["mean_latency_ms"] = stats.meanLatencyMs;
+    state.counters["max_latency_ms"] = stats.maxLatencyMs;
+}
+BENCHMARK(BM_ParameterStream)->ArgName("burst")->Arg(1)->Arg(10)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 原子写：按负载大小测量写临时文件 + mv 的开销
+static void BM_AtomicWriteRemoteFile(benchmark::State& state) {
+    auto manager = prepareSession(state);
+    if (!manager) {
+        return;
+    }
+
+    ConfigReader reader(manager.get(), BenchEnvironment::get().remoteConfigPath());
+    const std::string content = makeBenchConfigContent(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        if (!reader.atomicWriteRemoteFile(content)) {
+            state.SkipWithError("atomicWriteRemoteFile failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(content.size()));
+}
+BENCHMARK(BM_AtomicWriteRemoteFile)
+    ->Arg(1 << 10)
+    ->Arg(16 << 10)
+    ->Arg(64 << 10)
+    ->Arg(1 << 20)
+    ->Arg(16 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// 删除 N 个残留临时文件：arg1 = 0 逐个 removeRemoteFile，1 批量 removeRemoteFiles，2 cleanupOrphanedTempFiles
+static void BM_RemoveTempFiles(benchmark::State& state) {
+    auto manager = prepareSession(state);
+    if (!manager) {
+        return;
+    }
+
+    const BenchEnvironment& env = BenchEnvironment::get();
+    const int count = static_cast<int>(state.range(0));
+    const int mode = static_cast<int>(state.range(1));
+    const std::string base = env.remoteConfigPath() + ".tmp.";
+    ConfigReader shell(manager.get(), env.remoteConfigPath());
+    FileHandler handler(manager.get());
+
+    std::vector<std::string> paths;
+    for (int i = 0; i < count; ++i) {
+        paths.push_back(base + std::to_string(i));
+    }
+
+    try {
+        for (auto _ : state) {
+            state.PauseTiming();
+            // 造出 count 个 1 小时前的残留临时文件
+            shell.executeRemoteCommand("cd " + env.remoteDir + " && for i in $(seq 0 " + std::to_string(count - 1) +
+                                       "); do touch -d '-1 hour' rl_control_new.txt.tmp.$i; done");
+            state.ResumeTiming();
+
+            if (mode == 0) {
+                for (const auto& path : paths) {
+                    handler.removeRemoteFile(path);
+                }
+            } else if (mode == 1) {
+                handler.removeRemoteFiles({base + "*"});
+            } else {
+                handler.cleanupOrphanedTempFiles(env.remoteConfigPath());
+            }
+        }
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+    }
+}
+BENCHMARK(BM_RemoveTempFiles)
+    ->ArgNames({"files", "mode"})
+    ->Args({50, 0})
+    ->Args({50, 1})
+    ->Args({50, 2})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include "TelemetryParser.h"
+
+// ===== 遥测解析与环形缓冲区基准（纯 CPU，无需 sshd）=====
+// 1kHz 的 IMU/里程计输入约为 50KB/s，解析吞吐量需高出几个数量级，
+// 才能保证读取线程在一次 64KB 读取后立即回到 socket 上。
+
+namespace {
+
+std::string makeTelemetryCsv(size_t lines) {
+    std::string csv = "t,roll,pitch,vx,vy,wz\n";
+    char line[128];
+    for (size_t i = 0; i < lines; ++i) {
+        int len = std::snprintf(line, sizeof(line), "%.3f,%.4f,%.4f,%.5f,%.5f,%.6f\n", i * 0.001,
+                                0.42 + (i % 97) * 1e-4, -1.37 + (i % 89) * 1e-4, 0.003 + (i % 13) * 1e-5,
+                                -0.011 + (i % 7) * 1e-5, 0.0008 + (i % 5) * 1e-6);
+        csv.append(line, static_cast<size_t>(len));
+    }
+    return csv;
+}
+
+} // namespace
+
+// 按 arg0 字节切块喂给解析器（模拟每次 channel_read 的大小），样本写入环形缓冲区后立即取出
+static void BM_TelemetryParse(benchmark::State& state) {
+    const std::string csv = makeTelemetryCsv(20000);
+    const size_t chunk = static_cast<size_t>(state.range(0));
+    SpscRing<TelemetrySample> ring(4096);
+    size_t samples = 0;
+
+    for (auto _ : state) {
+        TelemetryLineParser parser;
+        for (size_t offset = 0; offset < csv.size(); offset += chunk) {
+            const size_t len = std::min(chunk, csv.size() - offset);
+            samples += parser.feed(csv.data() + offset, len, [&ring](const TelemetrySample& s) { ring.push(s); });
+            ring.drain([](const TelemetrySample& s) { benchmark::DoNotOptimize(s.roll); });
+        }
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(csv.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(samples));
+}
+BENCHMARK(BM_TelemetryParse)->ArgName("chunk")->Arg(256)->Arg(64 * 1024);
+
+// 生产者线程持续 push（满时让出 CPU），消费者尽快 drain：测量跨线程传递的样本吞吐量
+static void BM_TelemetryRingTransfer(benchmark::State& state) {
+    constexpr size_t kBatch = 1 << 20;
+    SpscRing<TelemetrySample> ring(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        std::thread producer([&] {
+            TelemetrySample sample;
+            for (size_t i = 0; i < kBatch; ++i) {
+                sample.t = static_cast<double>(i);
+                while (!ring.push(sample)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        size_t received = 0;
+        while (received < kBatch) {
+            received += ring.drain([](const TelemetrySample& s) { benchmark::DoNotOptimize(s.t); });
+        }
+        producer.join();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(kBatch));
+}
+BENCHMARK(BM_TelemetryRingTransfer)->ArgName("capacity")->Arg(1024)->Arg(16384)->UseRealTime();
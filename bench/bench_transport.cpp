@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include "BenchEnvironment.h"
+#include "ConfigReader.h"
+#include "FileHandler.h"
+
+// ===== 传输方案对比基准 =====
+// 第一个参数选择 TransportProfile：0 = default（libssh2 默认），1 = lan，2 = wifi（压缩）。
+// 配合 ADJUSTBIAS_BENCH_RTT_MS / ADJUSTBIAS_BENCH_BW_KBPS 模拟 Wi-Fi 链路时，
+// 文本数据下 wifi 方案的吞吐量应明显高于 lan；在不限速的本机/有线环境下则相反。
+
+namespace {
+
+TransportProfile profileFor(int64_t index) {
+    switch (index) {
+    case 1: return TransportProfile::lan();
+    case 2: return TransportProfile::wifi();
+    default: return TransportProfile::libssh2Default();
+    }
+}
+
+// compressible 为 true 时生成参数文件格式的文本，否则为随机字节
+std::string makeTransportFile(size_t size, bool compressible) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() /
+        ("adjustBias_bench_transport_" + std::to_string(size) + (compressible ? ".txt" : ".bin"));
+    if (std::filesystem::exists(path) && std::filesystem::file_size(path) == size) {
+        return path.string();
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (compressible) {
+        std::string content = makeBenchConfigContent(size);
+        out.write(content.data(), static_cast<std::streamsize>(std::min(content.size(), size)));
+    } else {
+        std::mt19937 rng(11);
+        std::vector<char> block(64 * 1024);
+        for (size_t written = 0; written < size; written += block.size()) {
+            for (auto& c : block) {
+                c = static_cast<char>(rng());
+            }
+            out.write(block.data(), static_cast<std::streamsize>(std::min(block.size(), size - written)));
+        }
+    }
+    return path.string();
+}
+
+} // namespace
+
+// 握手耗时：TCP connect + 密钥交换 + 认证
+static void BM_TransportHandshake(benchmark::State& state) {
+    const TransportProfile profile = profileFor(state.range(0));
+    for (auto _ : state) {
+        std::string error;
+        auto manager = connectBenchSession(error, profile);
+        if (!manager) {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(manager.get());
+    }
+    state.SetLabel(profile.name);
+}
+BENCHMARK(BM_TransportHandshake)
+    ->ArgName("profile")
+    ->DenseRange(0, 2)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// 批量上传吞吐量
+static void BM_TransportUpload(benchmark::State& state) {
+    const TransportProfile profile = profileFor(state.range(0));
+    std::string error;
+    auto manager = connectBenchSession(error, profile);
+    if (!manager) {
+        state.SkipWithError(error.c_str());
+        return;
+    }
+
+    const BenchEnvironment& env = BenchEnvironment::get();
+    const size_t size = static_cast<size_t>(state.range(1));
+    const std::string localPath = makeTransportFile(size, state.range(2) != 0);
+    const std::string remotePath = env.remoteDir + "/transport.bin";
+
+    FileHandler handler(manager.get());
+    try {
+        ConfigReader(manager.get(), env.remoteConfigPath()).executeRemoteCommand("mkdir -p " + env.remoteDir);
+        for (auto _ : state) {
+            FileHandler::UploadResult result = handler.uploadFile(localPath, remotePath, FileHandler::UploadOptions());
+            benchmark::DoNotOptimize(result.bytes);
+        }
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(size));
+    state.SetLabel(manager->getTransportProfile().name);
+}
+BENCHMARK(BM_TransportUpload)
+    ->ArgNames({"profile", "bytes", "text"})
+    ->ArgsProduct({{0, 1, 2}, {4 << 20}, {0, 1}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// 远端 cat 读取（与 loadConfig 读取配置文件的路径相同）
+static void BM_TransportCat(benchmark::State& state) {
+    const TransportProfile profile = profileFor(state.range(0));
+    std::string error;
+    auto manager = connectBenchSession(error, profile);
+    if (!manager) {
+        state.SkipWithError(error.c_str());
+        return;
+    }
+
+    const BenchEnvironment& env = BenchEnvironment::get();
+    const size_t size = static_cast<size_t>(state.range(1));
+    const std::string remotePath = env.remoteDir + "/transport.txt";
+
+    try {
+        ConfigReader reader(manager.get(), env.remoteConfigPath());
+        reader.executeRemoteCommand("mkdir -p " + env.remoteDir);
+        FileHandler(manager.get()).uploadFile(makeTransportFile(size, true), remotePath, FileHandler::UploadOptions());
+        for (auto _ : state) {
+            std::string output = reader.executeRemoteCommand("cat " + FileHandler::shellQuote(remotePath));
+            benchmark::DoNotOptimize(output.data());
+        }
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(size));
+    state.SetLabel(manager->getTransportProfile().name);
+}
+BENCHMARK(BM_TransportCat)
+    ->ArgNames({"profile", "bytes"})
+    ->ArgsProduct({{0, 1, 2}, {64 << 10, 1 << 20}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,195 @@
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include "BenchEnvironment.h"
+#include "ConfigReader.h"
+#include "FileHandler.h"
+
+// ===== SCP 上传吞吐量基准 =====
+// 本地生成随机文件，通过 FileHandler::uploadFile 上传到 ADJUSTBIAS_BENCH_REMOTE_DIR，
+// bytes_per_second 即上传吞吐量。第二个参数为缓冲区大小（KB），用于对比 1KB 旧实现与大缓冲区。
+
+namespace {
+
+std::string makeLocalFile(size_t size) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() /
+                                 ("adjustBias_bench_upload_" + std::to_string(size) + ".bin");
+    if (std::filesystem::exists(path) && std::filesystem::file_size(path) == size) {
+        return path.string();
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    std::mt19937 rng(7);
+    std::vector<char> block(64 * 1024);
+    for (size_t written = 0; written < size; written += block.size()) {
+        for (auto& c : block) {
+            c = static_cast<char>(rng());
+        }
+        out.write(block.data(), static_cast<std::streamsize>(std::min(block.size(), size - written)));
+    }
+    return path.string();
+}
+
+} // namespace
+
+static void BM_UploadFile(benchmark::State& state) {
+    std::string error;
+    auto manager = connectBenchSession(error);
+    if (!manager) {
+        state.SkipWithError(error.c_str());
+        return;
+    }
+
+    const BenchEnvironment& env = BenchEnvironment::get();
+    const size_t size = static_cast<size_t>(state.range(0));
+    const std::string localPath = makeLocalFile(size);
+    const std::string remotePath = env.remoteDir + "/upload.bin";
+
+    FileHandler handler(manager.get());
+    FileHandler::UploadOptions options;
+    options.bufferSize = static_cast<size_t>(state.range(1)) * 1024;
+
+    try {
+        ConfigReader(manager.get(), env.remoteConfigPath()).executeRemoteCommand("mkdir -p " + env.remoteDir);
+        for (auto _ : state) {
+            FileHandler::UploadResult result = handler.uploadFile(localPath, remotePath, options);
+            benchmark::DoNotOptimize(result.bytes);
+        }
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_UploadFile)
+    ->ArgNames({"bytes", "buffer_kb"})
+    ->Args({1 << 20, 1})
+    ->Args({1 << 20, 256})
+    ->Args({16 << 20, 256})
+    ->Args({64 << 20, 256})
+    ->Args({64 << 20, 1024})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// 带远端 sha256sum 校验的上传，衡量校验的额外开销
+static void BM_UploadFileVerified(benchmark::State& state) {
+    std::string error;
+    auto manager = connectBenchSession(error);
+    if (!manager) {
+        state.SkipWithError(error.c_str());
+        return;
+    }
+
+    const BenchEnvironment& env = BenchEnvironment::get();
+    const size_t size = static_cast<size_t>(state.range(0));
+    const std::string localPath = makeLocalFile(size);
+
+    FileHandler handler(manager.get());
+    FileHandler::UploadOptions options;
+    options.verifyChecksum = true;
+
+    try {
+        ConfigReader(manager.get(), env.remoteConfigPath()).executeRemoteCommand("mkdir -p " + env.remoteDir);
+        for (auto _ : state) {
+            FileHandler::UploadResult result = handler.uploadFile(localPath, env.remoteDir + "/upload.bin", options);
+            benchmark::DoNotOptimize(result.verified);
+        }
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_UploadFileVerified)->Arg(16 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 目录同步：64 个 256KB 文件全量上传到空目录，参数为并发通道数
+static void BM_SyncDirectory(benchmark::State& state) {
+    std::string error;
+    auto manager = connectBenchSession(error);
+    if (!manager) {
+        state.SkipWithError(error.c_str());
+        return;
+    }
+
+    const BenchEnvironment& env = BenchEnvironment::get();
+    std::filesystem::path localDir = std::filesystem::temp_directory_path() / "adjustBias_bench_sync";
+    std::filesystem::create_directories(localDir);
+    const std::string sample = makeLocalFile(256 * 1024);
+    for (int i = 0; i < 64; ++i) {
+        std::filesystem::path target = localDir / ("param_" + std::to_string(i) + ".bin");
+        if (!std::filesystem::exists(target)) {
+            std::filesystem::copy_file(sample, target);
+        }
+    }
+
+    const std::string remoteDir = env.remoteDir + "/sync";
+    FileHandler handler(manager.get());
+    ConfigReader shell(manager.get(), env.remoteConfigPath());
+    DirectorySync::Options options;
+    options.parallelChannels = static_cast<int>(state.range(0));
+
+    uint64_t bytes = 0;
+    double transferSeconds = 0.0;
+    try {
+        for (auto _ : state) {
+            state.PauseTiming();
+            shell.executeRemoteCommand("rm -rf " + remoteDir);
+            state.ResumeTiming();
+
+            DirectorySync::Report report = handler.syncDirectory(localDir.string(), remoteDir, options);
+            if (!report.ok()) {
+                state.SkipWithError(report.failures.front().second.c_str());
+                break;
+            }
+            bytes += report.bytesUploaded;
+            transferSeconds += report.transferSeconds;
+        }
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.counters["transfer_MBps"] = transferSeconds > 0.0 ? bytes / transferSeconds / (1024.0 * 1024.0) : 0.0;
+}
+BENCHMARK(BM_SyncDirectory)->ArgName("channels")->Arg(1)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// SFTP 下载：先上传一个文件，再反复下载到本地临时目录，第二个参数为 sftp_read 缓冲区（KB）
+static void BM_DownloadFile(benchmark::State& state) {
+    std::string error;
+    auto manager = connectBenchSession(error);
+    if (!manager) {
+        state.SkipWithError(error.c_str());
+        return;
+    }
+
+    const BenchEnvironment& env = BenchEnvironment::get();
+    const size_t size = static_cast<size_t>(state.range(0));
+    const std::string remotePath = env.remoteDir + "/download.bin";
+    const std::string localPath =
+        (std::filesystem::temp_directory_path() / "adjustBias_bench_download.bin").string();
+
+    FileHandler handler(manager.get());
+    FileHandler::DownloadOptions options;
+    options.bufferSize = static_cast<size_t>(state.range(1)) * 1024;
+    options.resume = false;
+
+    try {
+        ConfigReader(manager.get(), env.remoteConfigPath()).executeRemoteCommand("mkdir -p " + env.remoteDir);
+        handler.uploadFile(makeLocalFile(size), remotePath, FileHandler::UploadOptions());
+        for (auto _ : state) {
+            FileHandler::DownloadResult result = handler.downloadFile(remotePath, localPath, options);
+            benchmark::DoNotOptimize(result.bytes);
+        }
+    } catch (const std::exception& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_DownloadFile)
+    ->ArgNames({"bytes", "buffer_kb"})
+    ->Args({16 << 20, 32})
+    ->Args({16 << 20, 1024})
+    ->Args({64 << 20, 1024})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,397 @@
+#pragma once
+
+// ===== 协程远程操作 =====
+// 在非阻塞 libssh2 会话之上提供可 co_await 的远程操作，远程流程可以写成直线代码：
+//
+//   AsyncTask<void> audit(AsyncLoop& loop, SSHManager& ssh) {
+//       AsyncSession session(loop, ssh);
+//       AsyncSession::ExecResult r = co_await session.exec("cat -- /path/to/config");
+//       std::string text = co_await session.readFile("/path/to/config");   // SFTP
+//       Backoff backoff;
+//       co_await loop.sleep(backoff);
+//   }
+//
+// 等待 socket / 定时器期间不占用线程：AsyncLoop 用一个 WSAPoll 线程等待所有挂起的操作，
+// 就绪后交给少量执行线程恢复协程，上千个并发远程操作只需几个线程。
+// 建连握手（SSHManager 构造）仍是阻塞的，用 AsyncLoop::offload 放到阻塞线程池中执行。
+//
+// 需要 C++20 协程（CMake 选项 ADJUSTBIAS_CXX20=ON）；C++17 构建中本头文件为空，
+// ADJUSTBIAS_HAS_COROUTINES 未定义，调用方回退到原有的同步接口。
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define ADJUSTBIAS_HAS_COROUTINES 1
+
+#include <winsock2.h>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <libssh2.h>
+#include <libssh2_sftp.h>
+#include "Backoff.h"
+
+class SSHManager;
+
+// ===== 协程任务 =====
+// 惰性启动：被 co_await（或交给 AsyncLoop::spawn / run）时才开始执行，结束时恢复等待方；异常传递给等待方。
+template <typename T>
+class AsyncTask;
+
+struct AsyncPromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr error;
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            return h.promise().continuation;
+        }
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+template <typename T>
+class AsyncTask {
+public:
+    struct promise_type : AsyncPromiseBase {
+        std::optional<T> value;
+        AsyncTask get_return_object() { return AsyncTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        template <typename U>
+        void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+    };
+
+    AsyncTask() = default;
+    AsyncTask(AsyncTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    AsyncTask& operator=(AsyncTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~AsyncTask() { reset(); }
+
+    bool await_ready() const noexcept { return !handle || handle.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+    T await_resume() {
+        if (handle.promise().error) {
+            std::rethrow_exception(handle.promise().error);
+        }
+        return std::move(*handle.promise().value);
+    }
+
+private:
+    explicit AsyncTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+    void reset() {
+        if (handle) {
+            handle.destroy();
+            handle = nullptr;
+        }
+    }
+    std::coroutine_handle<promise_type> handle;
+};
+
+template <>
+class AsyncTask<void> {
+public:
+    struct promise_type : AsyncPromiseBase {
+        AsyncTask get_return_object() { return AsyncTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        void return_void() noexcept {}
+    };
+
+    AsyncTask() = default;
+    AsyncTask(AsyncTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    AsyncTask& operator=(AsyncTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~AsyncTask() { reset(); }
+
+    bool await_ready() const noexcept { return !handle || handle.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+    void await_resume() {
+        if (handle.promise().error) {
+            std::rethrow_exception(handle.promise().error);
+        }
+    }
+
+private:
+    explicit AsyncTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+    void reset() {
+        if (handle) {
+            handle.destroy();
+            handle = nullptr;
+        }
+    }
+    std::coroutine_handle<promise_type> handle;
+};
+
+// ===== 调度器 =====
+// 一个 WSAPoll 线程等待 socket 与定时器，threads 个执行线程恢复就绪的协程，
+// blockingThreads 个线程执行 offload 的阻塞函数（建连、释放会话等）。
+class AsyncLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit AsyncLoop(int threads = 2, int blockingThreads = 8);
+    ~AsyncLoop();
+    AsyncLoop(const AsyncLoop&) = delete;
+    AsyncLoop& operator=(const AsyncLoop&) = delete;
+
+    // 在执行线程中启动任务（不等待）；任务内的异常被记录并丢弃，需要结果时由任务自行保存
+    void spawn(AsyncTask<void> task);
+
+    // 等待所有 spawn 的任务结束
+    void wait();
+
+    // 在执行线程中运行任务并阻塞等待其结果（不能在执行线程中调用）
+    template <typename T>
+    T run(AsyncTask<T> task);
+
+    // 把协程放回执行队列
+    void post(std::coroutine_handle<> handle);
+
+    // ===== 可等待对象 =====
+    struct SocketAwaiter {
+        AsyncLoop* loop;
+        SOCKET sock;
+        short events;
+        Clock::time_point deadline;
+        bool ready = false;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        bool await_resume() const noexcept { return ready; }
+    };
+
+    struct BlockingAwaiter {
+        AsyncLoop* loop;
+        std::function<void()> job;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept {}
+    };
+
+    // 等待 socket 可读 / 可写，超时返回 false（sock 为 INVALID_SOCKET 时即纯定时器）
+    SocketAwaiter waitSocket(SOCKET sock, bool read, bool write, Clock::time_point deadline);
+    SocketAwaiter sleepFor(std::chrono::milliseconds duration);
+    // 等待下一次退避时长（Backoff::next）
+    SocketAwaiter sleep(Backoff& backoff) { return sleepFor(backoff.next()); }
+
+    // 立即结束所有等待 sock 的操作（视为就绪）：同一会话上另一个操作读走了数据时唤醒其余等待方重试
+    void notifySocket(SOCKET sock);
+
+    // 在阻塞线程池中执行 fn，完成后回到执行线程；fn 的异常传递给等待方
+    template <typename F>
+    AsyncTask<std::invoke_result_t<F&>> offload(F fn);
+
+    struct Stats {
+        size_t threads = 0;             // 事件线程 + 执行线程 + 阻塞线程
+        size_t pending = 0;             // 正在等待 socket / 定时器的操作
+        uint64_t resumed = 0;           // 累计恢复协程次数
+        size_t peakPending = 0;
+    };
+    Stats stats() const;
+
+private:
+    struct Waiter {
+        SOCKET sock;
+        short events;
+        Clock::time_point deadline;
+        bool* ready;
+        std::coroutine_handle<> handle;
+    };
+
+    // spawn 的外层协程：结束时自行销毁（final_suspend 不挂起）
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() { return Detached{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept {}
+        };
+        std::coroutine_handle<promise_type> handle;
+    };
+    static Detached detach(AsyncLoop* loop, AsyncTask<void> task);
+    void pollLoop();
+    void workerLoop();
+    void blockingLoop();
+    void wake();
+
+    mutable std::mutex mutex;
+    std::condition_variable readyCV;
+    std::condition_variable blockingCV;
+    std::condition_variable idleCV;
+    std::deque<std::coroutine_handle<>> readyQueue;
+    std::deque<std::function<void()>> blockingQueue;
+    std::vector<Waiter> waiters;
+    size_t outstanding = 0;                 // spawn 后尚未结束的任务数
+    size_t peakWaiters = 0;
+    uint64_t resumedCount = 0;
+    bool stopping = false;
+
+    SOCKET wakeSocket = INVALID_SOCKET;
+    std::thread pollThread;
+    std::vector<std::thread> workers;
+    std::vector<std::thread> blockingWorkers;
+};
+
+template <typename T>
+T AsyncLoop::run(AsyncTask<T> task) {
+    std::mutex doneMutex;
+    std::condition_variable doneCV;
+    bool done = false;
+    std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> value;
+    std::exception_ptr error;
+
+    auto wrapper = [&]() -> AsyncTask<void> {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(task);
+                value.emplace(true);
+            } else {
+                value.emplace(co_await std::move(task));
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(doneMutex);
+        done = true;
+        doneCV.notify_all();
+    };
+    spawn(wrapper());
+
+    // 只等本任务结束；外层协程收尾（销毁帧、计数）不再访问这里的局部变量
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCV.wait(lock, [&]() { return done; });
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        return std::move(*value);
+    }
+}
+
+template <typename F>
+AsyncTask<std::invoke_result_t<F&>> AsyncLoop::offload(F fn) {
+    using R = std::invoke_result_t<F&>;
+    std::exception_ptr error;
+    if constexpr (std::is_void_v<R>) {
+        co_await BlockingAwaiter{this, [&]() {
+            try {
+                fn();
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }};
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    } else {
+        std::optional<R> value;
+        co_await BlockingAwaiter{this, [&]() {
+            try {
+                value.emplace(fn());
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }};
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        co_return std::move(*value);
+    }
+}
+
+// ===== 会话上的远程操作 =====
+// 每一步 libssh2 调用都在会话锁内以非阻塞模式执行（随后恢复原来的阻塞模式），返回 EAGAIN 时释放锁并
+// 挂起等待 socket，因此与同一会话上的其他使用方（界面、遥测线程、SessionReactor 保活）可以共存。
+// 同一个 AsyncSession 上可以同时进行多个操作：libssh2 每个会话只保存一个进行中的非阻塞通道打开、
+// 每个 SFTP 句柄只保存一个进行中的 sftp_open，这两步按令牌逐个进行，其余步骤可以交错。
+class AsyncSession {
+public:
+    struct ExecResult {
+        int exitCode = -1;
+        std::string output;             // stdout
+        std::string error;              // stderr
+    };
+
+    AsyncSession(AsyncLoop& loop, SSHManager& ssh);
+    ~AsyncSession();
+    AsyncSession(const AsyncSession&) = delete;
+    AsyncSession& operator=(const AsyncSession&) = delete;
+
+    // 在一个 exec 通道中执行命令，input 写入 stdin 后关闭；超时抛出 RemoteCommandException。
+    // 非 0 退出码不抛出异常，由调用方检查 exitCode
+    AsyncTask<ExecResult> exec(std::string command, std::string input = std::string(), int timeoutMs = 10000);
+
+    // 通过 SFTP 读取整个远端文件（SFTP 子系统在第一次调用时启动）；失败抛出 RemoteCommandException
+    AsyncTask<std::string> readFile(std::string path, int timeoutMs = 10000);
+
+    SSHManager& manager() { return ssh; }
+
+private:
+    // 在会话锁内以非阻塞模式重复调用 step，直到它不再返回 LIBSSH2_ERROR_EAGAIN；
+    // 返回负的 libssh2 错误码时抛出 RemoteCommandException（what 为 context + libssh2 错误信息）
+    AsyncTask<long long> call(std::function<long long(LIBSSH2_SESSION*)> step, AsyncLoop::Clock::time_point deadline,
+                              std::string context);
+
+    // 与 call 相同，但同一时刻只允许一个操作执行 step：token 被其他操作占用时视为 EAGAIN 等待，
+    // step 完成或失败后释放。用于通道打开、sftp_open 这类状态保存在会话 / SFTP 句柄中、不能交错的调用
+    AsyncTask<long long> exclusive(const void*& token, std::function<long long(LIBSSH2_SESSION*)> step,
+                                   AsyncLoop::Clock::time_point deadline, std::string context);
+
+    AsyncLoop& loop;
+    SSHManager& ssh;
+    LIBSSH2_SFTP* sftp = nullptr;
+    LIBSSH2_SESSION* sftpSession = nullptr;  // sftp 所属会话，会话重建后重新启动
+    const void* sftpStarter = nullptr;       // 正在启动 SFTP 的操作，其余操作等待它完成
+    const void* channelOpener = nullptr;     // 正在打开通道的操作
+    const void* fileOpener = nullptr;        // 正在执行 sftp_open 的操作
+};
+
+// ===== 配置文件的协程版本 =====
+// 与 ConfigReader::loadConfig / writeMultipleParametersToFile 相同的文件格式与写入方式（临时文件 + mv），
+// 写成直线协程，不修改任何 ConfigReader 实例。
+class AsyncConfig {
+public:
+    struct WriteResult {
+        std::string baseline;           // 修改前的文件内容（用于回滚）
+        std::string content;            // 写入的内容
+    };
+
+    // 读取并解析配置文件，返回全部数值参数（同名参数以最后一次出现为准）
+    static AsyncTask<std::map<std::string, double>> load(AsyncSession& session, std::string path,
+                                                          int timeoutMs = 10000);
+
+    // 读取 -> ConfigReader::applyParameterEdits -> 写临时文件并 mv；失败抛出异常
+    static AsyncTask<WriteResult> writeParameters(AsyncSession& session, std::string path,
+                                                  std::vector<std::pair<std::string, double>> params,
+                                                  int timeoutMs = 10000);
+};
+
+#endif
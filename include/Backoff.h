@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+
+// ===== 带抖动的指数退避 =====
+// 第 n 次重试前等待 min(initial * multiplier^n, max)，再在 [delay * (1 - jitter), delay] 之间随机取值，
+// 避免多个客户端（或多个重试循环）在链路恢复的瞬间同时重连。
+class Backoff {
+public:
+    struct Policy {
+        std::chrono::milliseconds initial{200};
+        std::chrono::milliseconds max{5000};
+        double multiplier = 2.0;
+        double jitter = 0.5; // 0 表示不抖动，1 表示在 [0, delay] 之间均匀取值（full jitter）
+    };
+
+    Backoff() : Backoff(Policy()) {}
+    explicit Backoff(const Policy& policy)
+        : policy(policy), rng(std::random_device{}()) {}
+
+    // 计算下一次等待时长并推进重试计数
+    std::chrono::milliseconds next() {
+        double delay = static_cast<double>(policy.initial.count());
+        for (int i = 0; i < attempt && delay < policy.max.count(); ++i) {
+            delay *= policy.multiplier;
+        }
+        delay = std::min(delay, static_cast<double>(policy.max.count()));
+        ++attempt;
+
+        const double jitter = std::clamp(policy.jitter, 0.0, 1.0);
+        std::uniform_real_distribution<double> dist(delay * (1.0 - jitter), delay);
+        return std::chrono::milliseconds(static_cast<long long>(dist(rng)));
+    }
+
+    // 等待下一次退避时长；cancel 置位时提前返回 false
+    bool sleep(const std::atomic<bool>* cancel = nullptr) { return sleepFor(next(), cancel); }
+
+    // 等待指定时长，每 50 毫秒检查一次 cancel；cancel 置位时提前返回 false
+    static bool sleepFor(std::chrono::milliseconds duration, const std::atomic<bool>* cancel = nullptr) {
+        const auto deadline = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (cancel && cancel->load()) {
+                return false;
+            }
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            std::this_thread::sleep_for(std::min(remaining, std::chrono::milliseconds(50)));
+        }
+        return true;
+    }
+
+    void reset() { attempt = 0; }
+    int attempts() const { return attempt; }
+
+private:
+    Policy policy;
+    std::mt19937 rng;
+    int attempt = 0;
+};
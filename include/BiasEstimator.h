@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+class DriftLogStore;
+
+// ===== 漂移日志 =====
+// 从机器人拉取的 CSV 记录，列式存储（每个字段一个连续数组），便于批量求和。
+// 必须有表头，列名（不区分大小写）：
+//   vx / vy / wz                    实测机体速度（必需，别名同遥测：x_vel、yaw_rate 等）
+//   cmd_vx / cmd_vy / cmd_wz        指令速度（可选，缺省视为 0）
+//   gait                            步态（可选）：0 / walk 为走，1 / run 为跑；缺省全部视为走
+// 其余列（时间戳等）忽略。
+struct DriftLog {
+    std::vector<double> vx, vy, wz;
+    std::vector<double> cmdVx, cmdVy, cmdWz;   // 没有指令列时为空
+    std::vector<uint8_t> run;                  // 没有步态列时为空
+    size_t malformedLines = 0;
+
+    size_t size() const { return vx.size(); }
+    bool hasCommand() const { return !cmdVx.empty(); }
+    bool hasGait() const { return !run.empty(); }
+
+    // 解析 CSV 文本，缺少表头或必需列时抛出 ConfigException
+    static DriftLog parse(const char* data, size_t len);
+    static DriftLog loadFile(const std::string& path);
+
+    // 从列式分析文件取出所需通道（列名规则同上），值为 NaN 的行计入 malformedLines
+    static DriftLog fromStore(const DriftLogStore& store);
+};
+
+// ===== 偏置估计 =====
+// 对每个轴、每种步态拟合  实测速度 = drift + gain * 指令速度（最小二乘），
+// drift 即指令为零时机器人的漂移速度。假设控制器把 *_vel_offset 叠加到指令速度上，
+// 建议值 = 当前值 - drift。没有指令列时退化为实测速度的均值。
+//
+// 置信区间用批均值法（batch means）：把样本按时间顺序分成若干批分别求解，
+// 以批间离散度估计标准误。1kHz 日志中相邻样本高度相关，直接用残差方差会严重低估区间宽度。
+//
+// 求解只需一次遍历累加各批的矩（n、Σx、Σy、Σxx、Σxy），内层循环在连续数组上以 4 路独立累加，
+// 百万样本的求解耗时在毫秒级，整体耗时主要在 CSV 解析。
+class BiasEstimator {
+public:
+    struct Options {
+        size_t batches = 20;            // 批数（置信区间的自由度 = batches - 1）
+        size_t minSamplesPerBatch = 50; // 每批少于该样本数时不给出建议值
+    };
+
+    struct Estimate {
+        std::string param;          // 配置参数名，例如 x_vel_offset / yaw_vel_offset_run
+        double current = 0.0;       // 当前配置值
+        double drift = 0.0;         // 拟合得到的零指令漂移
+        double gain = 0.0;          // 指令速度的跟踪增益（没有指令列时为 0）
+        double proposed = 0.0;      // 建议值 = current - drift
+        double ci95 = 0.0;          // drift（即建议值）的 95% 置信区间半宽
+        size_t samples = 0;
+        bool valid = false;         // 样本不足时为 false，note 说明原因
+        std::string note;
+    };
+
+    struct Result {
+        std::vector<Estimate> estimates;   // 顺序：x / y / yaw 的走，然后是跑
+        size_t samples = 0;
+        double solveMs = 0.0;
+    };
+
+    // current 为当前配置值（参数名 -> 值），缺少的参数按 0 处理
+    static Result estimate(const DriftLog& log, const std::map<std::string, double>& current);
+    static Result estimate(const DriftLog& log, const std::map<std::string, double>& current, const Options& options);
+};
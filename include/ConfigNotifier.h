@@ -0,0 +1,86 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+// ===== 配置热更新通知 =====
+// 参数文件原子替换（mv）成功后，通知机器人上的控制器重新读取 rl_control_new.txt，
+// 不必拍急停重启。通知通过远端命令发出，三种方式对应控制器常见的 IPC 入口：
+//   signal:<pid 文件>[:<信号名>],ack=<ack 文件>   kill -<信号>（默认 HUP）pid 文件中的进程
+//   fifo:<FIFO 路径>,ack=<ack 文件>               向 FIFO 写入一行 "reload <配置路径>"（无读端时 1 秒超时）
+//   udp:<端口>[:<主机>],ack=<ack 文件>             向本机（默认 127.0.0.1）UDP 端口发送一行 "reload <配置路径>"
+// 发出通知本身不能说明控制器已生效（UDP 总是“发送成功”，没有处理函数的进程收到 HUP 会直接退出），
+// 因此 ack 文件是必填项：控制器每次重新加载后原子写入一行 "<重新加载次数> <配置文件 sha256>"。
+// 只有 ack 文件在超时前出现新的次数且 sha256 与刚写入的配置一致，才算热更新成功。
+// 控制器未实现热更新时不配置通知器即可，保存流程与原来相同。
+class IConfigNotifier {
+public:
+    // 执行远端命令并返回 stdout（由 ConfigReader::executeRemoteCommand 提供，可走常驻代理）
+    using CommandRunner = std::function<std::string(const std::string& command)>;
+
+    // 等待控制器确认的时限
+    static constexpr int kAckTimeoutMs = 3000;
+
+    explicit IConfigNotifier(const std::string& ackFile) : ackFile(ackFile) {}
+    virtual ~IConfigNotifier() = default;
+
+    // 通知控制器 configPath 已更新并等待 ack；控制器确认后返回 true，失败或未确认时 error 说明原因
+    bool notify(const CommandRunner& run, const std::string& configPath, std::string& error);
+
+    // 用于日志与界面提示，例如 "signal:/run/rl_control.pid:HUP,ack=/run/rl_control.ack"
+    std::string describe() const;
+
+    // 按上面的格式解析，格式错误或缺少 ack 文件返回 nullptr
+    static std::unique_ptr<IConfigNotifier> fromSpec(const std::string& spec);
+
+    // 读取环境变量 ADJUSTBIAS_CONFIG_NOTIFY，未设置或格式错误返回 nullptr
+    static std::unique_ptr<IConfigNotifier> fromEnvironment();
+
+protected:
+    // 发出通知的远端 shell 命令，退出码非 0 表示没能发出
+    virtual std::string notifyCommand(const std::string& configPath) const = 0;
+    // 通知方式本身的描述，例如 "signal:/run/rl_control.pid:HUP"
+    virtual std::string channel() const = 0;
+
+private:
+    std::string ackFile;
+};
+
+class SignalConfigNotifier : public IConfigNotifier {
+public:
+    SignalConfigNotifier(const std::string& pidFile, const std::string& ackFile, const std::string& signal = "HUP");
+
+protected:
+    std::string notifyCommand(const std::string& configPath) const override;
+    std::string channel() const override;
+
+private:
+    std::string pidFile;
+    std::string signal;
+};
+
+class FifoConfigNotifier : public IConfigNotifier {
+public:
+    FifoConfigNotifier(const std::string& fifoPath, const std::string& ackFile);
+
+protected:
+    std::string notifyCommand(const std::string& configPath) const override;
+    std::string channel() const override;
+
+private:
+    std::string fifoPath;
+};
+
+class UdpConfigNotifier : public IConfigNotifier {
+public:
+    UdpConfigNotifier(int port, const std::string& ackFile, const std::string& host = "127.0.0.1");
+
+protected:
+    std::string notifyCommand(const std::string& configPath) const override;
+    std::string channel() const override;
+
+private:
+    int port;
+    std::string host;
+};
@@ -16,6 +16,7 @@
 #include <thread>
 #include <chrono>
 #include <limits>
+#include <functional>
 #include "Exceptions.h"
 
 #pragma comment(lib, "ws2_32.lib")
@@ -26,6 +27,7 @@ using SSHException = ApplicationException;
 
 #include "SSHManager.h"
 #include "RemoteCommandExecutor.h"
+#include "ConfigNotifier.h"
 
 class ConfigReader {
 private:
@@ -37,9 +39,20 @@ private:
     void initializeParameterMap();
     
     bool validateConfigFile(const std::string& filePath);
+
+    // loadConfig 首次执行时清理一次残留的 <configPath>.tmp.* 文件
+    bool tempFilesCleaned = false;
+
+    // 远端写入时每次写入通道 stdin 的块大小（内存占用与文件大小无关）
+    static constexpr size_t kRemoteWriteChunkSize = 32 * 1024;
+    // 原子写入的公共流程：produce 负责把内容写入远端 `cat > tmp` 的 stdin
+    bool atomicWriteRemoteImpl(const std::function<void(RemoteCommandExecutor&)>& produce);
     void setParameterValue(const std::string& varName, double value);
-    // 原子写远端配置文件（写入临时文件并mv替换）
-    bool atomicWriteRemoteFile(const std::string& content);
+
+    // 热更新通知（可选）：参数写回成功后通知控制器重新读取配置
+    std::shared_ptr<IConfigNotifier> notifier;
+    bool liveUpdated = false;
+    void notifyConfigChanged();
 
 public:
     // 配置参数
@@ -67,12 +80,33 @@ public:
     
     // 已解析的参数集合
     std::set<std::string> parsedParams;
+
+    // 最近一次 parseConfigContent 解析出的全部数值参数（含 parameterMap 之外的参数，如各关节增益）
+    std::map<std::string, double> parsedValues;
+
+    // 最近一次 writeMultipleParametersToFile 修改前读取到的原始文件内容（用于批量发布失败时回滚）
+    std::string lastWriteBaseline;
+    // 最近一次 writeMultipleParametersToFile 成功写入的内容（保存后校验 / 存档直接使用，无需再读一次远端文件）
+    std::string lastWrittenContent;
     
     ConfigReader(SSHManager* manager, const std::string& configPath);
     
     // 执行远程命令并返回输出（带重试机制）
     std::string executeRemoteCommand(const std::string& command, int maxRetries = 3);
     
+    // 原子写远端配置文件（流式写入临时文件并mv替换），末尾规范为单个换行
+    bool atomicWriteRemoteFile(const std::string& content);
+
+    // 原子写远端配置文件，内容从 in 分块读取并原样写入，适用于任意大小的文件
+    bool atomicWriteRemoteStream(std::istream& in);
+
+    // 设置热更新通知器（nullptr 关闭），见 ConfigNotifier.h
+    void setNotifier(std::shared_ptr<IConfigNotifier> configNotifier);
+    bool hasNotifier() const { return notifier != nullptr; }
+
+    // 最近一次参数写回后是否已成功通知控制器（无需重启即可生效）
+    bool wasLiveUpdated() const { return liveUpdated; }
+
     // 创建默认配置文件
     bool createDefaultConfig();
     
@@ -88,6 +122,11 @@ public:
     
     // 批量写入多个参数到配置文件（优化性能）
     bool writeMultipleParametersToFile(const std::vector<std::pair<std::string, double>>& params);
+
+    // 把参数修改应用到配置文件内容（不访问远端）：已有的行就地更新，不存在的追加到末尾，
+    // x_vel_limit_walk / x_vel_limit_run 为 NaN 时删除该行；返回的每一行都以换行结尾
+    static std::string applyParameterEdits(const std::string& content,
+                                           const std::vector<std::pair<std::string, double>>& params);
     
     // 加载配置文件
     bool loadConfig();
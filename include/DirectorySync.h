@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "SSHManager.h"
+
+// ===== 目录同步 =====
+// 把本地参数目录同步到机器人（例如 /home/ubuntu/data/param/）：
+// 1. 一条远端 find 命令列出所有文件的大小和修改时间（checksum 模式下额外列出 sha256sum）
+// 2. 与本地目录比对，只传输新增/变化的文件；上传时保留本地修改时间，下次同步可以直接按 大小+mtime 跳过
+// 3. 在同一个会话上同时打开多个 SCP 通道，由单线程非阻塞轮询推进（libssh2 会话不是线程安全的）
+// 4. 远端多余的文件用一条 rm 命令批量删除
+class DirectorySync {
+public:
+    // 进度回调：已传输字节数 / 需要传输的总字节数，返回 false 取消同步
+    using ProgressCallback = std::function<bool(uint64_t sent, uint64_t total)>;
+
+    struct Options {
+        int parallelChannels = 4;         // 同时进行的 SCP 通道数
+        size_t bufferSize = 256 * 1024;   // 每个通道的读写缓冲区
+        bool checksum = false;            // 大小相同的文件再比对 sha256（类似 rsync -c），否则比对 mtime
+        bool deleteStale = true;          // 删除远端存在而本地没有的文件
+        bool dryRun = false;              // 只计算差异，不做任何修改
+        int mode = 0644;                  // 上传文件的权限
+        int stallTimeoutMs = 30000;       // 所有通道连续这么久没有进展则中止
+        ProgressCallback progress;
+    };
+
+    struct Report {
+        size_t filesScanned = 0;
+        size_t filesUploaded = 0;
+        size_t filesSkipped = 0;
+        size_t filesDeleted = 0;
+        uint64_t bytesUploaded = 0;
+        double seconds = 0.0;             // 整个同步耗时（含列表与删除）
+        double transferSeconds = 0.0;     // 传输阶段耗时
+        std::vector<std::string> uploaded;
+        std::vector<std::string> deleted;
+        std::vector<std::pair<std::string, std::string>> failures; // 相对路径 -> 错误信息
+
+        // 传输阶段的聚合吞吐量（MB/s）
+        double throughputMBps() const {
+            return transferSeconds > 0.0 ? bytesUploaded / transferSeconds / (1024.0 * 1024.0) : 0.0;
+        }
+        bool ok() const { return failures.empty(); }
+    };
+
+    explicit DirectorySync(SSHManager* manager);
+
+    // 同步 localDir 到 remoteDir（远端目录不存在时自动创建）
+    // 会话级错误抛出 SSHException，取消抛出 OperationCancelledException；单个文件失败记录在 Report::failures
+    Report sync(const std::string& localDir, const std::string& remoteDir, const Options& options);
+
+private:
+    struct FileInfo {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        std::string sha256;
+        std::filesystem::path localPath;
+    };
+    using FileMap = std::map<std::string, FileInfo>; // 相对路径（'/' 分隔）-> 文件信息
+
+    FileMap scanLocal(const std::string& localDir) const;
+    FileMap listRemote(const std::string& remoteDir, bool withChecksum);
+    // 把参数拼接成尽量少的远端命令执行（按命令长度分批），任一批失败抛出 RemoteCommandException
+    void runBatched(const std::string& prefix, const std::vector<std::string>& args);
+    void transfer(const std::vector<std::pair<std::string, FileInfo>>& files, const std::string& remoteDir,
+                  const Options& options, Report& report);
+
+    // 执行远端命令，stdout 写入 output，返回退出码
+    int runRemote(const std::string& command, std::string& output);
+
+    SSHManager* sshManager;
+};
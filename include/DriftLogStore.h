@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+// ===== 漂移日志分析文件 =====
+// 从机器人拉取的日志动辄上 GB，每次分析都重新解析文本太慢。这里把 CSV / 空白分隔的文本日志一次性转换为
+// 列式二进制文件（默认扩展名 .abcol），之后以只读内存映射打开，查询直接在列数组上向量化扫描，不再解析文本。
+//
+// 文件布局（小端，所有数组按 64 字节对齐）：
+//   FileHeader | ChannelEntry × channelCount | 时间索引 double[capacity] | 各通道 float[capacity] ...
+// 时间索引来自 t / time / timestamp / stamp 列，没有时间列时为行号；
+// 时间单调不减时按时间范围查询用二分查找定位行区间。
+// 其余每个表头列都是一个 float 通道；gait / mode 列的 walk / run 存为 0 / 1，其他非数字字段存为 NaN（查询时跳过）。
+class DriftLogStore {
+public:
+    static constexpr const char* kExtension = ".abcol";
+
+    struct ConvertStats {
+        size_t rows = 0;
+        size_t channels = 0;
+        size_t malformedLines = 0;   // 字段数少于表头的行（被跳过）
+        double seconds = 0.0;
+    };
+
+    // 过滤条件：channel <op> value；AbsLt / AbsLe 比较绝对值（例如“指令为零”写作 |cmd_wz|<=1e-6）
+    struct Condition {
+        enum Op { Eq, Ne, Lt, Le, Gt, Ge, AbsLt, AbsLe };
+        std::string channel;
+        Op op = Eq;
+        double value = 0.0;
+    };
+
+    struct Stats {
+        size_t count = 0;       // 满足条件且值不是 NaN 的样本数
+        double mean = 0.0;
+        double stddev = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+    };
+
+    // 扫描实现；AVX2 在运行时检测，不支持时回退到标量实现
+    enum class Impl { Scalar, AVX2 };
+    static Impl activeImpl();
+    static bool isSupported(Impl impl);
+    static const char* implName(Impl impl);
+
+    DriftLogStore() = default;
+
+    // 把文本日志转换为分析文件；没有表头时通道命名为 c0、c1 ...
+    static ConvertStats convert(const std::string& textPath, const std::string& storePath);
+
+    // 打开分析文件，格式或版本不符时抛出 ConfigException
+    static DriftLogStore open(const std::string& storePath);
+
+    // 打开 path：本身是分析文件则直接打开；否则使用旁边的 <path>.abcol 缓存，缓存不存在或比日志旧时重新转换
+    static DriftLogStore openOrConvert(const std::string& path);
+
+    size_t rows() const { return rowCount; }
+    size_t malformedLines() const { return malformed; }
+    const std::vector<std::string>& channels() const { return names; }
+    bool hasTime() const { return timeColumn; }
+    bool timeSorted() const { return sorted; }
+
+    // 通道数组（长度 rows()），不存在时返回 nullptr
+    const float* channel(const std::string& name) const;
+    const double* time() const { return timeIndex; }
+
+    // channel 在时间范围 [tFrom, tTo] 内、满足全部 where 条件的样本统计；通道不存在时抛出 ConfigException
+    Stats stats(const std::string& channel, const std::vector<Condition>& where = {},
+                double tFrom = -std::numeric_limits<double>::infinity(),
+                double tTo = std::numeric_limits<double>::infinity()) const;
+    Stats statsWith(Impl impl, const std::string& channel, const std::vector<Condition>& where,
+                    double tFrom, double tTo) const;
+
+    // 解析命令行形式的条件：name=v、name!=v、name<v、name<=v、name>v、name>=v、|name|<v、|name|<=v；
+    // v 可以是 walk / run
+    static bool parseCondition(const std::string& text, Condition& condition);
+
+private:
+    MappedFile file;
+    std::vector<std::string> names;
+    std::vector<const float*> columns;
+    const double* timeIndex = nullptr;
+    size_t rowCount = 0;
+    size_t malformed = 0;
+    bool timeColumn = false;
+    bool sorted = false;
+};
@@ -64,3 +64,11 @@ public:
     explicit ResourceException(const std::string& message) 
         : ApplicationException(message) {}
 };
+
+// ===== Operation Cancelled Exception =====
+// 用户通过进度回调或 Ctrl+C 主动取消长时间操作（上传、同步等）
+class OperationCancelledException : public ApplicationException {
+public:
+    explicit OperationCancelledException(const std::string& message) 
+        : ApplicationException(message) {}
+};
@@ -6,6 +6,7 @@
 #include <vector>
 #include <set>
 #include <libssh2.h>
+#include <libssh2_sftp.h>
 #include <ws2tcpip.h>
 #include <winsock2.h>
 #include <atomic>
@@ -14,6 +15,8 @@
 #include <stdexcept>
 #include <thread>
 #include <chrono>
+#include <cstdint>
+#include <functional>
 #include "Exceptions.h"
 
 #pragma comment(lib, "ws2_32.lib")
@@ -25,17 +28,112 @@ using SSHException = ApplicationException;
 using namespace std;
 
 #include "SSHManager.h"
+#include "DirectorySync.h"
 
 class FileHandler {
+public:
+    // 上传进度回调：sent / total 为已确认写入通道的字节数和文件总大小，返回 false 取消上传
+    using ProgressCallback = function<bool(uint64_t sent, uint64_t total)>;
+
+    struct UploadOptions {
+        size_t bufferSize = 256 * 1024;  // 每次从磁盘读取并写入通道的块大小
+        int mode = 0700;                 // 远端文件权限
+        bool verifyChecksum = false;     // 上传后在远端执行 sha256sum 并与本地摘要比对
+        int stallTimeoutMs = 30000;      // 连续这么久没有任何字节写出则视为链路中断
+        ProgressCallback progress;       // 可为空
+    };
+
+    struct UploadResult {
+        uint64_t bytes = 0;
+        double seconds = 0.0;
+        string sha256;                   // 本地摘要（上传时边读边算）
+        bool verified = false;           // 远端摘要比对通过
+    };
+
+    struct DownloadOptions {
+        size_t bufferSize = 1024 * 1024; // 单次 sftp_read 的缓冲区；libssh2 会据此同时发出多个读请求（read-ahead）
+        bool resume = true;              // 存在 <localPath>.part 且远端文件未变化（大小与修改时间同 .part.meta）时续传
+        int stallTimeoutMs = 30000;      // 单次读取超过这么久没有数据则视为链路中断
+        ProgressCallback progress;       // sent 为已落盘字节数（含续传前已有部分）
+    };
+
+    struct DownloadResult {
+        uint64_t fileSize = 0;
+        uint64_t resumedFrom = 0;        // 续传起点，0 表示从头下载
+        uint64_t bytes = 0;              // 本次实际传输的字节数
+        double seconds = 0.0;
+    };
+
+    struct DirectoryDownloadReport {
+        size_t files = 0;
+        uint64_t bytes = 0;
+        double seconds = 0.0;
+        vector<pair<string, string>> failures; // 远端相对路径 -> 错误信息
+
+        double throughputMBps() const { return seconds > 0.0 ? bytes / seconds / (1024.0 * 1024.0) : 0.0; }
+    };
+
 private:
     SSHManager* sshManager;
 
+    // SFTP 子系统按会话缓存，SSHManager 重连后会话指针变化时重新初始化
+    LIBSSH2_SFTP* sftp = nullptr;
+    LIBSSH2_SESSION* sftpSession = nullptr;
+    LIBSSH2_SFTP* getSftp();
+    string sftpError(const string& what);
+
+    // 在会话锁内以阻塞模式执行一次 SFTP 调用。遥测 / 实时调节 / 保存线程共用同一会话，
+    // 每次调用 libssh2 都要持锁，但只按单次调用（一块数据）持有，下载期间其他线程照常工作
+    template <typename F>
+    auto withSession(F&& fn) -> decltype(fn()) {
+        auto sessionLock = sshManager->lockSession();
+        libssh2_session_set_blocking(sftpSession, 1);
+        return fn();
+    }
+
 public:
     FileHandler(SSHManager* manager);
+    ~FileHandler();
+
+    FileHandler(const FileHandler&) = delete;
+    FileHandler& operator=(const FileHandler&) = delete;
+
+    // 为远端 shell 命令加单引号转义，路径中的空格和特殊字符不会被 shell 解释
+    static string shellQuote(const string& value);
 
     // 上传文件到远程服务器
     void uploadFile(const string& localPath, const string& remotePath);
 
+    // 上传文件到远程服务器（大缓冲区 + 非阻塞写入，支持进度、取消和远端校验）
+    // 取消时抛出 OperationCancelledException，校验失败抛出 RemoteCommandException
+    UploadResult uploadFile(const string& localPath, const string& remotePath, const UploadOptions& options);
+
+    // 把本地目录同步到远端（只传输变化的文件，多通道并发，批量删除多余文件），见 DirectorySync
+    DirectorySync::Report syncDirectory(const string& localDir, const string& remoteDir,
+                                        const DirectorySync::Options& options = DirectorySync::Options());
+
+    // ===== SFTP 下载 =====
+    // 数据直接写入 <localPath>.part，完成后重命名为 localPath，内存占用只有一个缓冲区。
+    // 中断后再次调用会从 .part 的长度处续传（远端文件变小时从头开始）。
+    DownloadResult downloadFile(const string& remotePath, const string& localPath);
+    DownloadResult downloadFile(const string& remotePath, const string& localPath, const DownloadOptions& options);
+
+    // 递归下载远端目录；单个文件失败记录在 failures 中，不影响其它文件
+    DirectoryDownloadReport downloadDirectory(const string& remoteDir, const string& localDir);
+    DirectoryDownloadReport downloadDirectory(const string& remoteDir, const string& localDir,
+                                              const DownloadOptions& options);
+
     // 删除远程文件（带重连机制）
     void removeRemoteFile(const string& remotePath, int maxRetries = 2);
+
+    // 批量删除远程文件：所有路径拼成尽量少的 `rm -f` 命令（按命令长度分批），失败时按带抖动的指数退避重试。
+    // allowGlob 为 true 时路径中的 * ? [...] 由远端 shell 展开，其余字符按字面处理。返回实际删除的文件数
+    size_t removeRemoteFiles(const vector<string>& paths, bool allowGlob = true, int maxRetries = 3);
+
+    // 清理 atomicWriteRemoteFile 异常中断后残留的 <targetPath>.tmp.* 文件。
+    // 只删除修改时间早于 minAgeMinutes 的文件，避免误删其它客户端正在写入的临时文件。返回删除的文件数
+    size_t cleanupOrphanedTempFiles(const string& targetPath, int minAgeMinutes = 10);
+
+    // 为 shell glob 模式加引号：通配符保持原样，其余部分按字面引用
+    static string globQuote(const string& pattern);
 };
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ===== 机器人清单 =====
+// 文本文件，每行一台机器人，字段以空白或逗号分隔，# 之后为注释：
+//   <IP>[:端口] [用户名] [名称]
+//   192.168.1.6
+//   192.168.1.7:22 ubuntu dog-07
+// 用户名缺省为 ubuntu，名称缺省为 IP。
+struct FleetHost {
+    std::string name;
+    std::string host;
+    int port = 22;
+    std::string username = "ubuntu";
+};
+
+class SSHManager;
+
+class FleetInventory {
+public:
+    // 格式错误（端口不是数字等）抛出 ConfigException，错误信息中带行号
+    static std::vector<FleetHost> parse(const std::string& text);
+    static std::vector<FleetHost> loadFile(const std::string& path);
+};
+
+// ===== 批量只读审计 =====
+// 以有限并发同时连接清单中的所有机器人，每台只执行一次 `cat <配置文件>`（一个 exec 通道），
+// 用 ConfigReader::parseConfigContent 解析后汇总为 主机 × 参数 的矩阵。不写入任何文件。
+// 单台机器人的耗时约为 TCP 建连 + 握手认证 + 一次命令往返，离线主机在建连超时后失败，不拖慢其他主机。
+// engine = Coroutines（需 C++20 构建）时命令阶段由 AsyncLoop 多路复用，只有建连握手占用 jobs 个阻塞线程。
+class FleetAudit {
+public:
+    enum class Engine { Threads, Coroutines };
+
+    struct Options {
+        int jobs = 32;                  // 同时进行的连接数
+        Engine engine = Engine::Threads;
+        int connectTimeoutMs = 3000;    // TCP 建连超时
+        int commandTimeoutMs = 10000;   // cat 无输出的最长等待
+        std::string configPath = "/home/ubuntu/data/param/rl_control_new.txt";
+        std::string password;           // 为空时只尝试 ssh-agent / 私钥
+    };
+
+    struct HostResult {
+        FleetHost host;
+        bool ok = false;
+        std::string error;
+        std::string authMethod;
+        double elapsedMs = 0.0;
+        std::map<std::string, double> values;   // 文件中解析出的全部数值参数
+    };
+
+    using Progress = std::function<void(const HostResult& result, size_t done, size_t total)>;
+
+    // 结果顺序与 hosts 相同；progress 在工作线程中调用（已串行化）
+    // C++17 构建中 engine = Coroutines 抛出 ConfigException
+    static std::vector<HostResult> run(const std::vector<FleetHost>& hosts, const Options& options,
+                                       const Progress& progress = nullptr);
+
+    // params 为空时输出所有主机出现过的参数（按名称排序）
+    static std::vector<std::string> columns(const std::vector<HostResult>& results,
+                                            const std::vector<std::string>& params);
+    static void writeCsv(std::ostream& out, const std::vector<HostResult>& results,
+                         const std::vector<std::string>& params);
+    static void writeJson(std::ostream& out, const std::vector<HostResult>& results,
+                          const std::vector<std::string>& params);
+
+    // ===== 供其他批量操作复用（FleetDrift 等）=====
+    // 以 jobs 个工作线程领取 [0, count) 的下标并调用 task（task 自行处理异常）
+    static void forEachParallel(size_t count, int jobs, const std::function<void(size_t index)>& task);
+
+    // 按 options 的认证方式与建连超时连接一台机器人
+    static std::unique_ptr<SSHManager> connect(const FleetHost& host, const Options& options);
+
+    // 在一个 exec 通道中执行命令并返回 stdout；退出码非 0 或超时抛出 RemoteCommandException
+    static std::string execute(SSHManager& ssh, const std::string& command, int timeoutMs);
+
+    static std::string csvField(const std::string& s);
+    static std::string jsonString(const std::string& s);
+    static std::string formatValue(double value);
+};
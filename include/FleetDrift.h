@@ -0,0 +1,64 @@
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "FleetAudit.h"
+
+// ===== 参数合规检查（与标准模板比对）=====
+// 每台机器人只执行一条命令：远端先计算配置文件的 sha256，与标准模板的摘要一致时只返回一行 `MATCH <摘要>`；
+// 不一致时才在同一条命令中附带完整文件内容。日常巡检中绝大多数机器人只产生几十字节的流量和一次命令往返。
+//
+// 不一致时按 ConfigReader::parseConfigContent 的语义（同名参数以最后一次出现为准）解析两份内容，
+// 逐参数给出差异；摘要不同但参数完全一致（只有注释、空白、顺序或重复行不同）时记为 FormatOnly。
+class FleetDrift {
+public:
+    struct Golden {
+        std::string sha256;
+        std::map<std::string, double> values;
+
+        // 读取本地标准模板文件，无法打开时抛出 ConfigException。
+        // CRLF 换行先规范为 LF 再计算摘要和解析（机器人上的文件为 LF）
+        static Golden loadFile(const std::string& path);
+        static Golden fromContent(const std::string& content);
+    };
+
+    struct ParamDiff {
+        enum Kind { Changed, Missing, Extra };   // Missing：模板有而机器人没有；Extra：机器人多出的参数
+        std::string param;
+        Kind kind = Changed;
+        double golden = 0.0;
+        double actual = 0.0;
+    };
+
+    enum class Status { Match, FormatOnly, Drift, MissingFile, Error };
+
+    struct HostResult {
+        FleetHost host;
+        Status status = Status::Error;
+        std::string sha256;             // 远端文件摘要
+        std::vector<ParamDiff> diffs;
+        std::string error;
+        size_t bytesReceived = 0;       // 命令输出字节数（衡量巡检流量）
+        double elapsedMs = 0.0;
+    };
+
+    using Progress = std::function<void(const HostResult& result, size_t done, size_t total)>;
+
+    // 数值差的绝对值不超过 tolerance 时视为相同
+    static std::vector<ParamDiff> diff(const std::map<std::string, double>& golden,
+                                       const std::map<std::string, double>& actual, double tolerance = 0.0);
+
+    // options 与 FleetAudit 相同（并发数、超时、配置路径、密码）；结果顺序与 hosts 相同
+    static std::vector<HostResult> run(const std::vector<FleetHost>& hosts, const Golden& golden,
+                                       const FleetAudit::Options& options, double tolerance = 0.0,
+                                       const Progress& progress = nullptr);
+
+    static const char* statusName(Status status);
+    static const char* kindName(ParamDiff::Kind kind);
+
+    // CSV：每个差异一行（无差异的主机一行，param 为空）；JSON：每台主机一个对象，差异为数组
+    static void writeCsv(std::ostream& out, const std::vector<HostResult>& results);
+    static void writeJson(std::ostream& out, const std::vector<HostResult>& results);
+};
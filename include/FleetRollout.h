@@ -0,0 +1,89 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "FleetAudit.h"
+
+class IConfigNotifier;
+
+// ===== 分阶段发布（金丝雀 + 自动回滚）=====
+// 把一组参数修改按阶段推送到清单中的机器人：先写少量金丝雀，全部通过健康检查后再扩大范围。
+// 每台机器人的处理过程：
+//   1. ConfigReader::writeMultipleParametersToFile 读取原文件、修改并原子替换（mv），
+//      同时保留修改前的原始内容（ConfigReader::lastWriteBaseline）
+//   2. 配置了通知器时通知控制器重新加载
+//   3. 等待 settleMs 后在机器人上执行健康检查命令，退出码 0 视为健康
+// 任一阶段出现失败（写入失败、健康检查失败或超时）即停止发布：当前阶段尚未开始的主机不再处理，
+// 所有已写入的主机并发写回各自的原始内容（同样是临时文件 + mv 的原子替换）。
+//
+// 阶段以累计主机数描述，例如 "1,10%,100%"：第一阶段 1 台，第二阶段累计到 10%，最后覆盖全部。
+// 百分比向上取整；最后一个阶段不足全部主机时自动补一个覆盖全部的阶段。
+class FleetRollout {
+public:
+    struct Options {
+        FleetAudit::Options fleet;              // 并发数、超时、配置路径、密码（每个阶段内的并发数为 fleet.jobs）
+        std::string stages = "1,10%,100%";
+        std::string probeCommand;               // 为空时只检查写入是否成功
+        int probeTimeoutMs = 30000;             // 健康检查命令无输出的最长等待
+        int settleMs = 3000;                    // 写入（及通知）后等待多久再做健康检查
+        std::shared_ptr<IConfigNotifier> notifier;   // 为空时不通知控制器
+    };
+
+    enum class State {
+        NotStarted,     // 发布中止前未轮到
+        Applied,        // 已写入且健康检查通过
+        Failed,         // 写入或健康检查失败（已写入的会被回滚）
+        RolledBack,     // 已恢复原始内容
+        RollbackFailed  // 恢复原始内容失败，需要人工处理
+    };
+
+    struct HostResult {
+        FleetHost host;
+        State state = State::NotStarted;
+        int stage = -1;                 // 所属阶段（从 0 开始）
+        bool written = false;           // 写入是否报告成功（回滚不依赖它：回显丢失时文件可能已被替换）
+        std::string error;
+        std::string rollbackError;
+        double applyMs = 0.0;           // 建连 + 读取 + 写入
+        double probeMs = 0.0;           // 健康检查（不含 settleMs）
+        double elapsedMs = 0.0;
+    };
+
+    struct StageReport {
+        int index = 0;
+        size_t hosts = 0;               // 本阶段计划处理的主机数
+        size_t succeeded = 0;
+        size_t failed = 0;
+        double p50Ms = 0.0;             // 本阶段单台主机耗时的中位数 / 最大值
+        double maxMs = 0.0;
+        double durationMs = 0.0;
+    };
+
+    struct Report {
+        std::vector<HostResult> hosts;  // 顺序与输入清单相同
+        std::vector<StageReport> stages;
+        bool completed = false;         // 所有阶段均成功
+        size_t rolledBack = 0;
+        size_t rollbackFailed = 0;
+        double rollbackMs = 0.0;
+    };
+
+    using Progress = std::function<void(const HostResult& result, size_t done, size_t total)>;
+    using StageDone = std::function<void(const StageReport& stage)>;
+
+    // 返回每个阶段结束时的累计主机数（严格递增，最后一个等于 hostCount）；格式错误抛出 ConfigException
+    static std::vector<size_t> planStages(const std::string& spec, size_t hostCount);
+
+    // params 与 ConfigReader::writeMultipleParametersToFile 相同（x_vel_limit_* 为 NaN 表示删除该参数）
+    static Report run(const std::vector<FleetHost>& hosts, const std::vector<std::pair<std::string, double>>& params,
+                      const Options& options, const Progress& progress = nullptr, const StageDone& stageDone = nullptr);
+
+    static const char* stateName(State state);
+
+    static void writeCsv(std::ostream& out, const Report& report);
+    static void writeJson(std::ostream& out, const Report& report);
+};
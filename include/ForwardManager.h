@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SSHManager.h"
+
+// ===== SSH 端口转发 =====
+// 在已认证的会话上复用 direct-tcpip / tcpip-forward 通道，机器人上的遥测（IMU、里程计）
+// 和控制端口不需要在防火墙上额外开放，也不需要另建 TCP 连接：
+//   本地转发  addLocalForward：本机 127.0.0.1:<本地端口> 的每个连接 -> 机器人视角的 <主机>:<端口>
+//   远程转发  addRemoteForward：机器人上 <远端地址>:<端口> 的每个连接 -> 本机视角的 <主机>:<端口>
+//
+// 所有连接由一个泵线程以非阻塞方式驱动：select 等待本地 socket 与 SSH socket，
+// 每个方向一块固定缓冲区，recv 直接写入缓冲区、channel_write 直接从缓冲区读出，没有中间拷贝。
+// 打开 direct-tcpip 通道与关闭通道各需要一次往返，同样以非阻塞方式分多轮完成（EAGAIN 时下一轮继续），
+// 泵线程每轮持锁的时间不包含任何网络往返。
+//
+// libssh2 会话不是线程安全的：泵线程每一轮都持有 SSHManager::lockSession()，
+// 同一会话上的其它线程调用 libssh2 时也必须持有该锁（getSession、监控线程、ConfigReader 的远端命令与写入、
+// ParameterStreamer 均已如此）。
+class ForwardManager {
+public:
+    struct Stats {
+        uint64_t bytesToRemote = 0;      // 本地 socket -> 通道
+        uint64_t bytesFromRemote = 0;    // 通道 -> 本地 socket
+        uint64_t connections = 0;        // 累计建立的转发连接数
+        uint64_t activeConnections = 0;
+        uint64_t failedConnections = 0;  // 打开通道或连接本地目标失败的次数
+    };
+
+    explicit ForwardManager(SSHManager* manager);
+    ~ForwardManager();
+
+    ForwardManager(const ForwardManager&) = delete;
+    ForwardManager& operator=(const ForwardManager&) = delete;
+
+    // 添加本地转发，localPort 为 0 时由系统分配；返回实际监听的本地端口。失败抛出 NetworkException
+    int addLocalForward(const std::string& remoteHost, int remotePort, int localPort = 0,
+                        const std::string& bindAddress = "127.0.0.1");
+
+    // 添加远程转发，remotePort 为 0 时由 sshd 分配；返回机器人上实际监听的端口。
+    // sshd 拒绝（例如 AllowTcpForwarding no）时抛出 SSHSessionException
+    int addRemoteForward(int remotePort, const std::string& localHost, int localPort,
+                         const std::string& remoteBind = "127.0.0.1");
+
+    // 启动 / 停止泵线程。stop() 关闭所有连接并撤销全部转发
+    void start();
+    void stop();
+    bool isRunning() const { return running.load(); }
+
+    Stats getStats() const;
+
+private:
+    // 单方向缓冲区：[begin, end) 为已读入、尚未写出的数据
+    struct Buffer {
+        std::unique_ptr<char[]> data;
+        size_t begin = 0;
+        size_t end = 0;
+        size_t pending() const { return end - begin; }
+    };
+
+    struct Connection {
+        SOCKET sock = INVALID_SOCKET;
+        LIBSSH2_CHANNEL* channel = nullptr;
+        Buffer toChannel;    // 本地 socket -> 通道
+        Buffer toSocket;     // 通道 -> 本地 socket
+        bool socketEof = false;
+        bool channelEof = false;
+        bool eofSent = false;
+        bool socketShutdown = false;
+        bool failed = false;
+        bool closing = false;    // 本地 socket 已关闭，正在等待通道关闭完成
+        bool closeSent = false;  // libssh2_channel_close 已完成，只差 libssh2_channel_free
+    };
+
+    // 已 accept、正在打开 direct-tcpip 通道的本地连接。libssh2 同一时刻只能有一个进行中的通道打开，
+    // 按接受顺序逐个完成
+    struct PendingOpen {
+        SOCKET sock = INVALID_SOCKET;
+        std::string remoteHost;
+        int remotePort = 0;
+        int localPort = 0;
+    };
+
+    struct LocalForward {
+        SOCKET listenSock = INVALID_SOCKET;
+        std::string remoteHost;
+        int remotePort = 0;
+        int localPort = 0;
+    };
+
+    struct RemoteForward {
+        LIBSSH2_LISTENER* listener = nullptr;
+        int remotePort = 0;
+        std::string localHost;
+        int localPort = 0;
+    };
+
+    void pumpLoop();
+
+    // 不持有会话锁时等待本地 socket 或 SSH socket 可读，超时返回
+    void waitForActivity(int timeoutMs);
+
+    // 以下均在持有会话锁时调用，返回本轮是否有数据移动或新连接
+    bool acceptLocal();
+    bool openPending();
+    bool acceptRemote();
+    bool pumpConnection(Connection& conn);
+    void addConnection(SOCKET sock, LIBSSH2_CHANNEL* channel);
+
+    // 关闭本地 socket 并推进通道的关闭与释放。非阻塞模式下返回 false 表示还在等待对端（EAGAIN），
+    // 下一轮再调用；freeChannel 为 false 时只丢弃通道指针（会话已失效）
+    bool closeConnection(Connection& conn, bool freeChannel);
+
+    // 会话已失效或已被重建（reconnect）时，通道与监听器随旧会话一起释放，只能丢弃指针
+    bool sessionChanged() const;
+
+    // 释放全部连接与转发，freeSsh 为 false 时只关闭本地 socket
+    void releaseAll(bool freeSsh);
+
+    SSHManager* sshManager;
+    LIBSSH2_SESSION* session = nullptr;   // 添加第一个转发时的会话
+
+    mutable std::mutex forwardsMutex;     // 保护 localForwards / remoteForwards（添加可能发生在泵线程运行时）
+    std::vector<LocalForward> localForwards;
+    std::vector<RemoteForward> remoteForwards;
+
+    // 只由泵线程访问（stop() 在 join 之后才访问）
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::vector<PendingOpen> pendingOpens;
+
+    std::atomic<bool> running{false};
+    std::thread pumpThread;
+
+    std::atomic<uint64_t> bytesToRemote{0};
+    std::atomic<uint64_t> bytesFromRemote{0};
+    std::atomic<uint64_t> connectionCount{0};
+    std::atomic<uint64_t> activeCount{0};
+    std::atomic<uint64_t> failedCount{0};
+};
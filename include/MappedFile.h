@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ===== 内存映射文件 =====
+// 只读映射用于直接扫描 GB 级日志（不读入 std::string），读写映射用于按列写出分析文件。
+// Windows 使用 CreateFileMapping / MapViewOfFile，其他平台使用 mmap。打开失败抛出 ConfigException。
+// 只可移动，析构时解除映射并关闭文件。
+class MappedFile {
+public:
+    enum class Mode { ReadOnly, ReadWrite };
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 映射已有文件（空文件也可以打开，此时 data() 为 nullptr）
+    static MappedFile open(const std::string& path, Mode mode = Mode::ReadOnly);
+
+    // 创建（或截断）文件并设置为 size 字节，以读写方式映射
+    static MappedFile create(const std::string& path, uint64_t size);
+
+    const char* data() const { return base; }
+    char* data() { return base; }
+    size_t size() const { return length; }
+    bool isOpen() const { return handle != kInvalid; }
+
+    // 把已修改的页写回磁盘（读写映射）
+    void flush();
+    void close();
+
+private:
+#ifdef _WIN32
+    using Handle = void*;
+    static constexpr Handle kInvalid = nullptr;
+    Handle mapping = nullptr;
+#else
+    using Handle = intptr_t;
+    static constexpr Handle kInvalid = -1;
+#endif
+
+    void map(const std::string& path, Mode mode);
+
+    Handle handle = kInvalid;
+    char* base = nullptr;
+    size_t length = 0;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include "SSHManager.h"
+
+// ===== 实时参数推送 =====
+// 调参时 +/- 按钮只改本地输入框，必须整体保存后才会到达机器人。实时模式下，
+// 通过已认证会话上的 direct-tcpip 通道连接机器人本机的控制端口（默认 127.0.0.1:9877），
+// 每次按键只记录“参数 -> 最新值”，由 tick() 以固定频率（默认 50Hz）把有变化的参数合并发送，
+// 连续快速点击不会产生消息风暴。
+//
+// 协议（按行，ASCII）：
+//   客户端 -> 机器人：SET <参数名> <值> <序号> <发送时间 us>\n
+//   机器人 -> 客户端：ACK <序号>\n
+// 端到端延迟 = 收到 ACK 的时刻 - 发送时刻（包含链路往返与控制器处理时间）。
+//
+// libssh2 会话不是线程安全的，tick() 在会话锁内访问通道（GUI 中由 QTimer 驱动）；会话正被其他线程
+// 使用时 tick() 不等待，直接跳过本轮。push() 可以在任意线程调用。
+class ParameterStreamer {
+public:
+    struct Options {
+        std::string remoteHost = "127.0.0.1";   // 机器人上控制端口的地址（相对机器人）
+        int remotePort = 9877;
+        int rateHz = 50;                        // 合并发送频率
+    };
+
+    struct Stats {
+        uint64_t updates = 0;        // push() 调用次数
+        uint64_t messagesSent = 0;   // 实际发送的 SET 消息数（合并后）
+        uint64_t acked = 0;
+        double lastLatencyMs = 0.0;
+        double meanLatencyMs = 0.0;
+        double maxLatencyMs = 0.0;
+        size_t inFlight = 0;         // 已发送未确认的消息数
+    };
+
+    explicit ParameterStreamer(SSHManager* manager);
+    ~ParameterStreamer();
+
+    ParameterStreamer(const ParameterStreamer&) = delete;
+    ParameterStreamer& operator=(const ParameterStreamer&) = delete;
+
+    // 打开 direct-tcpip 通道，失败抛出 SSHSessionException
+    void start();
+    void start(const Options& options);
+    void stop();
+    bool isRunning() const { return channel != nullptr; }
+
+    // 记录参数的最新值，下一次 tick() 时发送
+    void push(const std::string& name, double value);
+
+    // 发送积压的变化并读取 ACK；会话忙时跳过本轮并返回 true，通道出错时停止并返回 false
+    bool tick();
+
+    // tick() 的调用间隔
+    int intervalMs() const { return 1000 / std::max(1, options.rateHz); }
+
+    Stats stats() const;
+
+private:
+    void readAcks();
+
+    // 会话已失效或已被重建（reconnect）时，通道随旧会话一起释放，只能丢弃指针
+    bool sessionChanged() const;
+
+    SSHManager* sshManager;
+    Options options;
+    LIBSSH2_SESSION* session = nullptr;   // 打开通道时的会话
+    LIBSSH2_CHANNEL* channel = nullptr;
+
+    mutable std::mutex mutex;                  // 保护 pending 与 stats
+    std::map<std::string, double> pending;     // 尚未发送的最新值（按参数名合并）
+    Stats counters;
+
+    uint64_t nextSeq = 1;
+    std::map<uint64_t, std::chrono::steady_clock::time_point> sentAt;
+    std::string outgoing;                      // 上次未写完的数据（对端窗口满时）
+    std::string incoming;                      // 未凑成整行的 ACK 数据
+};
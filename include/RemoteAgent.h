@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "RemoteCommandExecutor.h"
+
+class SSHManager;
+
+// ===== 常驻远端代理 =====
+// 每次 executeRemoteCommand 都要打开通道、exec 并启动一个远端 shell，再等待 EOF/close，
+// 在 Wi-Fi 链路上一条命令就是多个往返。代理模式在一个不带 PTY 的通道上启动一个常驻的 sh 循环，
+// 之后每个请求只需一次帧往返，不再有通道建立、exec 和 shell 启动的开销。
+//
+// 帧格式（全部走通道 stdin/stdout）：
+//   请求：  "<OP> <LEN>\n<PATH>\n" 后跟 LEN 字节负载
+//   响应：  "<STATUS> <LEN>\n" 后跟 LEN 字节负载（STATUS 为 0 表示成功，否则负载为错误信息）
+// OP：P ping、R 读文件、S stat、H sha256、W 原子写（负载为文件内容）、E 执行命令（负载为脚本，
+// 响应负载为 stdout，STATUS 为退出码）、Q 退出。
+// 代理只依赖 sh 与 coreutils（head -c / stat / sha256sum），不需要向机器人上传任何二进制。
+class RemoteAgent {
+public:
+    struct StatInfo {
+        uint64_t size = 0;
+        int64_t mtime = 0;   // 秒
+        int mode = 0;        // 权限位（八进制解析后）
+    };
+
+    explicit RemoteAgent(SSHManager* manager);
+    ~RemoteAgent();
+
+    RemoteAgent(const RemoteAgent&) = delete;
+    RemoteAgent& operator=(const RemoteAgent&) = delete;
+
+    // 启动远端循环并等待就绪标记，失败返回 false（调用方回退到逐条 exec）
+    bool start(int timeoutMs = 5000);
+
+    // 发送退出请求并关闭通道
+    void stop();
+
+    bool isRunning() const { return executor != nullptr; }
+
+    // 一次空请求的往返耗时（毫秒），失败抛出异常
+    double ping();
+
+    // 以下操作在远端报错时抛出 RemoteCommandException，传输/协议错误抛出 SSHSessionException 并停止代理
+    std::string readFile(const std::string& path);
+    void atomicWrite(const std::string& path, const std::string& content);
+    std::string sha256(const std::string& path);
+
+    // 文件不存在或无法访问返回 false
+    bool stat(const std::string& path, StatInfo& info);
+
+    // 执行 shell 命令，stdout 写入 output，返回退出码（与 ConfigReader::executeRemoteCommand 相同，不含 stderr）
+    int exec(const std::string& command, std::string& output);
+
+private:
+    struct Response {
+        int status = 0;
+        std::string payload;
+    };
+
+    Response request(char op, const std::string& path, const std::string& payload, int timeoutMs = 30000);
+    std::string readLine(int timeoutMs);
+    void readExact(size_t len, std::string& out, int timeoutMs);
+    [[noreturn]] void fail(const std::string& message);
+
+    SSHManager* sshManager;
+    std::unique_ptr<RemoteCommandExecutor> executor;
+    std::string pending;   // 已从通道读出但尚未消费的字节
+    std::mutex mutex;      // 请求/响应必须成对，串行化并发调用
+};
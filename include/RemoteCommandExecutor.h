@@ -34,6 +34,10 @@ private:
     string command;
     bool usePTY;
     SSHManager* sshManager; // 用于在需要时重新连接
+    string stderrOutput;    // 写入 stdin 期间顺带读取的 stderr
+
+    // 读取并丢弃 stdout、收集 stderr，防止远端输出填满窗口后停止消费 stdin
+    void drainOutput();
 
 public:
     LIBSSH2_CHANNEL* getChannel();
@@ -46,5 +50,23 @@ public:
     // 读取命令输出（支持中断）
     void readOutput();
 
+    // ===== stdin 流式写入 =====
+    // 把 data 完整写入远端进程的 stdin。libssh2 在对端窗口耗尽时返回 EAGAIN 或部分写入，
+    // 此时等待 socket 可写并继续写剩余部分（流量控制）；timeoutMs 内没有任何进展则抛出 SSHException。
+    void writeInput(const char* data, size_t len, int timeoutMs = 30000);
+
+    // 关闭远端进程的 stdin（发送 EOF）
+    void sendEof(int timeoutMs = 30000);
+
+    // 等待远端进程退出并返回退出码；stdout 追加到 output（可为 nullptr）。超时返回 -1
+    int waitForExit(string* output = nullptr, int timeoutMs = 30000);
+
+    // 读取远端 stdout 中已到达的数据（最多 len 字节），没有数据时等待 socket；
+    // 返回 0 表示远端已关闭 stdout，timeoutMs 内没有任何数据抛出 SSHException。用于长连接的帧协议
+    size_t readSome(char* buffer, size_t len, int timeoutMs = 30000);
+
+    // 已收集的 stderr 内容（用于错误信息）
+    const string& getStderr() const { return stderrOutput; }
+
     ~RemoteCommandExecutor();
 };
\ No newline at end of file
@@ -304,4 +304,27 @@ public:
     }
 };
 
+// ===== LibSSH2 Non-blocking Mode RAII Wrapper =====
+// 作用域内把会话切换为非阻塞模式，退出时恢复阻塞模式（其余调用方默认使用阻塞模式）
+class NonBlockingScope {
+private:
+    LIBSSH2_SESSION* session;
+
+public:
+    explicit NonBlockingScope(LIBSSH2_SESSION* sess) noexcept : session(sess) {
+        if (session) {
+            libssh2_session_set_blocking(session, 0);
+        }
+    }
+
+    ~NonBlockingScope() noexcept {
+        if (session) {
+            libssh2_session_set_blocking(session, 1);
+        }
+    }
+
+    NonBlockingScope(const NonBlockingScope&) = delete;
+    NonBlockingScope& operator=(const NonBlockingScope&) = delete;
+};
+
 } // namespace ResourceManagement
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "Backoff.h"
+
+class SSHManager;
+
+// ===== 远程操作重试策略 =====
+// 代替各处“最多 N 次、每次固定 sleep 1 秒”的重试循环。每次失败先分类再决定怎么做：
+//   Transient     通道打开失败、超时等会话仍然可用的错误：按带抖动的指数退避等待后在同一会话上重试
+//   Disconnected  socket 已断开：调用 SSHManager::tryReconnect 重建连接后立即重试
+//   Fatal         认证 / 权限 / 命令本身失败 / 取消 / 没有会话：不重试，原异常直接抛给调用方
+// 全部尝试（含退避和重连）受总时限约束，下一次退避会超过时限时不再等待，直接失败。
+// 进程内所有重试的计数汇总在 RetryPolicy::metrics() 中。
+//
+//   RetryPolicy retry("removeRemoteFiles", sshManager, options);
+//   size_t removed = retry.run([&]() { ...; return count; });
+class RetryPolicy {
+public:
+    enum class ErrorClass { Transient, Disconnected, Fatal };
+
+    struct Options {
+        int maxAttempts = 3;
+        std::chrono::milliseconds deadline{10000};      // 从第一次尝试开始计算
+        Backoff::Policy backoff{std::chrono::milliseconds(50), std::chrono::milliseconds(1000), 2.0, 0.5};
+        bool reconnect = true;                          // Disconnected 时是否重建连接
+        const std::atomic<bool>* cancel = nullptr;      // 置位后不再重试
+    };
+
+    struct Metrics {
+        uint64_t calls = 0;
+        uint64_t attempts = 0;
+        uint64_t retries = 0;
+        uint64_t recovered = 0;             // 重试后成功的调用
+        uint64_t reconnects = 0;
+        uint64_t reconnectFailures = 0;
+        uint64_t fatal = 0;                 // 因不可重试的错误直接失败
+        uint64_t exhausted = 0;             // 次数 / 时限用尽或被取消后失败
+        uint64_t backoffMs = 0;             // 累计退避等待
+    };
+
+    RetryPolicy(std::string name, SSHManager* ssh) : RetryPolicy(std::move(name), ssh, Options()) {}
+    RetryPolicy(std::string name, SSHManager* ssh, const Options& options);
+
+    // 执行 fn，失败时按分类重试；最终失败时抛出最后一次的原异常
+    template <typename F>
+    auto run(F&& fn) -> decltype(fn());
+
+    // ssh 为空时只按异常类型分类；否则结合传输层状态与 libssh2 最近的错误码（不打开通道）
+    static ErrorClass classify(const std::exception& e, SSHManager* ssh);
+    static ErrorClass classifyLibssh2(int code);
+    static const char* className(ErrorClass errorClass);
+
+    static Metrics metrics();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void begin();
+    void succeeded(int attempt);
+    // 在 catch 块中调用：需要重试时完成退避 / 重连并返回 true，否则记录失败并返回 false
+    bool shouldRetry(const std::exception& e, int attempt);
+
+    std::string name;
+    SSHManager* ssh;
+    Options opts;
+    Backoff backoff;
+    Clock::time_point started;
+};
+
+template <typename F>
+auto RetryPolicy::run(F&& fn) -> decltype(fn()) {
+    begin();
+    for (int attempt = 1;; ++attempt) {
+        try {
+            if constexpr (std::is_void_v<decltype(fn())>) {
+                fn();
+                succeeded(attempt);
+                return;
+            } else {
+                auto result = fn();
+                succeeded(attempt);
+                return result;
+            }
+        } catch (const std::exception& e) {
+            if (!shouldRetry(e, attempt)) {
+                throw;
+            }
+        }
+    }
+}
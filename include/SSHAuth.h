@@ -0,0 +1,62 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <libssh2.h>
+
+// ===== SSH 认证 =====
+// SSHManager 按以下顺序尝试认证，直到某一种成功（passwordBeforeKeys 时密码最先尝试）：
+//   1. ssh-agent（Windows 上为 OpenSSH Authentication Agent / Pageant）
+//   2. 私钥（来自 SSHKeyCache，进程内只读取一次，所有主机、所有并发连接共享）
+//   3. 密码
+// 每种方式只在服务器 userauth_list 允许时才尝试，避免无谓的往返和失败计数。
+// 每次被拒绝的公钥都计入服务器的 MaxAuthTries（OpenSSH 默认 6），agent 身份 + 私钥合计最多尝试 maxKeyAttempts 次，
+// 保证之后的密码认证不会因 "Too many authentication failures" 被断开。
+
+// 内存中的私钥（PEM / OpenSSH 格式文本），由 libssh2_userauth_publickey_frommemory 使用
+struct SSHKey {
+    std::string sourcePath;
+    std::string privateKey;
+    std::string publicKey;   // 可为空，由 libssh2 从私钥推导
+    std::string passphrase;
+};
+
+// ===== 私钥缓存 =====
+// 批量连接 N 台机器人时，私钥文件只从磁盘读取一次
+class SSHKeyCache {
+public:
+    // 读取 path（及可选的 path + ".pub"），已缓存则直接返回；文件不存在时返回 nullptr
+    static std::shared_ptr<const SSHKey> load(const std::string& path, const std::string& passphrase = "");
+
+    // 默认私钥位置：环境变量 ADJUSTBIAS_SSH_KEY，否则依次查找 ~/.ssh/id_ed25519、id_ecdsa、id_rsa
+    static std::string defaultKeyPath();
+
+    static void clear();
+
+private:
+    static std::mutex mutex;
+    static std::map<std::string, std::shared_ptr<const SSHKey>> keys;
+};
+
+struct SSHAuthOptions {
+    std::string password;                // 为空则不尝试密码认证
+    std::shared_ptr<const SSHKey> key;   // 为空则不尝试私钥认证
+    bool useAgent = false;
+    bool passwordBeforeKeys = false;     // 先尝试密码，失败或未提供密码时再尝试 agent / 私钥
+    int maxKeyAttempts = 3;              // agent 身份与私钥合计的公钥尝试次数上限
+
+    static SSHAuthOptions withPassword(const std::string& password);
+
+    // 批量工具默认：先 agent，再默认位置的私钥（如存在），最后密码
+    static SSHAuthOptions preferKeys(const std::string& password);
+
+    // 先密码，再 agent 与私钥（已知密码可用、希望少一次公钥往返时）
+    static SSHAuthOptions passwordThenKeys(const std::string& password);
+};
+
+// ===== 认证执行 =====
+// 在已完成握手的会话上执行认证链；成功返回所用方式（"agent" / "publickey" / "password"），
+// 全部失败抛出 SSHAuthenticationException，错误信息中包含每种方式的失败原因
+std::string authenticateSession(LIBSSH2_SESSION* session, const std::string& username, const SSHAuthOptions& options);
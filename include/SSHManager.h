@@ -20,10 +20,15 @@
 #include <iomanip>
 #include <filesystem>
 #include "Exceptions.h"
+#include "SSHAuth.h"
+#include "TransportProfile.h"
+#include "SessionReactor.h"
 
 #pragma comment(lib, "ws2_32.lib")
 #pragma comment(lib, "libssh2.lib")
 
+class RemoteAgent;
+
 // 全局中断标志（应尽量避免使用全局变量，考虑使用信号量）
 extern std::atomic<bool> g_interrupted;
 
@@ -44,19 +49,36 @@ private:
     std::string password;
     int port;
     bool sessionValid = false;
+    SSHAuthOptions authOptions;   // 认证链（agent -> 私钥 -> 密码）
+    std::string authMethod;       // 最近一次认证成功所用的方式
+    TransportProfile transportProfile;  // 请求的传输方案（可能为 auto）
+    TransportProfile activeTransport;   // 本次连接实际使用的方案
+    double connectRttMs = 0.0;          // 最近一次 TCP 建连耗时
+    int connectTimeoutOverrideMs = 0;   // 本连接的建连超时，0 表示使用进程默认值
+
+    // 常驻远端代理（可选）：会话重建时随之失效，下次 getRemoteAgent 时重新启动
+    std::unique_ptr<RemoteAgent> remoteAgent;
+    std::mutex agentMutex;
+    bool agentEnabled = false;
+    bool agentStartFailed = false;      // 启动失败后不在每条命令上重试，直到重连或重新启用
+    void stopRemoteAgent();
 
-    // 监控线程
-    std::thread monitorThread;
-    std::atomic<bool> monitorRunning{false};
-    std::mutex monitorMutex;
-    std::condition_variable monitorCV;  // ===== Optimization #6: Condition variable for efficient monitoring =====
-    int monitorIntervalMs = 30000; // 改为30秒检测一次，减少开销
-    std::mutex sessionMutex; // 添加会话互斥锁
+    // 断线检测与保活由进程共用的 SessionReactor 驱动（不再为每个连接启动监控线程）
+    SessionReactor::Id reactorId = 0;
+    std::atomic<bool> linkLost{false};  // 事件循环检测到断线后置位，重连成功后清除
+    void registerWithReactor();
+    std::recursive_mutex sessionMutex; // 会话互斥锁（可重入：持锁期间仍可调用 getSession）
     std::weak_ptr<SSHManager> weakThis; // 用于线程安全的生命周期管理
     
     void cleanup();
     void connectSocket();
     void initializeSSH();
+
+    // 按传输方案设置算法偏好与压缩，须在握手前调用
+    void applyMethodPreferences();
+
+    // 握手并执行认证链，initializeSSH 与 reconnect 共用；失败抛出异常（不清理资源）
+    void handshakeAndAuthenticate(const std::string& context);
     
     // 异常日志记录
     static void logException(const std::string& exceptionType, const std::string& exceptionMsg, const std::string& context = "");
@@ -74,6 +96,19 @@ public:
     SSHManager(const std::string& host, const std::string& username, 
                const std::string& password, int port = 22);
 
+    // 使用指定认证链连接（例如 SSHAuthOptions::preferKeys(password)），
+    // 传输方案取 TransportProfileRegistry::forHost(host)
+    SSHManager(const std::string& host, const std::string& username,
+               const SSHAuthOptions& auth, int port = 22);
+    // connectTimeoutMs > 0 时本连接（含重连）使用该建连超时，不影响其他连接
+    SSHManager(const std::string& host, const std::string& username,
+               const SSHAuthOptions& auth, int port, const TransportProfile& transport, int connectTimeoutMs = 0);
+
+    // 进程默认的 TCP 建连超时（毫秒，对之后创建且未单独指定超时的连接生效）；
+    // 默认取 ADJUSTBIAS_CONNECT_TIMEOUT_MS，未设置时为 10 秒
+    static void setConnectTimeoutMs(int timeoutMs);
+    static int connectTimeoutMs();
+
     // 禁用拷贝构造函数和赋值运算符
     SSHManager(const SSHManager&) = delete;
     SSHManager& operator=(const SSHManager&) = delete;
@@ -85,16 +120,66 @@ public:
     ~SSHManager();
 
     LIBSSH2_SESSION* getSession();
+
+    // 不做有效性检查（不打开测试通道）的会话指针，供高频调用方判断会话是否已被重建
+    LIBSSH2_SESSION* peekSession() const { return session; }
+
+    // 持有会话锁（与 getSession / 保活 / reconnect 共用）。多个线程共用会话时
+    // （端口转发、遥测读取线程），每次调用 libssh2 前都必须持有该锁；锁可重入
+    std::unique_lock<std::recursive_mutex> lockSession() { return std::unique_lock<std::recursive_mutex>(sessionMutex); }
+
+    // 不等待的版本：会话正被其他线程使用时返回未持有的锁（owns_lock() 为 false），供 GUI 线程上的定时任务跳过本轮
+    std::unique_lock<std::recursive_mutex> tryLockSession() {
+        return std::unique_lock<std::recursive_mutex>(sessionMutex, std::try_to_lock);
+    }
     
     std::string getPassword();
     
     std::string getHost();
+
+    // 最近一次认证成功所用的方式："agent" / "publickey" / "password"
+    std::string getAuthMethod() const;
+
+    // 本次连接实际使用的传输方案（auto 已解析为 lan / wifi）与测得的建连 RTT
+    TransportProfile getTransportProfile() const;
+    double getConnectRttMs() const;
     bool isSessionValid();
+
+    // 底层 TCP socket，供非阻塞 I/O 在 EAGAIN 时 select 等待
+    SOCKET getSocket() const;
+
+    // 非阻塞模式下 libssh2 返回 EAGAIN 后调用：按 libssh2_session_block_directions
+    // 等待 socket 可读/可写，超时或 socket 无效返回 false
+    bool waitSocket(int timeoutMs);
+    
+    // 启用/关闭常驻远端代理模式（见 RemoteAgent.h）
+    void enableRemoteAgent(bool enabled);
+
+    // 代理模式已启用且代理可用时返回代理（必要时启动），否则返回 nullptr，调用方回退到逐条 exec
+    RemoteAgent* getRemoteAgent();
     
     // 对外接口：判断 SSH 是否断开（会检查 session 有效性和底层 socket）
     // 返回 true 表示已断开或不可用，false 表示连接看起来还活着
     bool isSSHDisconnected();
+
+    // 只看本地状态判断传输层是否已断开（会话标志、事件循环标志、socket peek），不打开测试通道：
+    // 通道被拒绝（如 MaxSessions）不代表连接已断，供错误分类等不能改变会话状态的场合使用
+    bool isTransportLost();
+
+    // libssh2 记录的最近错误码，不做有效性检查；没有会话时返回 LIBSSH2_ERROR_SOCKET_NONE
+    int lastErrorCode();
     
+    // 发送 SSH 保活（keepalive@openssh.com，间隔 intervalSec 秒，未到间隔时不发送）。
+    // 不阻塞等待会话锁；nextSeconds 返回距下次需要发送的秒数。通常由 SessionReactor 定时调用
+    enum class KeepaliveResult { Alive, Busy, Dead };
+    KeepaliveResult sendKeepalive(int intervalSec, int* nextSeconds = nullptr);
+
+    // 事件循环是否检测到连接已断开（只读标志，不做任何网络操作，可在界面定时器中频繁调用）
+    bool isLinkLost() const { return linkLost.load(); }
+
+    // 重新建立连接，失败返回 false 而不抛出异常（供自动重连使用）
+    bool tryReconnect();
+
     // 强制设置会话为无效（用于模拟中断后的状态）
     void invalidateSession();
 };
\ No newline at end of file
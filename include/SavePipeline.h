@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class ConfigReader;
+
+// ===== 分阶段保存 =====
+// 界面“保存”的完整流程放在工作线程中按阶段执行，界面线程只轮询 progress() 刷新状态栏，不再弹出模态对话框：
+//   Validate  解析输入框文本（限速可为 “nan” / “未设置”，表示删除该参数），检查是否为有限数值
+//   Diff      与最近一次读取 / 写入的文件内容（ConfigReader::parsedValues）比较，得到本次改动
+//   Write     ConfigReader::writeMultipleParametersToFile（读取 → 修改 → 临时文件 + mv，配置了通知器时热更新）
+//   Verify    解析写入的内容（ConfigReader::lastWrittenContent）确认每个参数都已是目标值，不再额外读一次远端文件
+//   Archive   把写入的内容交给 archiver 存档（桌面“偏置调节记录”），失败只记录不影响保存结果
+//
+// 工作线程独占使用 ConfigReader；保存进行期间调用方不能再使用同一个 ConfigReader（重连 / 断开前先 wait()）。
+class SavePipeline {
+public:
+    enum class Stage { Validate, Diff, Write, Verify, Archive, Done };
+    static constexpr int kStageCount = 5;
+
+    struct Change {
+        std::string param;
+        bool hadValue = false;          // 原文件中是否存在
+        double before = 0.0;
+        double after = 0.0;             // NaN 表示删除
+    };
+
+    struct Progress {
+        Stage stage = Stage::Validate;  // 正在执行的阶段（结束后为 Done）
+        int completedStages = 0;
+        bool finished = false;
+        std::string message;
+    };
+
+    struct Result {
+        bool ok = false;
+        Stage failedStage = Stage::Done;
+        std::string error;
+        std::vector<std::pair<std::string, double>> values;   // Validate 解析出的目标值（顺序与输入相同）
+        std::vector<Change> changes;
+        std::string content;            // 写入并校验过的文件内容
+        bool liveUpdated = false;       // 已通知控制器热更新
+        std::string archivePath;
+        std::string archiveError;
+        double stageMs[kStageCount] = {};
+    };
+
+    // 输入为 参数名 -> 输入框文本；archiver 返回存档文件路径，失败时抛出异常
+    using Inputs = std::vector<std::pair<std::string, std::string>>;
+    using Archiver = std::function<std::string(const std::string& content)>;
+
+    explicit SavePipeline(ConfigReader* reader);
+    ~SavePipeline();
+    SavePipeline(const SavePipeline&) = delete;
+    SavePipeline& operator=(const SavePipeline&) = delete;
+
+    // 启动工作线程；上一次保存尚未结束时返回 false
+    bool start(const Inputs& inputs, const Archiver& archiver);
+    bool isRunning() const { return running.load(); }
+    void wait();
+
+    Progress progress() const;
+    // 保存结束（progress().finished）后有效
+    Result result() const;
+
+    static const char* stageName(Stage stage);
+
+    // x_vel_limit_walk / x_vel_limit_run 允许为空（NaN，删除该参数）
+    static bool isDeletable(const std::string& param);
+
+private:
+    void run(Inputs inputs, Archiver archiver);
+    void enter(Stage stage, const std::string& message);
+
+    ConfigReader* reader;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    mutable std::mutex stateMutex;
+    Progress state;
+    Result outcome;
+};
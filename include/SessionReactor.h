@@ -0,0 +1,118 @@
+#pragma once
+
+#include <winsock2.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Backoff.h"
+
+// ===== 会话事件循环 =====
+// 进程内所有 SSH 会话共用一个事件循环线程（WSAPoll）和少量工作线程，代替每个 SSHManager 一个监控线程：
+//   - 监视每个会话的 socket：挂断 / 出错 / 对端关闭（可读但 peek 到 0 字节）即判定断线
+//   - 按会话的保活定时器发送 SSH keepalive（回调不等待会话锁，会话正忙时 1 秒后再试）
+//   - 可选的自动重连：断线后按带抖动的指数退避在工作线程中重建连接
+// 会话数据（命令输出、遥测、端口转发）仍由各自的使用方在持有会话锁时读写，事件循环只做只读的可读性检查，
+// 可读（有数据待读）的 socket 在下一次保活前不再参与轮询，避免数据未被读走时空转。
+//
+// 参数取环境变量：ADJUSTBIAS_KEEPALIVE_SEC（默认 30）、ADJUSTBIAS_AUTO_RECONNECT=1（默认关闭）、
+// ADJUSTBIAS_REACTOR_WORKERS（默认 2）。
+class SessionReactor {
+public:
+    struct Options {
+        int workers = 2;                // 执行重连等阻塞任务的线程数
+        int keepaliveSec = 30;
+        bool autoReconnect = false;
+        Backoff::Policy reconnectBackoff{std::chrono::milliseconds(1000), std::chrono::milliseconds(30000), 2.0, 0.5};
+    };
+
+    // keepalive / disconnected 在事件循环线程中调用，不得阻塞；reconnect 在工作线程中调用，可以阻塞
+    struct Callbacks {
+        // 发送保活：返回距下次发送的秒数；会话正忙返回 0（1 秒后再试）；连接已断开返回负数
+        std::function<int(int intervalSec)> keepalive;
+        // 检测到断线（只通知一次，直到 setSocket 设置新的 socket）
+        std::function<void()> disconnected;
+        // 重建连接，成功时应已通过 setSocket 设置新 socket；为空时不自动重连
+        std::function<bool()> reconnect;
+    };
+
+    struct Stats {
+        size_t sessions = 0;
+        size_t watched = 0;             // 当前参与轮询的 socket 数
+        size_t threads = 0;             // 事件循环 + 工作线程
+        uint64_t loopIterations = 0;
+        uint64_t keepalives = 0;
+        uint64_t disconnects = 0;
+        uint64_t reconnects = 0;
+        uint64_t reconnectFailures = 0;
+    };
+
+    using Id = uint64_t;
+
+    // 进程共用的实例，第一次调用时按环境变量创建并启动线程
+    static SessionReactor& instance();
+    static Options optionsFromEnvironment();
+
+    explicit SessionReactor(const Options& options);
+    ~SessionReactor();
+    SessionReactor(const SessionReactor&) = delete;
+    SessionReactor& operator=(const SessionReactor&) = delete;
+
+    Id add(SOCKET sock, const Callbacks& callbacks);
+
+    // 返回后不会再调用该会话的回调（正在执行的重连会先等待完成），调用方随后可以关闭 socket / 释放对象
+    void remove(Id id);
+
+    // 更换会话的 socket（重连后）；INVALID_SOCKET 表示暂停监视（主动断开 / 重连前关闭 socket 之前调用）
+    void setSocket(Id id, SOCKET sock);
+
+    Stats stats() const;
+    const Options& options() const { return opts; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum class State { Watching, Paused, Dead, Reconnecting };
+
+    struct Entry {
+        SOCKET sock = INVALID_SOCKET;
+        Callbacks callbacks;
+        State state = State::Paused;
+        Clock::time_point nextKeepalive;
+        Clock::time_point quietUntil;       // 可读后暂停轮询到此时刻
+        Clock::time_point nextReconnect;
+        Backoff backoff;
+        bool removing = false;
+    };
+
+    void loop();
+    void workerLoop();
+    void wake();
+    void markDead(Id id, Entry& entry, Clock::time_point now);
+    void runReconnect(Id id);
+
+    Options opts;
+    mutable std::mutex mutex;
+    std::condition_variable changed;    // 重连结束（remove 等待）/ 工作队列有任务
+    std::map<Id, Entry> entries;
+    Id nextId = 1;
+    std::deque<Id> reconnectQueue;
+    bool stopping = false;
+
+    SOCKET wakeSocket = INVALID_SOCKET;  // 绑定到回环地址并 connect 到自身的 UDP socket
+    std::thread loopThread;
+    std::vector<std::thread> workers;
+
+    std::atomic<uint64_t> iterations{0};
+    std::atomic<uint64_t> keepalives{0};
+    std::atomic<uint64_t> disconnects{0};
+    std::atomic<uint64_t> reconnects{0};
+    std::atomic<uint64_t> reconnectFailures{0};
+    std::atomic<size_t> watchedCount{0};
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ===== SHA-256 =====
+// 本地计算文件摘要，与远端 `sha256sum` 的输出比对，用于上传校验和目录同步。
+// 支持增量 update()，上传时边读边算，不需要第二次读盘。
+class Sha256 {
+public:
+    Sha256();
+
+    void update(const void* data, size_t len);
+
+    // 结束计算并返回 64 位小写十六进制摘要；之后对象回到初始状态
+    std::string finishHex();
+
+    static std::string hashString(const std::string& data);
+
+    // 计算本地文件摘要；文件无法打开时返回空字符串
+    static std::string hashFile(const std::string& path);
+
+private:
+    void reset();
+    void transform(const uint8_t* block);
+
+    uint32_t state[8];
+    uint64_t totalBytes;
+    uint8_t buffer[64];
+    size_t bufferLen;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// ===== 遥测样本与单生产者/单消费者环形缓冲区 =====
+// 读取线程（生产者）解析出样本后 push，GUI 线程（消费者）每帧 drain 一次。
+// 容量固定为 2 的幂，push/pop 只有两次原子读写，不加锁、不分配内存；
+// 缓冲区满时新样本被丢弃并计数（GUI 长时间卡住时宁可丢样本也不阻塞读取线程）。
+
+struct TelemetrySample {
+    double t = 0.0;     // 时间戳（秒，来自数据源；缺失时为接收时刻）
+    float roll = 0.0f;  // xsense roll（度）
+    float pitch = 0.0f; // xsense pitch（度）
+    float vx = 0.0f;    // 机体速度 x（m/s）
+    float vy = 0.0f;    // 机体速度 y（m/s）
+    float wz = 0.0f;    // 偏航角速度（rad/s）
+};
+
+template <typename T>
+class SpscRing {
+public:
+    // capacity 向上取整为 2 的幂
+    explicit SpscRing(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask = size - 1;
+        slots.reset(new T[size]);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // 仅生产者线程调用；满时返回 false
+    bool push(const T& value) {
+        const size_t head = writeIndex.load(std::memory_order_relaxed);
+        if (head - readIndex.load(std::memory_order_acquire) > mask) {
+            dropCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots[head & mask] = value;
+        writeIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 仅消费者线程调用：把当前全部样本交给 sink（逐个调用），返回取出的数量
+    template <typename Sink>
+    size_t drain(Sink&& sink) {
+        size_t tail = readIndex.load(std::memory_order_relaxed);
+        const size_t head = writeIndex.load(std::memory_order_acquire);
+        const size_t count = head - tail;
+        for (; tail != head; ++tail) {
+            sink(slots[tail & mask]);
+        }
+        readIndex.store(tail, std::memory_order_release);
+        return count;
+    }
+
+    size_t capacity() const { return mask + 1; }
+    uint64_t dropped() const { return dropCount.load(std::memory_order_relaxed); }
+
+private:
+    std::unique_ptr<T[]> slots;
+    size_t mask = 0;
+    // 生产者与消费者各自写的索引放在不同缓存行，避免伪共享
+    alignas(64) std::atomic<size_t> writeIndex{0};
+    alignas(64) std::atomic<size_t> readIndex{0};
+    std::atomic<uint64_t> dropCount{0};
+};
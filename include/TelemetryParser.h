@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "TelemetryBuffer.h"
+
+// ===== 遥测行解析 =====
+// 输入为逗号 / 空白分隔的文本行（CSV 日志或转发的 socket 流），例如：
+//   t,roll,pitch,vx,vy,wz
+//   12.001,0.42,-1.37,0.003,-0.011,0.0008
+// 不是数字的行视为表头，按列名确定各字段位置（不区分大小写，支持常见别名，
+// 如 xsense_data_roll / time / yaw_rate）；没有表头时按 t,roll,pitch,vx,vy,wz 的顺序解析。
+//
+// feed() 直接在调用方的接收缓冲区上按行扫描（memchr + from_chars），完整的行不做任何拷贝，
+// 只有跨越两次 feed 的残行才暂存到内部缓冲区。
+class TelemetryLineParser {
+public:
+    enum Field { Time = 0, Roll, Pitch, Vx, Vy, Wz, FieldCount };
+
+    TelemetryLineParser();
+
+    // 解析 data 中的所有完整行，每得到一个样本调用一次 sink(const TelemetrySample&)；返回样本数
+    template <typename Sink>
+    size_t feed(const char* data, size_t len, Sink&& sink) {
+        size_t samples = 0;
+        const char* end = data + len;
+        const char* cursor = data;
+
+        // 先补全上一次遗留的残行
+        if (!partial.empty()) {
+            const char* newline = static_cast<const char*>(memchrSafe(cursor, end));
+            if (!newline) {
+                appendPartial(cursor, end);
+                return 0;
+            }
+            appendPartial(cursor, newline);
+            TelemetrySample sample;
+            if (parseLine(partial, sample)) {
+                sink(sample);
+                ++samples;
+            }
+            partial.clear();
+            cursor = newline + 1;
+        }
+
+        while (cursor < end) {
+            const char* newline = static_cast<const char*>(memchrSafe(cursor, end));
+            if (!newline) {
+                appendPartial(cursor, end);
+                break;
+            }
+            TelemetrySample sample;
+            if (parseLine(std::string_view(cursor, static_cast<size_t>(newline - cursor)), sample)) {
+                sink(sample);
+                ++samples;
+            }
+            cursor = newline + 1;
+        }
+        return samples;
+    }
+
+    // 解析一行（不含换行符），表头行返回 false 并更新列映射
+    bool parseLine(std::string_view line, TelemetrySample& sample);
+
+    // 解析失败（非表头且字段不足或不是数字）的行数
+    size_t malformedLines() const { return malformed; }
+
+    void reset();
+
+    // 按分隔符切分一行：逗号 / 分号两侧的空白忽略，纯空白分隔时连续空白视为一个分隔符；返回字段数
+    static int split(std::string_view line, std::string_view* fields, int maxFields);
+
+    // 整个字段必须是一个数字（允许前导 +），不依赖 locale
+    static bool parseNumber(std::string_view field, double& value);
+
+private:
+    static const void* memchrSafe(const char* begin, const char* end);
+    void appendPartial(const char* begin, const char* end);
+    bool parseHeader(std::string_view line);
+
+    int columns[FieldCount];      // 字段 -> 列号，-1 表示数据源中没有该字段
+    std::string partial;
+    size_t malformed = 0;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QColor>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QWidget>
+#include <vector>
+#include "TelemetryBuffer.h"
+
+class QPainter;
+class TelemetryStream;
+
+// ===== 遥测实时曲线 =====
+// 上半部分显示 xsense roll / pitch（度），下半部分显示 vx / vy（m/s）与 wz（rad/s），
+// 图例中给出时间窗口内的均值：机器人静止时速度均值即为需要补偿的 *_vel_offset 漂移。
+//
+// 刷新定时器以约 30 FPS 运行：每帧从 TelemetryStream 的环形缓冲区取出全部新样本存入历史，
+// 然后按像素列做 M4 抽取（每列只保留首、尾、最小、最大四个点），
+// 因此绘制开销只与窗口宽度有关，与输入频率（kHz）无关。
+class TelemetryPlotWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit TelemetryPlotWidget(QWidget* parent = nullptr);
+
+    // 开始显示 stream 的数据（不持有所有权）；传 nullptr 停止取数据
+    void attach(TelemetryStream* stream);
+
+    // 横轴显示的时间长度（秒）
+    void setWindowSeconds(double seconds);
+
+    void clear();
+
+signals:
+    // 窗口被用户关闭
+    void closed();
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void closeEvent(QCloseEvent* event) override;
+
+private:
+    struct Series {
+        const char* name;
+        float TelemetrySample::*field;
+        QColor color;
+    };
+
+    void onFrame();
+    void append(const TelemetrySample& sample);
+
+    // 在 area 中绘制一组曲线，图例中附带最新值与窗口均值
+    void drawPane(QPainter& painter, const QRect& area, const QString& title,
+                  const std::vector<Series>& series, double tStart, double tEnd);
+
+    // 历史样本环（按时间顺序），下标 i 对应第 i 旧的样本
+    const TelemetrySample& at(size_t i) const { return history[(historyStart + i) % history.size()]; }
+
+    TelemetryStream* stream = nullptr;
+    QTimer frameTimer;
+    double windowSeconds = 10.0;
+
+    std::vector<TelemetrySample> history;
+    size_t historyStart = 0;
+    size_t historySize = 0;
+
+    // 输入频率与刷新耗时统计（显示在右上角）
+    QElapsedTimer rateClock;
+    uint64_t samplesSinceRate = 0;
+    double inputRateHz = 0.0;
+    double lastPaintMs = 0.0;
+    QString statusText;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "SSHManager.h"
+#include "TelemetryBuffer.h"
+#include "TelemetryParser.h"
+
+class ForwardManager;
+
+// ===== 远端遥测数据流 =====
+// 从机器人读取 IMU / 里程计数据，解析后写入 SpscRing，供界面绘图（TelemetryPlotWidget）消费。
+// 数据源（环境变量 ADJUSTBIAS_TELEMETRY）：
+//   tail:<远端文件>         远端执行 tail -F，跟随 CSV / 日志文件（先读表头行）
+//   tcp:<端口>[:<主机>]     经 ForwardManager 本地转发连接机器人视角的 <主机>（默认 127.0.0.1）:<端口>
+//
+// 读取在独立线程中进行，GUI 线程只从环形缓冲区取数据，kHz 输入不会占用界面线程。
+// tail 方式下读取线程每一轮持有 SSHManager::lockSession()（libssh2 会话不是线程安全的）。
+class TelemetryStream {
+public:
+    struct Source {
+        enum Kind { Tail, Tcp };
+        Kind kind = Tail;
+        std::string path;                 // tail：远端文件
+        std::string host = "127.0.0.1";   // tcp：机器人视角的主机
+        int port = 0;                     // tcp：端口
+
+        // 按上面的格式解析，格式错误返回 false
+        static bool parse(const std::string& spec, Source& out);
+
+        // 读取环境变量 ADJUSTBIAS_TELEMETRY，未设置或格式错误返回 false
+        static bool fromEnvironment(Source& out);
+
+        std::string describe() const;
+    };
+
+    struct Stats {
+        uint64_t bytes = 0;
+        uint64_t samples = 0;
+        uint64_t dropped = 0;     // 环形缓冲区满时丢弃的样本
+        uint64_t malformed = 0;   // 无法解析的行
+    };
+
+    // ringCapacity 为环形缓冲区容量（样本数），默认可容纳 1kHz 输入下界面停顿约 16 秒
+    explicit TelemetryStream(SSHManager* manager, size_t ringCapacity = 16384);
+    ~TelemetryStream();
+
+    TelemetryStream(const TelemetryStream&) = delete;
+    TelemetryStream& operator=(const TelemetryStream&) = delete;
+
+    // 打开数据源并启动读取线程，失败抛出 SSHSessionException / NetworkException
+    void start(const Source& source);
+    void stop();
+
+    // 读取线程仍在运行（数据源结束或出错时自行退出，原因见 lastError）
+    bool isRunning() const { return running.load(); }
+
+    // 消费端（GUI 线程）从这里 drain 样本
+    SpscRing<TelemetrySample>& samples() { return ring; }
+
+    Stats stats() const;
+    std::string lastError() const;
+
+private:
+    void tailLoop();
+    void socketLoop();
+
+    // 解析一块数据并写入环形缓冲区；缺少时间戳的样本以接收时刻（相对 start）补齐
+    void consume(const char* data, size_t len);
+
+    void fail(const std::string& message);
+    bool sessionChanged() const;
+
+    SSHManager* sshManager;
+    SpscRing<TelemetrySample> ring;
+    TelemetryLineParser parser;       // 只由读取线程访问
+    Source source;
+
+    LIBSSH2_SESSION* session = nullptr;   // tail：打开通道时的会话
+    LIBSSH2_CHANNEL* channel = nullptr;
+    std::unique_ptr<ForwardManager> forwards;   // tcp：本地转发
+    SOCKET sock = INVALID_SOCKET;
+
+    std::atomic<bool> running{false};
+    std::thread readerThread;
+    std::chrono::steady_clock::time_point startedAt;
+
+    std::atomic<uint64_t> byteCount{0};
+    std::atomic<uint64_t> sampleCount{0};
+    std::atomic<uint64_t> malformedCount{0};
+
+    mutable std::mutex errorMutex;
+    std::string error;
+};
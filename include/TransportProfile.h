@@ -0,0 +1,55 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+
+// ===== SSH 传输参数 =====
+// 每台主机可以指定一组算法偏好（逗号分隔，按优先级排列）和是否启用压缩，
+// SSHManager 在握手前通过 libssh2_session_method_pref / LIBSSH2_FLAG_COMPRESS 应用。
+// 列表中本地 libssh2 不支持的算法会被自动过滤，libssh2 支持的其余算法附在偏好之后（只调整顺序，不缩小协商范围）；
+// 字段为空表示使用 libssh2 默认值。
+//
+// 预置方案：
+//   lan      有线局域网：AES-GCM（AEAD，一次完成加密和认证），不压缩
+//   wifi     2.4GHz Wi-Fi 等慢链路：启用 zlib 压缩，参数文件/cat 输出都是文本，压缩比很高
+//   default  全部使用 libssh2 默认值（用于基准对比）
+//   auto     连接时测量 TCP 建连 RTT，低于 autoLanRttMs 选 lan，否则选 wifi
+struct TransportProfile {
+    std::string name = "default";
+    std::string kex;
+    std::string hostKey;
+    std::string cipher;        // 客户端->服务端与服务端->客户端相同
+    std::string mac;           // 使用 AEAD 密码时 MAC 不参与协商
+    bool compress = false;
+
+    bool isAuto() const { return name == "auto"; }
+
+    static TransportProfile lan();
+    static TransportProfile wifi();
+    static TransportProfile libssh2Default();
+    static TransportProfile automatic();
+
+    // 按名称查找预置方案（lan / wifi / default / auto，空名称为 default），未知名称返回 false
+    static bool byName(const std::string& name, TransportProfile& profile);
+
+    // auto 方案的解析：根据测得的 RTT（毫秒）选择 lan 或 wifi
+    static TransportProfile forRtt(double rttMs);
+
+    // RTT 低于该值（毫秒）视为有线局域网
+    static constexpr double autoLanRttMs = 3.0;
+};
+
+// ===== 按主机指定传输方案 =====
+// 未登记的主机使用环境变量 ADJUSTBIAS_SSH_PROFILE 指定的方案，未设置（或名称未知）时为 fallback：
+// 默认 auto 按 RTT 自动选择；基准测试传入 default 以保持与 libssh2 默认值对比
+class TransportProfileRegistry {
+public:
+    static void setForHost(const std::string& host, const TransportProfile& profile);
+    static TransportProfile forHost(const std::string& host,
+                                    const TransportProfile& fallback = TransportProfile::automatic());
+
+private:
+    static std::mutex mutex;
+    static std::map<std::string, TransportProfile> profiles;
+};
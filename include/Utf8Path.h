@@ -0,0 +1,26 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+// ===== 路径与 UTF-8 字符串互转 =====
+// C++20 起 path::u8string() 返回 std::u8string，这里统一转换为 std::string，C++17 / C++20 构建都可使用。
+// （反方向仍用 std::filesystem::u8path，C++20 中只是弃用警告）
+inline std::string utf8Path(const std::filesystem::path& path) {
+#if defined(__cpp_char8_t)
+    const std::u8string s = path.u8string();
+    return std::string(s.begin(), s.end());
+#else
+    return path.u8string();
+#endif
+}
+
+// 使用 / 作为分隔符（与远端路径一致）
+inline std::string utf8GenericPath(const std::filesystem::path& path) {
+#if defined(__cpp_char8_t)
+    const std::u8string s = path.generic_u8string();
+    return std::string(s.begin(), s.end());
+#else
+    return path.generic_u8string();
+#endif
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QTimer>
+#include <QWidget>
+
+class QTabWidget;
+class Widget;
+
+// ===== 多机器人工作区 =====
+// 每个标签页是一个独立的 Widget：各自的 SSH 会话、ConfigReader 参数模型、保存工作线程、实时调节与遥测。
+// 切换标签页只是切换显示，不会断开或重连；同一台机器人的重新加载只影响它自己的标签页。
+//
+// 所有会话的保活与断线检测由进程共用的 SessionReactor 驱动（见 SessionReactor.h），
+// 工作区的定时器每秒只读取一次各会话的断线标志，更新标签页标题。
+class Workspace : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit Workspace(QWidget* parent = nullptr);
+    ~Workspace() override;
+
+    // 新建一个未连接的机器人标签页并切换过去
+    Widget* addRobot();
+
+private:
+    void closeRobot(int index);
+    void refreshTitle(Widget* robot);
+    void onLinkTick();
+
+    QTabWidget* tabs = nullptr;
+    QTimer linkTimer;
+};
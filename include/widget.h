@@ -3,11 +3,23 @@
 
 #include <QWidget>
 #include <QLineEdit>
+#include <QTimer>
+#include <atomic>
+#include <map>
+#include <thread>
 #include "SSHManager.h"
 #include "ConfigReader.h"
 #include "RemoteCommandExecutor.h"
 #include "FileHandler.h"
 #include "Exceptions.h"
+#include "ParameterStreamer.h"
+#include "TelemetryStream.h"
+#include "TelemetryPlotWidget.h"
+#include "BiasEstimator.h"
+#include "DriftLogStore.h"
+#include "SavePipeline.h"
+
+class QProgressDialog;
 
 
 QT_BEGIN_NAMESPACE
@@ -27,6 +39,21 @@ public:
     // 静态方法用于记录异常日志
     static void logException(const QString& exceptionType, const QString& exceptionMsg, const QString& context = "");
 
+    // ===== 多机器人工作区（见 Workspace.h）=====
+    enum class Link { None, Connected, Lost };
+    // 标签页标题：未连接 / IP / IP（已断开）
+    QString sessionTitle() const;
+    // 已加载过（包括保活发现断线的）会话
+    bool hasSession() const { return link != Link::None; }
+    // 保存进行中（此时不能关闭标签页）
+    bool isBusy() const;
+    // 由工作区的定时器调用：事件循环发现断线（或自动重连成功）时更新状态并发出 sessionStateChanged
+    void pollLink();
+
+signals:
+    // 连接建立 / 断开 / 保活发现断线
+    void sessionStateChanged();
+
 private slots:
     void on_saveButton_clicked();
 
@@ -48,11 +75,16 @@ private slots:
     void on_yaw_run_plus_pushButton_clicked();
     void on_yaw_run_minus_pushButton_clicked();
     void on_disconnectButton_clicked();
+    void on_streamCheckBox_toggled(bool checked);
+    void onStreamTick();
+    void on_telemetryButton_clicked();
+    void on_estimateButton_clicked();
+    void onSaveTick();
+    void onEstimateTick();
 
 
 
     int main_load();
-    int main_save();
     void loadConfigToUI();
 
 
@@ -60,17 +92,69 @@ private:
     Ui::Widget *ui;
     std::string host = "192.168.1.6";
     const char* username = "ubuntu";
-    const char* password = "123";
+    // 取 ADJUSTBIAS_SSH_PASSWORD，未设置时为空：只尝试 ssh-agent / 私钥
+    const std::string password = sshPasswordFromEnv();
     const int port = 22;
     const string configPath = "/home/ubuntu/data/param/rl_control_new.txt";
     std::unique_ptr<SSHManager> sshManager;
     std::unique_ptr<ConfigReader> configReader;
+    Link link = Link::None;
+    void setLink(Link state);
     // 最近一次错误信息（用于向用户展示更详细的失败原因）
     std::string lastErrorMessage;
     
     // 通用的按钮点击处理函数
     void adjustParameter(QLineEdit* lineEdit, double& memberVar, double delta, int precision);
 
+    // 实时调节：按键变化按固定频率合并推送到机器人控制端口
+    std::unique_ptr<ParameterStreamer> streamer;
+    QTimer streamTimer;
+    int streamTicks = 0;
+    std::map<const double*, std::string> streamParamNames; // 成员变量 -> 配置参数名
+    void stopStreaming(const QString& reason);
+
+    // 遥测曲线：读取线程 + 独立窗口，属于当前会话，重连 / 断开前先停止
+    std::unique_ptr<TelemetryStream> telemetryStream;
+    std::unique_ptr<TelemetryPlotWidget> telemetryPlot;
+    void stopTelemetry();
+
+    // 分阶段保存：工作线程执行，saveTimer 轮询进度刷新进度条与状态栏
+    struct SaveField {
+        std::string param;
+        QLineEdit* lineEdit;
+        double* member;
+    };
+    std::vector<SaveField> saveFields;
+    std::unique_ptr<SavePipeline> savePipeline;
+    QTimer saveTimer;
+    void showSaveStatus(const QString& message, bool ok);
+    // 保存或偏置估计下载进行中时提示并返回 true（加载 / 断开会替换 sshManager / configReader，需等它们结束）
+    bool backgroundWorkInProgress();
+    static std::string sshPasswordFromEnv();
+    static std::string archiveSavedConfig(const QString& ipAddr, const QString& remotePath, const std::string& content);
+
+    // 偏置估计：下载与分析在工作线程中执行（漂移日志可能很大），estimateTimer 轮询进度，对话框可取消
+    struct EstimateJob {
+        QString remotePath;
+        std::atomic<uint64_t> received{0};
+        std::atomic<uint64_t> total{0};
+        std::atomic<bool> analyzing{false};     // 下载完成，正在转换 / 估计
+        std::atomic<bool> cancel{false};
+        std::atomic<bool> finished{false};
+        // finished 置位后才由 GUI 线程读取
+        std::string error;
+        BiasEstimator::Result result;
+        size_t malformedLines = 0;
+    };
+    std::shared_ptr<EstimateJob> estimateJob;
+    std::thread estimateWorker;
+    QTimer estimateTimer;
+    std::unique_ptr<QProgressDialog> estimateDialog;
+    void cancelEstimate();
+
+    // 偏置估计结果审阅：勾选的建议值写入输入框并走正常保存流程，返回是否已应用
+    bool reviewBiasEstimates(const BiasEstimator::Result& result, const QString& source, size_t malformedLines);
+
 
     double q_xsense_data_roll = 0.0;
     double q_xsense_data_pitch = 0.0;
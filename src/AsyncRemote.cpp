@@ -0,0 +1,551 @@
+#include "AsyncRemote.h"
+
+#ifdef ADJUSTBIAS_HAS_COROUTINES
+
+#include "ConfigReader.h"
+#include "Exceptions.h"
+#include "FileHandler.h"
+#include "SSHManager.h"
+#include <ws2tcpip.h>
+#include <QDebug>
+#include <algorithm>
+#include <unordered_set>
+
+namespace {
+
+// 没有任何等待到期时 WSAPoll 的最长等待；新增等待会立即唤醒事件线程
+constexpr int kMaxWaitMs = 5000;
+constexpr size_t kChunkSize = 32 * 1024;
+
+std::string lastError(LIBSSH2_SESSION* session) {
+    char* message = nullptr;
+    libssh2_session_last_error(session, &message, nullptr, 0);
+    return message ? message : "";
+}
+
+} // namespace
+
+// ===== 调度器 =====
+
+AsyncLoop::AsyncLoop(int threads, int blockingThreads) {
+    WSADATA wsadata;
+    if (WSAStartup(MAKEWORD(2, 2), &wsadata)) {
+        throw NetworkException("WSAStartup failed: " + std::to_string(WSAGetLastError()));
+    }
+
+    // 与 SessionReactor 相同的唤醒方式：连接到自身的回环 UDP socket
+    wakeSocket = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    socklen_t len = sizeof(addr);
+    u_long nonBlocking = 1;
+    if (wakeSocket == INVALID_SOCKET ||
+        bind(wakeSocket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        getsockname(wakeSocket, reinterpret_cast<sockaddr*>(&addr), &len) != 0 ||
+        connect(wakeSocket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ioctlsocket(wakeSocket, FIONBIO, &nonBlocking) != 0) {
+        const int error = WSAGetLastError();
+        if (wakeSocket != INVALID_SOCKET) {
+            closesocket(wakeSocket);
+        }
+        WSACleanup();
+        throw NetworkException("Async loop wakeup socket failed: " + std::to_string(error));
+    }
+
+    pollThread = std::thread(&AsyncLoop::pollLoop, this);
+    for (int i = 0; i < (threads > 0 ? threads : 1); ++i) {
+        workers.emplace_back(&AsyncLoop::workerLoop, this);
+    }
+    for (int i = 0; i < (blockingThreads > 0 ? blockingThreads : 1); ++i) {
+        blockingWorkers.emplace_back(&AsyncLoop::blockingLoop, this);
+    }
+}
+
+AsyncLoop::~AsyncLoop() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    readyCV.notify_all();
+    blockingCV.notify_all();
+    wake();
+    pollThread.join();
+    for (auto& t : workers) {
+        t.join();
+    }
+    for (auto& t : blockingWorkers) {
+        t.join();
+    }
+    closesocket(wakeSocket);
+    WSACleanup();
+}
+
+AsyncLoop::Detached AsyncLoop::detach(AsyncLoop* loop, AsyncTask<void> task) {
+    try {
+        co_await std::move(task);
+    } catch (const std::exception& e) {
+        qDebug() << "协程任务异常结束:" << e.what();
+    } catch (...) {
+        qDebug() << "协程任务异常结束";
+    }
+    std::lock_guard<std::mutex> lock(loop->mutex);
+    if (--loop->outstanding == 0) {
+        loop->idleCV.notify_all();
+    }
+}
+
+void AsyncLoop::spawn(AsyncTask<void> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++outstanding;
+    }
+    post(detach(this, std::move(task)).handle);
+}
+
+void AsyncLoop::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idleCV.wait(lock, [this]() { return outstanding == 0; });
+}
+
+void AsyncLoop::post(std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        readyQueue.push_back(handle);
+    }
+    readyCV.notify_one();
+}
+
+AsyncLoop::SocketAwaiter AsyncLoop::waitSocket(SOCKET sock, bool read, bool write, Clock::time_point deadline) {
+    short events = 0;
+    events |= read ? POLLRDNORM : 0;
+    events |= write ? POLLWRNORM : 0;
+    return SocketAwaiter{this, sock, events, deadline};
+}
+
+AsyncLoop::SocketAwaiter AsyncLoop::sleepFor(std::chrono::milliseconds duration) {
+    return SocketAwaiter{this, INVALID_SOCKET, 0, Clock::now() + duration};
+}
+
+void AsyncLoop::SocketAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    // 注册后协程可能立即在其他线程恢复（本对象随之失效），之后只使用局部变量
+    AsyncLoop* self = loop;
+    {
+        std::lock_guard<std::mutex> lock(self->mutex);
+        self->waiters.push_back(Waiter{sock, events, deadline, &ready, handle});
+        self->peakWaiters = (std::max)(self->peakWaiters, self->waiters.size());
+    }
+    self->wake();
+}
+
+void AsyncLoop::BlockingAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    AsyncLoop* self = loop;
+    std::function<void()> work = std::move(job);
+    {
+        std::lock_guard<std::mutex> lock(self->mutex);
+        self->blockingQueue.push_back([self, work, handle]() {
+            work();
+            self->post(handle);
+        });
+    }
+    self->blockingCV.notify_one();
+}
+
+void AsyncLoop::notifySocket(SOCKET sock) {
+    std::vector<std::coroutine_handle<>> resumed;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = std::remove_if(waiters.begin(), waiters.end(), [&](const Waiter& w) {
+            if (w.sock != sock) {
+                return false;
+            }
+            *w.ready = true;
+            resumed.push_back(w.handle);
+            return true;
+        });
+        if (it == waiters.end()) {
+            return;
+        }
+        waiters.erase(it, waiters.end());
+        readyQueue.insert(readyQueue.end(), resumed.begin(), resumed.end());
+    }
+    readyCV.notify_all();
+    wake();
+}
+
+AsyncLoop::Stats AsyncLoop::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats s;
+    s.threads = 1 + workers.size() + blockingWorkers.size();
+    s.pending = waiters.size();
+    s.peakPending = peakWaiters;
+    s.resumed = resumedCount;
+    return s;
+}
+
+void AsyncLoop::wake() {
+    const char byte = 0;
+    send(wakeSocket, &byte, 1, 0);
+}
+
+void AsyncLoop::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        readyCV.wait(lock, [this]() { return stopping || !readyQueue.empty(); });
+        if (readyQueue.empty()) {
+            return;
+        }
+        std::coroutine_handle<> handle = readyQueue.front();
+        readyQueue.pop_front();
+        ++resumedCount;
+        lock.unlock();
+        handle.resume();
+        lock.lock();
+    }
+}
+
+void AsyncLoop::blockingLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        blockingCV.wait(lock, [this]() { return stopping || !blockingQueue.empty(); });
+        if (blockingQueue.empty()) {
+            return;
+        }
+        std::function<void()> job = std::move(blockingQueue.front());
+        blockingQueue.pop_front();
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
+
+void AsyncLoop::pollLoop() {
+    std::vector<WSAPOLLFD> fds;
+    std::vector<size_t> owners;     // fds[i + 1] 对应的 waiters 下标（构建时的快照）
+    std::vector<Waiter> snapshot;
+
+    while (true) {
+        fds.clear();
+        owners.clear();
+        WSAPOLLFD wakeFd = {};
+        wakeFd.fd = wakeSocket;
+        wakeFd.events = POLLRDNORM;
+        fds.push_back(wakeFd);
+
+        auto deadline = Clock::now() + std::chrono::milliseconds(kMaxWaitMs);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) {
+                return;
+            }
+            snapshot = waiters;
+            for (size_t i = 0; i < snapshot.size(); ++i) {
+                deadline = (std::min)(deadline, snapshot[i].deadline);
+                if (snapshot[i].sock != INVALID_SOCKET) {
+                    WSAPOLLFD fd = {};
+                    fd.fd = snapshot[i].sock;
+                    fd.events = snapshot[i].events;
+                    fds.push_back(fd);
+                    owners.push_back(i);
+                }
+            }
+        }
+
+        // 向上取整到毫秒，避免最后不足 1 毫秒时以 0 超时空转
+        const auto waitMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - Clock::now() + std::chrono::microseconds(999)).count();
+        const int ready = WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), static_cast<int>(waitMs > 0 ? waitMs : 0));
+        if (ready > 0 && fds[0].revents) {
+            char buf[64];
+            while (recv(wakeSocket, buf, sizeof(buf), 0) > 0) {
+            }
+        }
+
+        // 按协程句柄匹配（等待期间 waiters 可能被 notifySocket 修改或追加）
+        std::unordered_set<void*> fired;
+        for (size_t i = 1; i < fds.size(); ++i) {
+            if (fds[i].revents) {
+                fired.insert(snapshot[owners[i - 1]].handle.address());
+            }
+        }
+        const auto now = Clock::now();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = std::remove_if(waiters.begin(), waiters.end(), [&](const Waiter& w) {
+                const bool isReady = fired.count(w.handle.address()) != 0;
+                if (!isReady && now < w.deadline) {
+                    return false;
+                }
+                *w.ready = isReady;
+                readyQueue.push_back(w.handle);
+                return true;
+            });
+            if (it == waiters.end()) {
+                continue;
+            }
+            waiters.erase(it, waiters.end());
+        }
+        readyCV.notify_all();
+    }
+}
+
+// ===== 会话上的远程操作 =====
+
+AsyncSession::AsyncSession(AsyncLoop& loop, SSHManager& ssh) : loop(loop), ssh(ssh) {}
+
+AsyncSession::~AsyncSession() {
+    if (sftp) {
+        auto lock = ssh.lockSession();
+        // 会话已重建时旧的 SFTP 句柄随旧会话释放
+        if (ssh.peekSession() == sftpSession) {
+            libssh2_sftp_shutdown(sftp);
+        }
+    }
+}
+
+AsyncTask<long long> AsyncSession::call(std::function<long long(LIBSSH2_SESSION*)> step,
+                                        AsyncLoop::Clock::time_point deadline, std::string context) {
+    while (true) {
+        long long rc;
+        int directions = 0;
+        SOCKET sock;
+        {
+            auto lock = ssh.lockSession();
+            LIBSSH2_SESSION* session = ssh.peekSession();
+            if (!session || !ssh.isSessionValid()) {
+                throw SSHSessionException(context + ": SSH 会话不可用");
+            }
+            const int wasBlocking = libssh2_session_get_blocking(session);
+            libssh2_session_set_blocking(session, 0);
+            rc = step(session);
+            directions = libssh2_session_block_directions(session);
+            const std::string error = rc < 0 && rc != LIBSSH2_ERROR_EAGAIN ? lastError(session) : std::string();
+            libssh2_session_set_blocking(session, wasBlocking);
+            sock = ssh.getSocket();
+            if (rc < 0 && rc != LIBSSH2_ERROR_EAGAIN) {
+                throw RemoteCommandException(context + ": " + error);
+            }
+        }
+        if (rc != LIBSSH2_ERROR_EAGAIN) {
+            // 这一步可能顺带读走了同一会话上其他操作的数据，让它们重试一次
+            loop.notifySocket(sock);
+            co_return rc;
+        }
+        if (AsyncLoop::Clock::now() >= deadline) {
+            throw RemoteCommandException(context + ": 操作超时");
+        }
+        const bool read = (directions & LIBSSH2_SESSION_BLOCK_INBOUND) || directions == 0;
+        const bool write = (directions & LIBSSH2_SESSION_BLOCK_OUTBOUND) != 0;
+        co_await loop.waitSocket(sock, read, write, deadline);
+    }
+}
+
+AsyncTask<long long> AsyncSession::exclusive(const void*& token, std::function<long long(LIBSSH2_SESSION*)> step,
+                                             AsyncLoop::Clock::time_point deadline, std::string context) {
+    const int marker = 0;
+    try {
+        co_return co_await call([&](LIBSSH2_SESSION* session) -> long long {
+            if (token && token != &marker) {
+                return LIBSSH2_ERROR_EAGAIN;   // 持有者完成时 call 会 notifySocket 唤醒这里
+            }
+            token = &marker;
+            const long long rc = step(session);
+            if (rc != LIBSSH2_ERROR_EAGAIN) {
+                token = nullptr;
+            }
+            return rc;
+        }, deadline, std::move(context));
+    } catch (...) {
+        // 超时或会话失效：放弃进行中的打开，让等待的操作继续
+        auto lock = ssh.lockSession();
+        if (token == &marker) {
+            token = nullptr;
+        }
+        throw;
+    }
+}
+
+AsyncTask<AsyncSession::ExecResult> AsyncSession::exec(std::string command, std::string input, int timeoutMs) {
+    const auto deadline = AsyncLoop::Clock::now() + std::chrono::milliseconds(timeoutMs);
+    ExecResult result;
+    LIBSSH2_CHANNEL* channel = nullptr;
+
+    co_await exclusive(channelOpener, [&](LIBSSH2_SESSION* session) -> long long {
+        channel = libssh2_channel_open_session(session);
+        return channel ? 0 : libssh2_session_last_errno(session);
+    }, deadline, "打开通道失败");
+
+    std::exception_ptr error;
+    try {
+        co_await call([&](LIBSSH2_SESSION*) -> long long {
+            return libssh2_channel_exec(channel, command.c_str());
+        }, deadline, "执行命令失败");
+
+        for (size_t sent = 0; sent < input.size();) {
+            sent += static_cast<size_t>(co_await call([&](LIBSSH2_SESSION*) -> long long {
+                return libssh2_channel_write(channel, input.data() + sent, (std::min)(kChunkSize, input.size() - sent));
+            }, deadline, "写入标准输入失败"));
+        }
+        co_await call([&](LIBSSH2_SESSION*) -> long long {
+            return libssh2_channel_send_eof(channel);
+        }, deadline, "发送 EOF 失败");
+
+        // stdout / stderr 在同一步中读取，任一方向的窗口都不会因为另一方向未读而停滞
+        std::vector<char> buffer(kChunkSize);
+        while (co_await call([&](LIBSSH2_SESSION*) -> long long {
+            long long total = 0;
+            ssize_t n;
+            while ((n = libssh2_channel_read(channel, buffer.data(), buffer.size())) > 0) {
+                result.output.append(buffer.data(), static_cast<size_t>(n));
+                total += n;
+            }
+            if (n < 0 && n != LIBSSH2_ERROR_EAGAIN) {
+                return n;
+            }
+            while ((n = libssh2_channel_read_stderr(channel, buffer.data(), buffer.size())) > 0) {
+                result.error.append(buffer.data(), static_cast<size_t>(n));
+                total += n;
+            }
+            if (n < 0 && n != LIBSSH2_ERROR_EAGAIN) {
+                return n;
+            }
+            if (total > 0) {
+                return total;
+            }
+            return libssh2_channel_eof(channel) ? 0 : LIBSSH2_ERROR_EAGAIN;
+        }, deadline, "读取输出失败") > 0) {
+        }
+
+        co_await call([&](LIBSSH2_SESSION*) -> long long {
+            return libssh2_channel_close(channel);
+        }, deadline, "关闭通道失败");
+        result.exitCode = libssh2_channel_get_exit_status(channel);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    // 通道在任何情况下都要释放；释放失败（会话已断开）不掩盖原来的错误
+    try {
+        co_await call([&](LIBSSH2_SESSION*) -> long long {
+            return libssh2_channel_free(channel);
+        }, AsyncLoop::Clock::now() + std::chrono::seconds(2), "释放通道失败");
+    } catch (...) {
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    co_return result;
+}
+
+AsyncTask<std::string> AsyncSession::readFile(std::string path, int timeoutMs) {
+    const auto deadline = AsyncLoop::Clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    // SFTP 子系统只启动一次；启动期间其他操作等待（libssh2_sftp_init 的非阻塞状态保存在会话中，不能交错调用）
+    const int marker = 0;
+    try {
+        co_await call([&](LIBSSH2_SESSION* session) -> long long {
+            if (sftp && sftpSession == session) {
+                return 0;
+            }
+            if (sftpStarter && sftpStarter != &marker) {
+                return LIBSSH2_ERROR_EAGAIN;
+            }
+            sftpStarter = &marker;
+            LIBSSH2_SFTP* started = libssh2_sftp_init(session);
+            if (!started) {
+                const int rc = libssh2_session_last_errno(session);
+                if (rc != LIBSSH2_ERROR_EAGAIN) {
+                    sftpStarter = nullptr;
+                }
+                return rc;
+            }
+            sftp = started;
+            sftpSession = session;
+            sftpStarter = nullptr;
+            return 0;
+        }, deadline, "启动 SFTP 失败");
+    } catch (...) {
+        auto lock = ssh.lockSession();
+        if (sftpStarter == &marker) {
+            sftpStarter = nullptr;
+        }
+        throw;
+    }
+
+    LIBSSH2_SFTP_HANDLE* handle = nullptr;
+    co_await exclusive(fileOpener, [&](LIBSSH2_SESSION* session) -> long long {
+        handle = libssh2_sftp_open(sftp, path.c_str(), LIBSSH2_FXF_READ, 0);
+        return handle ? 0 : libssh2_session_last_errno(session);
+    }, deadline, "打开远端文件失败 " + path);
+
+    std::string content;
+    std::exception_ptr error;
+    try {
+        std::vector<char> buffer(kChunkSize);
+        while (co_await call([&](LIBSSH2_SESSION*) -> long long {
+            const ssize_t n = libssh2_sftp_read(handle, buffer.data(), buffer.size());
+            if (n > 0) {
+                content.append(buffer.data(), static_cast<size_t>(n));
+            }
+            return n;
+        }, deadline, "读取远端文件失败") > 0) {
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+    try {
+        co_await call([&](LIBSSH2_SESSION*) -> long long {
+            return libssh2_sftp_close_handle(handle);
+        }, AsyncLoop::Clock::now() + std::chrono::seconds(2), "关闭远端文件失败");
+    } catch (...) {
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    co_return content;
+}
+
+// ===== 配置文件的协程版本 =====
+
+AsyncTask<std::map<std::string, double>> AsyncConfig::load(AsyncSession& session, std::string path, int timeoutMs) {
+    const AsyncSession::ExecResult r =
+        co_await session.exec("cat -- " + FileHandler::shellQuote(path), std::string(), timeoutMs);
+    if (r.exitCode != 0) {
+        throw RemoteCommandException("读取配置文件失败: " + r.error);
+    }
+    ConfigReader parser(nullptr, path);
+    std::string deduped;
+    if (!parser.parseConfigContent(r.output, deduped)) {
+        throw ConfigException("配置文件解析失败: " + path);
+    }
+    co_return parser.parsedValues;
+}
+
+AsyncTask<AsyncConfig::WriteResult> AsyncConfig::writeParameters(AsyncSession& session, std::string path,
+                                                                 std::vector<std::pair<std::string, double>> params,
+                                                                 int timeoutMs) {
+    WriteResult result;
+    const AsyncSession::ExecResult current =
+        co_await session.exec("cat -- " + FileHandler::shellQuote(path), std::string(), timeoutMs);
+    if (current.exitCode != 0 || current.output.empty()) {
+        throw RemoteCommandException("读取配置文件失败: " + current.error);
+    }
+    result.baseline = current.output;
+    result.content = ConfigReader::applyParameterEdits(result.baseline, params);
+
+    // 与 ConfigReader::atomicWriteRemoteImpl 相同：同目录临时文件 + mv，失败时删除临时文件
+    const std::string tmpPath =
+        path + ".tmp." + std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+    const std::string quotedTmp = FileHandler::shellQuote(tmpPath);
+    const AsyncSession::ExecResult written = co_await session.exec(
+        "cat > " + quotedTmp + " && mv -f -- " + quotedTmp + " " + FileHandler::shellQuote(path) +
+            " || { rm -f -- " + quotedTmp + "; exit 1; }",
+        result.content, timeoutMs);
+    if (written.exitCode != 0) {
+        throw RemoteCommandException("写入配置文件失败: " + written.error);
+    }
+    co_return result;
+}
+
+#endif
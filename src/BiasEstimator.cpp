@@ -0,0 +1,380 @@
+#include "BiasEstimator.h"
+#include "DriftLogStore.h"
+#include "Exceptions.h"
+#include "MappedFile.h"
+#include "TelemetryParser.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr int kMaxFields = 64;
+
+enum Column { Vx = 0, Vy, Wz, CmdVx, CmdVy, CmdWz, Gait, ColumnCount };
+
+int columnForName(std::string name) {
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    static const struct {
+        const char* name;
+        int column;
+    } aliases[] = {
+        {"vx", Vx}, {"x_vel", Vx}, {"vel_x", Vx},
+        {"vy", Vy}, {"y_vel", Vy}, {"vel_y", Vy},
+        {"wz", Wz}, {"yaw_rate", Wz}, {"yaw_vel", Wz}, {"vyaw", Wz},
+        {"cmd_vx", CmdVx}, {"vx_cmd", CmdVx}, {"cmd_x_vel", CmdVx},
+        {"cmd_vy", CmdVy}, {"vy_cmd", CmdVy}, {"cmd_y_vel", CmdVy},
+        {"cmd_wz", CmdWz}, {"wz_cmd", CmdWz}, {"cmd_yaw_rate", CmdWz}, {"cmd_yaw_vel", CmdWz},
+        {"gait", Gait}, {"mode", Gait},
+    };
+    for (const auto& alias : aliases) {
+        if (name == alias.name) {
+            return alias.column;
+        }
+    }
+    return -1;
+}
+
+bool parseGait(std::string_view field, uint8_t& run) {
+    if (field == "run" || field == "RUN" || field == "1") {
+        run = 1;
+        return true;
+    }
+    if (field == "walk" || field == "WALK" || field == "0") {
+        run = 0;
+        return true;
+    }
+    return false;
+}
+
+// 一组样本的一阶、二阶矩
+struct Moments {
+    double n = 0.0;
+    double sx = 0.0;
+    double sy = 0.0;
+    double sxx = 0.0;
+    double sxy = 0.0;
+};
+
+// 在连续数组上累加矩；4 路独立累加器打断加法依赖链，编译器可以打包成 SIMD 指令。x 为空表示没有指令列
+Moments accumulate(const double* x, const double* y, size_t n) {
+    double sx[4] = {};
+    double sy[4] = {};
+    double sxx[4] = {};
+    double sxy[4] = {};
+    size_t i = 0;
+    if (x) {
+        for (; i + 4 <= n; i += 4) {
+            for (int lane = 0; lane < 4; ++lane) {
+                const double xv = x[i + lane];
+                const double yv = y[i + lane];
+                sx[lane] += xv;
+                sy[lane] += yv;
+                sxx[lane] += xv * xv;
+                sxy[lane] += xv * yv;
+            }
+        }
+        for (; i < n; ++i) {
+            sx[0] += x[i];
+            sy[0] += y[i];
+            sxx[0] += x[i] * x[i];
+            sxy[0] += x[i] * y[i];
+        }
+    } else {
+        for (; i + 4 <= n; i += 4) {
+            for (int lane = 0; lane < 4; ++lane) {
+                sy[lane] += y[i + lane];
+            }
+        }
+        for (; i < n; ++i) {
+            sy[0] += y[i];
+        }
+    }
+
+    Moments m;
+    m.n = static_cast<double>(n);
+    m.sx = (sx[0] + sx[1]) + (sx[2] + sx[3]);
+    m.sy = (sy[0] + sy[1]) + (sy[2] + sy[3]);
+    m.sxx = (sxx[0] + sxx[1]) + (sxx[2] + sxx[3]);
+    m.sxy = (sxy[0] + sxy[1]) + (sxy[2] + sxy[3]);
+    return m;
+}
+
+// 最小二乘斜率；指令速度几乎不变（例如全程原地踏步）时无法辨识增益，返回 0
+double solveGain(const Moments& m) {
+    const double mx = m.sx / m.n;
+    const double cxx = m.sxx - m.n * mx * mx;
+    const double cxy = m.sxy - mx * m.sy;
+    return cxx > 1e-9 * m.n ? cxy / cxx : 0.0;
+}
+
+// 双侧 95% 的 t 分位数
+double tQuantile975(size_t df) {
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                   2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                   2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (df >= 1 && df <= 30) {
+        return table[df - 1];
+    }
+    return 1.960 + 2.37 / static_cast<double>(df);   // Cornish-Fisher 一阶近似
+}
+
+// 一个步态下各轴的连续数组（无步态列时直接指向日志本身，不拷贝）
+struct GaitColumns {
+    const double* y[3] = {};
+    const double* x[3] = {};
+    size_t n = 0;
+    std::vector<double> storage[6];
+};
+
+void selectGait(const DriftLog& log, uint8_t gait, GaitColumns& out) {
+    const std::vector<double>* sources[6] = {&log.vx, &log.vy, &log.wz, &log.cmdVx, &log.cmdVy, &log.cmdWz};
+    const int columns = log.hasCommand() ? 6 : 3;
+    if (!log.hasGait()) {
+        out.n = gait == 0 ? log.size() : 0;
+        for (int c = 0; c < columns; ++c) {
+            (c < 3 ? out.y[c] : out.x[c - 3]) = sources[c]->data();
+        }
+        return;
+    }
+
+    const size_t n = static_cast<size_t>(std::count(log.run.begin(), log.run.end(), gait));
+    for (int c = 0; c < columns; ++c) {
+        std::vector<double>& dst = out.storage[c];
+        dst.reserve(n);
+        const std::vector<double>& src = *sources[c];
+        for (size_t i = 0; i < log.size(); ++i) {
+            if (log.run[i] == gait) {
+                dst.push_back(src[i]);
+            }
+        }
+        (c < 3 ? out.y[c] : out.x[c - 3]) = dst.data();
+    }
+    out.n = n;
+}
+
+} // namespace
+
+// ===== 漂移日志解析 =====
+
+DriftLog DriftLog::parse(const char* data, size_t len) {
+    const char* cursor = data;
+    const char* end = data + len;
+    std::string_view fields[kMaxFields];
+
+    auto nextLine = [&](std::string_view& line) {
+        if (cursor >= end) {
+            return false;
+        }
+        const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+        const char* lineEnd = newline ? newline : end;
+        line = std::string_view(cursor, static_cast<size_t>(lineEnd - cursor));
+        cursor = newline ? newline + 1 : end;
+        return true;
+    };
+
+    // 表头：第一个非空行
+    std::string_view line;
+    int count = 0;
+    while (nextLine(line) && (count = TelemetryLineParser::split(line, fields, kMaxFields)) == 0) {
+    }
+    int columns[ColumnCount];
+    std::fill(std::begin(columns), std::end(columns), -1);
+    for (int i = 0; i < count; ++i) {
+        const int column = columnForName(std::string(fields[i]));
+        if (column >= 0 && columns[column] < 0) {
+            columns[column] = i;
+        }
+    }
+    if (columns[Vx] < 0 || columns[Vy] < 0 || columns[Wz] < 0) {
+        throw ConfigException("漂移日志缺少表头或 vx / vy / wz 列");
+    }
+    const bool hasCommand = columns[CmdVx] >= 0 || columns[CmdVy] >= 0 || columns[CmdWz] >= 0;
+    const bool hasGait = columns[Gait] >= 0;
+
+    DriftLog log;
+    const size_t estimatedLines = len / 32 + 1;
+    for (auto* v : {&log.vx, &log.vy, &log.wz}) {
+        v->reserve(estimatedLines);
+    }
+    if (hasCommand) {
+        for (auto* v : {&log.cmdVx, &log.cmdVy, &log.cmdWz}) {
+            v->reserve(estimatedLines);
+        }
+    }
+    if (hasGait) {
+        log.run.reserve(estimatedLines);
+    }
+
+    while (nextLine(line)) {
+        count = TelemetryLineParser::split(line, fields, kMaxFields);
+        if (count == 0) {
+            continue;
+        }
+        double values[Gait] = {};
+        uint8_t run = 0;
+        bool ok = true;
+        for (int c = 0; c < Gait && ok; ++c) {
+            if (columns[c] >= 0) {
+                ok = columns[c] < count && TelemetryLineParser::parseNumber(fields[columns[c]], values[c]);
+            }
+        }
+        if (ok && hasGait) {
+            ok = columns[Gait] < count && parseGait(fields[columns[Gait]], run);
+        }
+        if (!ok) {
+            ++log.malformedLines;
+            continue;
+        }
+
+        log.vx.push_back(values[Vx]);
+        log.vy.push_back(values[Vy]);
+        log.wz.push_back(values[Wz]);
+        if (hasCommand) {
+            log.cmdVx.push_back(values[CmdVx]);
+            log.cmdVy.push_back(values[CmdVy]);
+            log.cmdWz.push_back(values[CmdWz]);
+        }
+        if (hasGait) {
+            log.run.push_back(run);
+        }
+    }
+    return log;
+}
+
+DriftLog DriftLog::loadFile(const std::string& path) {
+    // 直接在映射的文件内容上解析，不再整体读入内存
+    MappedFile file = MappedFile::open(path);
+    return parse(file.data() ? file.data() : "", file.size());
+}
+
+DriftLog DriftLog::fromStore(const DriftLogStore& store) {
+    const float* columns[ColumnCount] = {};
+    for (const std::string& name : store.channels()) {
+        const int column = columnForName(name);
+        if (column >= 0 && !columns[column]) {
+            columns[column] = store.channel(name);
+        }
+    }
+    if (!columns[Vx] || !columns[Vy] || !columns[Wz]) {
+        throw ConfigException("分析文件缺少 vx / vy / wz 通道");
+    }
+    const bool hasCommand = columns[CmdVx] || columns[CmdVy] || columns[CmdWz];
+    const bool hasGait = columns[Gait] != nullptr;
+
+    DriftLog log;
+    log.malformedLines = store.malformedLines();
+    const size_t rows = store.rows();
+    for (auto* v : {&log.vx, &log.vy, &log.wz}) {
+        v->reserve(rows);
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        double values[Gait] = {};
+        bool ok = true;
+        for (int c = 0; c < Gait && ok; ++c) {
+            if (columns[c]) {
+                values[c] = columns[c][i];
+                ok = !std::isnan(values[c]);
+            }
+        }
+        if (ok && hasGait) {
+            ok = columns[Gait][i] == 0.0f || columns[Gait][i] == 1.0f;
+        }
+        if (!ok) {
+            ++log.malformedLines;
+            continue;
+        }
+
+        log.vx.push_back(values[Vx]);
+        log.vy.push_back(values[Vy]);
+        log.wz.push_back(values[Wz]);
+        if (hasCommand) {
+            log.cmdVx.push_back(values[CmdVx]);
+            log.cmdVy.push_back(values[CmdVy]);
+            log.cmdWz.push_back(values[CmdWz]);
+        }
+        if (hasGait) {
+            log.run.push_back(static_cast<uint8_t>(columns[Gait][i]));
+        }
+    }
+    return log;
+}
+
+// ===== 批量求解 =====
+
+BiasEstimator::Result BiasEstimator::estimate(const DriftLog& log, const std::map<std::string, double>& current) {
+    return estimate(log, current, Options());
+}
+
+BiasEstimator::Result BiasEstimator::estimate(const DriftLog& log, const std::map<std::string, double>& current,
+                                              const Options& options) {
+    static const char* const kParams[2][3] = {
+        {"x_vel_offset", "y_vel_offset", "yaw_vel_offset"},
+        {"x_vel_offset_run", "y_vel_offset_run", "yaw_vel_offset_run"},
+    };
+
+    const auto started = std::chrono::steady_clock::now();
+    Result result;
+    result.samples = log.size();
+
+    for (uint8_t gait = 0; gait < 2; ++gait) {
+        GaitColumns data;
+        selectGait(log, gait, data);
+
+        const size_t batches = std::min(options.batches, data.n / std::max<size_t>(1, options.minSamplesPerBatch));
+        for (int axis = 0; axis < 3; ++axis) {
+            Estimate est;
+            est.param = kParams[gait][axis];
+            auto it = current.find(est.param);
+            est.current = it != current.end() ? it->second : 0.0;
+            est.samples = data.n;
+
+            if (batches < 2) {
+                est.proposed = est.current;
+                est.note = data.n == 0 ? "日志中没有该步态的样本" : "样本不足，无法估计";
+                result.estimates.push_back(est);
+                continue;
+            }
+
+            // 各批的矩；整体矩由批矩相加得到，不需要再遍历一次
+            std::vector<Moments> batchMoments(batches);
+            Moments total;
+            for (size_t b = 0; b < batches; ++b) {
+                const size_t begin = data.n * b / batches;
+                const size_t end = data.n * (b + 1) / batches;
+                const double* x = data.x[axis] ? data.x[axis] + begin : nullptr;
+                batchMoments[b] = accumulate(x, data.y[axis] + begin, end - begin);
+                total.n += batchMoments[b].n;
+                total.sx += batchMoments[b].sx;
+                total.sy += batchMoments[b].sy;
+                total.sxx += batchMoments[b].sxx;
+                total.sxy += batchMoments[b].sxy;
+            }
+
+            // 增益用全部样本估计，各批共用，批间差异只反映漂移本身的波动
+            est.gain = solveGain(total);
+            est.drift = (total.sy - est.gain * total.sx) / total.n;
+
+            double mean = 0.0;
+            double m2 = 0.0;
+            for (size_t b = 0; b < batches; ++b) {
+                const Moments& m = batchMoments[b];
+                const double drift = (m.sy - est.gain * m.sx) / m.n;
+                const double delta = drift - mean;
+                mean += delta / static_cast<double>(b + 1);
+                m2 += delta * (drift - mean);
+            }
+            const double stddev = std::sqrt(m2 / static_cast<double>(batches - 1));
+            est.ci95 = tQuantile975(batches - 1) * stddev / std::sqrt(static_cast<double>(batches));
+
+            est.proposed = est.current - est.drift;
+            est.valid = true;
+            result.estimates.push_back(est);
+        }
+    }
+
+    result.solveMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    return result;
+}
@@ -0,0 +1,157 @@
+#include "ConfigNotifier.h"
+#include "FileHandler.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace {
+
+const char* kOkMarker = "__adjustbias_notify_ok__";
+
+// 执行通知命令：命令末尾追加成功标记，输出中没有标记即视为失败，其余输出作为错误原因
+bool runNotifyCommand(const IConfigNotifier::CommandRunner& run, const std::string& command, std::string& error) {
+    std::string output = run("{ " + command + "; } 2>&1 && echo " + kOkMarker);
+    if (output.find(kOkMarker) != std::string::npos) {
+        return true;
+    }
+    while (!output.empty() && (output.back() == '\n' || output.back() == '\r')) {
+        output.pop_back();
+    }
+    error = output.empty() ? "通知命令执行失败" : output;
+    return false;
+}
+
+// 发出通知并轮询 ack 文件，全部在一个子 shell 中完成（exit 不会影响常驻代理的 shell）：
+// 记下通知前的重新加载次数，之后每 100ms 读一次，次数变化且 sha256 与当前配置一致即为确认
+std::string ackCommand(const std::string& notifyCommand, const std::string& configPath, const std::string& ackFile) {
+    const int polls = IConfigNotifier::kAckTimeoutMs / 100;
+    return "( a=" + FileHandler::shellQuote(ackFile) + "; f=" + FileHandler::shellQuote(configPath) + "\n"
+           "want=$(sha256sum < \"$f\" | cut -d' ' -f1)\n"
+           "[ -n \"$want\" ] || { echo \"cannot hash $f\"; exit 1; }\n"
+           "before=; { read -r before rest < \"$a\"; } 2>/dev/null\n"
+           "{ " + notifyCommand + "; } || exit 1\n"
+           "n=0\n"
+           "while :; do\n"
+           "  g=; h=; { read -r g h < \"$a\"; } 2>/dev/null\n"
+           "  [ -n \"$g\" ] && [ \"$g\" != \"$before\" ] && [ \"$h\" = \"$want\" ] && exit 0\n"
+           "  n=$((n + 1)); [ \"$n\" -ge " + std::to_string(polls) + " ] && "
+           "{ echo \"controller did not acknowledge reload within " + std::to_string(IConfigNotifier::kAckTimeoutMs) +
+           "ms ($a: ${g:-empty} ${h:-})\"; exit 1; }\n"
+           "  sleep 0.1\n"
+           "done )";
+}
+
+bool isSignalName(const std::string& name) {
+    return !name.empty() && std::all_of(name.begin(), name.end(), [](unsigned char c) {
+        return std::isupper(c) || std::isdigit(c);
+    });
+}
+
+} // namespace
+
+// ===== 通知 + 确认 =====
+
+bool IConfigNotifier::notify(const CommandRunner& run, const std::string& configPath, std::string& error) {
+    return runNotifyCommand(run, ackCommand(notifyCommand(configPath), configPath, ackFile), error);
+}
+
+std::string IConfigNotifier::describe() const {
+    return channel() + ",ack=" + ackFile;
+}
+
+// ===== 信号通知 =====
+
+SignalConfigNotifier::SignalConfigNotifier(const std::string& pidFile, const std::string& ackFile,
+                                           const std::string& signal)
+    : IConfigNotifier(ackFile), pidFile(pidFile), signal(signal) {}
+
+std::string SignalConfigNotifier::notifyCommand(const std::string& /*configPath*/) const {
+    return "pid=$(cat -- " + FileHandler::shellQuote(pidFile) + ") && [ -n \"$pid\" ] && kill -" + signal + " \"$pid\"";
+}
+
+std::string SignalConfigNotifier::channel() const {
+    return "signal:" + pidFile + ":" + signal;
+}
+
+// ===== FIFO 通知 =====
+
+FifoConfigNotifier::FifoConfigNotifier(const std::string& fifoPath, const std::string& ackFile)
+    : IConfigNotifier(ackFile), fifoPath(fifoPath) {}
+
+std::string FifoConfigNotifier::notifyCommand(const std::string& configPath) const {
+    // 打开 FIFO 写端会一直阻塞到有读端，用 timeout 限制在 1 秒内
+    const std::string quotedFifo = FileHandler::shellQuote(fifoPath);
+    return "[ -p " + quotedFifo + " ] || { echo 'not a fifo: '" + quotedFifo + "; false; } && "
+        "{ timeout 1 sh -c 'printf \"reload %s\\n\" \"$1\" > \"$2\"' _ " +
+        FileHandler::shellQuote(configPath) + " " + quotedFifo + " || { echo 'no reader on fifo'; false; }; }";
+}
+
+std::string FifoConfigNotifier::channel() const {
+    return "fifo:" + fifoPath;
+}
+
+// ===== UDP 通知 =====
+
+UdpConfigNotifier::UdpConfigNotifier(int port, const std::string& ackFile, const std::string& host)
+    : IConfigNotifier(ackFile), port(port), host(host) {}
+
+std::string UdpConfigNotifier::notifyCommand(const std::string& configPath) const {
+    // bash 的 /dev/udp 重定向不依赖 nc 等额外工具；数据报发出不代表控制器收到，由 ack 确认
+    return "bash -c 'printf \"reload %s\\n\" \"$1\" > \"/dev/udp/$2/$3\"' _ " + FileHandler::shellQuote(configPath) + " " +
+        FileHandler::shellQuote(host) + " " + std::to_string(port);
+}
+
+std::string UdpConfigNotifier::channel() const {
+    return "udp:" + std::to_string(port) + ":" + host;
+}
+
+// ===== 工厂 =====
+
+std::unique_ptr<IConfigNotifier> IConfigNotifier::fromSpec(const std::string& fullSpec) {
+    // 没有确认通道就无法判断是否生效，缺少 ",ack=<文件>" 视为格式错误
+    const size_t ackSep = fullSpec.rfind(",ack=");
+    if (ackSep == std::string::npos || ackSep + 5 >= fullSpec.size()) {
+        return nullptr;
+    }
+    const std::string ackFile = fullSpec.substr(ackSep + 5);
+    const std::string spec = fullSpec.substr(0, ackSep);
+
+    const size_t colon = spec.find(':');
+    if (colon == std::string::npos || colon + 1 >= spec.size()) {
+        return nullptr;
+    }
+    const std::string kind = spec.substr(0, colon);
+    const std::string rest = spec.substr(colon + 1);
+
+    if (kind == "signal") {
+        // 路径本身不含冒号时，最后一段全大写/数字视为信号名
+        const size_t last = rest.rfind(':');
+        if (last != std::string::npos && isSignalName(rest.substr(last + 1))) {
+            return std::make_unique<SignalConfigNotifier>(rest.substr(0, last), ackFile, rest.substr(last + 1));
+        }
+        return std::make_unique<SignalConfigNotifier>(rest, ackFile);
+    }
+    if (kind == "fifo") {
+        return std::make_unique<FifoConfigNotifier>(rest, ackFile);
+    }
+    if (kind == "udp") {
+        const size_t hostSep = rest.find(':');
+        int port = std::atoi(rest.substr(0, hostSep).c_str());
+        if (port <= 0 || port > 65535) {
+            return nullptr;
+        }
+        if (hostSep != std::string::npos && hostSep + 1 < rest.size()) {
+            return std::make_unique<UdpConfigNotifier>(port, ackFile, rest.substr(hostSep + 1));
+        }
+        return std::make_unique<UdpConfigNotifier>(port, ackFile);
+    }
+    return nullptr;
+}
+
+std::unique_ptr<IConfigNotifier> IConfigNotifier::fromEnvironment() {
+    const char* spec = std::getenv("ADJUSTBIAS_CONFIG_NOTIFY");
+    if (!spec || !*spec) {
+        return nullptr;
+    }
+    return fromSpec(spec);
+}
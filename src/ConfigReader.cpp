@@ -1,31 +1,17 @@
  
 #include "ConfigReader.h"
+#include "FileHandler.h"
+#include "RemoteAgent.h"
+#include "RetryPolicy.h"
 #include <QDebug>
 #include <unordered_map>
+#include <algorithm>
 
-// base64 encoder helper
-static std::string base64_encode(const std::string &in) {
-    static const char *b64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-    std::string out;
-    int val = 0, valb = -6;
-    for (unsigned char c : in) {
-        val = (val << 8) + c;
-        valb += 8;
-        while (valb >= 0) {
-            out.push_back(b64_chars[(val >> valb) & 0x3F]);
-            valb -= 6;
-        }
-    }
-    if (valb > -6) out.push_back(b64_chars[((val << 8) >> (valb + 8)) & 0x3F]);
-    while (out.size() % 4) out.push_back('=');
-    return out;
-}
-
-// 确保字符串以单个换行符结尾（如果字符串非空），用于保证文件最后一行保留换行符
-static void ensure_single_trailing_newline(std::string &s) {
-    if (s.empty()) return;
-    while (!s.empty() && s.back() == '\n') s.pop_back();
-    s.push_back('\n');
+// 去掉末尾所有换行后的长度；写入时再补一个换行，保证文件最后一行有且仅有一个换行符（不复制内容）
+static size_t length_without_trailing_newlines(const std::string &s) {
+    size_t len = s.size();
+    while (len > 0 && s[len - 1] == '\n') --len;
+    return len;
 }
 
 // ===== Optimization #3: Initialize parameter map for O(1) lookup =====
@@ -56,6 +42,62 @@ bool ConfigReader::validateConfigFile(const std::string& filePath) {
 }
         
 bool ConfigReader::atomicWriteRemoteFile(const std::string& content) {
+    // 代理模式：一次帧往返完成 写临时文件 + mv。保存在工作线程中执行，与遥测 / 实时调节共用会话，须持有会话锁
+    if (sshManager) {
+        auto sessionLock = sshManager->lockSession();
+        if (RemoteAgent* agent = sshManager->getRemoteAgent()) {
+            try {
+                std::string normalized;
+                if (!content.empty()) {
+                    normalized.reserve(content.size() + 1);
+                    normalized.append(content, 0, length_without_trailing_newlines(content));
+                    normalized += '\n';
+                }
+                agent->atomicWrite(configPath, normalized);
+                return true;
+            } catch (const RemoteCommandException& e) {
+                std::cerr << "写入远端文件失败: " << e.what() << std::endl;
+                return false;
+            } catch (const std::exception& e) {
+                qDebug() << "远端代理写入失败，回退到通道写入:" << e.what();
+            }
+        }
+    }
+
+    return atomicWriteRemoteImpl([&content](RemoteCommandExecutor& writer) {
+        if (content.empty()) {
+            return;
+        }
+        // 保证末尾有且仅有一个换行
+        const size_t len = length_without_trailing_newlines(content);
+        for (size_t offset = 0; offset < len; offset += kRemoteWriteChunkSize) {
+            writer.writeInput(content.data() + offset, std::min(kRemoteWriteChunkSize, len - offset));
+        }
+        writer.writeInput("\n", 1);
+    });
+}
+
+bool ConfigReader::atomicWriteRemoteStream(std::istream& in) {
+    return atomicWriteRemoteImpl([&in](RemoteCommandExecutor& writer) {
+        std::vector<char> chunk(kRemoteWriteChunkSize);
+        while (in) {
+            in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            std::streamsize got = in.gcount();
+            if (got > 0) {
+                writer.writeInput(chunk.data(), static_cast<size_t>(got));
+            }
+        }
+        if (in.bad()) {
+            throw std::runtime_error("读取本地数据失败");
+        }
+    });
+}
+
+// ===== 流式原子写入 =====
+// 远端执行 `cat > tmp`，内容按固定大小的块写入通道 stdin（不经过命令行，因此不受 ARG_MAX 限制，
+// 也不需要 base64/heredoc 转义）；发送 EOF 并确认 cat 退出码为 0 后再 mv 覆盖目标文件。
+// 通道不使用 PTY，字节原样到达文件。
+bool ConfigReader::atomicWriteRemoteImpl(const std::function<void(RemoteCommandExecutor&)>& produce) {
     if (!sshManager) {
         std::cerr << "错误: SSH管理器未初始化，无法写入文件" << std::endl;
         return false;
@@ -68,55 +110,38 @@ bool ConfigReader::atomicWriteRemoteFile(const std::string& content) {
 
     std::string tmpPath; // 定义在外部以便 catch 块使用
     try {
-
         // 在相同目录下生成临时文件路径
         tmpPath = configPath + ".tmp." + std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
 
-        // 使用 base64 方式写入，避免额外换行和 heredoc 问题
-        std::string toWrite = content;
-        ensure_single_trailing_newline(toWrite); // 保证末尾有且仅有一个换行
-        std::string encoded = base64_encode(toWrite);
-        // 先检测远端是否存在 base64 工具，若无则回退到 heredoc（可能面临 EOF 关键词问题）
-        std::string checkBase64Cmd = "command -v base64 >/dev/null 2>&1 && echo '1' || echo '0'";
-        std::string hasBase64 = executeRemoteCommand(checkBase64Cmd);
-        std::string writeTempCmd;
-        if (hasBase64.find('1') != std::string::npos) {
-            writeTempCmd = "echo '" + encoded + "' | base64 -d > " + tmpPath;
-        } else {
-            // fallback to heredoc; escape single quotes by closing and reopening quoting
-            // But heredoc is susceptible to EOF content - we try to avoid extra ending EOF text by ensuring newline
-            writeTempCmd = "cat > " + tmpPath + " << 'EOF'\n" + toWrite + "\nEOF";
+        // 遥测 / 端口转发线程可能同时使用会话，写临时文件期间持有会话锁；
+        // 之后的 mv / rm 走 executeRemoteCommand，由它按每次尝试加锁，退避与重连期间不占用会话
+        int exitCode = 0;
+        std::string writerError;
+        {
+            auto sessionLock = sshManager->lockSession();
+            RemoteCommandExecutor writer(sshManager, "cat > " + tmpPath, false);
+            writer.execute();
+            produce(writer);
+            writer.sendEof();
+
+            exitCode = writer.waitForExit();
+            if (exitCode != 0) {
+                writerError = writer.getStderr();
+            }
         }
-        std::string writeResult = executeRemoteCommand(writeTempCmd);
-        Q_UNUSED(writeResult);
-
-        // 验证临时文件是否存在
-        std::string testTmpCmd = "test -f " + tmpPath + " && echo '1' || echo '0'";
-        std::string tmpExists = executeRemoteCommand(testTmpCmd);
-        if (tmpExists.find('1') == std::string::npos) {
-            // 临时文件写入失败
-            cerr << "临时文件未创建: " << tmpPath << std::endl;
-            // 尝试删除临时文件（防止残留）
+        if (exitCode != 0) {
+            cerr << "写入临时文件失败 (exit " << exitCode << "): " << tmpPath << " " << writerError << std::endl;
             executeRemoteCommand(std::string("rm -f ") + tmpPath);
             return false;
         }
 
-        // 将临时文件移动到目标路径（覆盖）
-        std::string mvCmd = "mv -f " + tmpPath + " " + configPath;
-        try {
-            std::string mvResult = executeRemoteCommand(mvCmd);
-            Q_UNUSED(mvResult);
-        } catch (...) {
-            // mv 失败，尝试删除临时文件以免泄露
-            try {
-                executeRemoteCommand(std::string("rm -f ") + tmpPath);
-            } catch (...) {
-                // 如果删除也失败，记录并返回失败
-            }
-            throw; // 重新抛出以由外层处理
+        // 将临时文件移动到目标路径（覆盖），成功后临时文件不会残留
+        std::string mvResult = executeRemoteCommand("mv -f " + tmpPath + " " + configPath + " && echo 'ok'");
+        if (mvResult.find("ok") == std::string::npos) {
+            cerr << "替换配置文件失败: " << tmpPath << " -> " << configPath << std::endl;
+            executeRemoteCommand(std::string("rm -f ") + tmpPath);
+            return false;
         }
-
-        // 成功移动，临时文件已替换为目标文件（不会残留tmp）
         return true;
     } catch (const SSHException& e) {
         std::cerr << "SSH异常: 写入远端文件失败: " << e.what() << std::endl;
@@ -149,90 +174,75 @@ ConfigReader::ConfigReader(SSHManager* manager, const std::string& configPath)
 }
 
 std::string ConfigReader::executeRemoteCommand(const std::string& command, int maxRetries) {
-    for (int attempt = 0; attempt < maxRetries; ++attempt) {
-        try {
-            // 检查SSH连接状态
-            if (!sshManager || sshManager->isSSHDisconnected()) {
-                if (attempt < maxRetries - 1) {
-                    qDebug() << "SSH连接断开，尝试重连 (" << (attempt + 1) << "/" << maxRetries << ")...";
-                    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-                    continue;
-                } else {
-                    throw SSHException("SSH连接断开且重连失败");
-                }
-            }
-            
-            // 获取SSH会话并检查有效性
-            LIBSSH2_SESSION* session = sshManager->getSession();
-            if (!session) {
-                if (attempt < maxRetries - 1) {
-                    qDebug() << "无法获取有效SSH会话，尝试重连 (" << (attempt + 1) << "/" << maxRetries << ")...";
-                    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-                    continue;
-                } else {
-                    throw SSHException("无法获取有效SSH会话");
-                }
+    // 遥测 / 端口转发线程可能同时使用会话，每次执行期间持有会话锁
+    auto lockSession = [this]() {
+        return sshManager ? sshManager->lockSession() : std::unique_lock<std::recursive_mutex>();
+    };
+
+    // 代理模式：不需要打开通道和启动远端 shell；代理失效时回退到下面的逐条 exec
+    {
+        auto sessionLock = lockSession();
+        if (RemoteAgent* agent = sshManager ? sshManager->getRemoteAgent() : nullptr) {
+            try {
+                std::string output;
+                agent->exec(command, output);
+                return output;
+            } catch (const std::exception& e) {
+                qDebug() << "远端代理执行失败，回退到通道执行:" << e.what();
             }
-            
-            RemoteCommandExecutor executor(sshManager, command, false);
-            executor.execute();
+        }
+    }
 
-            // 为了可靠读取完整输出，使用阻塞模式并读取直到通道 EOF
-            libssh2_session_set_blocking(sshManager->getSession(), 1);
-            char buffer[1024];
-            std::string result;
+    // 断线时重连后重试，通道打开失败等临时错误退避后重试，其余错误立即抛出。
+    // 锁只在单次尝试内持有：退避等待和重连期间其他线程可以继续使用会话
+    RetryPolicy::Options retryOptions;
+    retryOptions.maxAttempts = std::max(1, maxRetries);
+    RetryPolicy retry("executeRemoteCommand", sshManager, retryOptions);
+    return retry.run([&]() {
+        auto sessionLock = lockSession();
+        RemoteCommandExecutor executor(sshManager, command, false);
+        executor.execute();
 
-            auto startTime = chrono::steady_clock::now();
-            auto timeout = chrono::seconds(30); // 30秒超时
+        // 为了可靠读取完整输出，使用阻塞模式并读取直到通道 EOF
+        libssh2_session_set_blocking(sshManager->getSession(), 1);
+        char buffer[1024];
+        std::string result;
 
-            while (true) {
-                // 检查超时
-                if (chrono::steady_clock::now() - startTime > timeout) {
-                    qDebug() << "命令执行超时: " << QString::fromStdString(command);
-                    break;
-                }
-                
-                int bytesRead = libssh2_channel_read(executor.getChannel(), buffer, sizeof(buffer));
-                if (bytesRead > 0) {
-                    result.append(buffer, bytesRead);
-                    startTime = chrono::steady_clock::now(); // 重置超时计时器
-                    continue;
-                } else if (bytesRead == 0) {
-                    // 如果通道已经到 EOF，读取完成
-                    if (libssh2_channel_eof(executor.getChannel())) {
-                        break;
-                    }
-                    // 否则短暂等待再读
-                    this_thread::sleep_for(chrono::milliseconds(50));
-                    continue;
-                } else if (bytesRead == LIBSSH2_ERROR_EAGAIN) {
-                    // 非阻塞提示（理论上不会出现，因为已设置阻塞），短等重试
-                    this_thread::sleep_for(chrono::milliseconds(50));
-                    continue;
-                } else {
-                    // 出现错误，返回当前已读内容（并由调用方判断是否为空）
-                    break;
-                }
-            }
+        auto startTime = chrono::steady_clock::now();
+        auto timeout = chrono::seconds(30); // 30秒超时
 
-            return result;
-            
-        } catch (const SSHException& e) {
-            if (attempt == maxRetries - 1) {
-                throw; // 最后一次尝试仍然失败，重新抛出异常
+        while (true) {
+            // 检查超时
+            if (chrono::steady_clock::now() - startTime > timeout) {
+                qDebug() << "命令执行超时: " << QString::fromStdString(command);
+                break;
             }
-            qDebug() << "命令执行尝试 " << (attempt + 1) << " 失败: " << e.what();
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-        } catch (const std::exception& e) {
-            if (attempt == maxRetries - 1) {
-                throw SSHException(std::string("执行命令时发生异常: ") + e.what());
+            
+            int bytesRead = libssh2_channel_read(executor.getChannel(), buffer, sizeof(buffer));
+            if (bytesRead > 0) {
+                result.append(buffer, bytesRead);
+                startTime = chrono::steady_clock::now(); // 重置超时计时器
+                continue;
+            } else if (bytesRead == 0) {
+                // 如果通道已经到 EOF，读取完成
+                if (libssh2_channel_eof(executor.getChannel())) {
+                    break;
+                }
+                // 否则短暂等待再读
+                this_thread::sleep_for(chrono::milliseconds(50));
+                continue;
+            } else if (bytesRead == LIBSSH2_ERROR_EAGAIN) {
+                // 非阻塞提示（理论上不会出现，因为已设置阻塞），短等重试
+                this_thread::sleep_for(chrono::milliseconds(50));
+                continue;
+            } else {
+                // 出现错误，返回当前已读内容（并由调用方判断是否为空）
+                break;
             }
-            qDebug() << "命令执行异常 " << (attempt + 1) << ": " << e.what();
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
         }
-    }
-    
-    return ""; // 所有尝试都失败
+
+        return result;
+    });
 }
 
 bool ConfigReader::createDefaultConfig() {
@@ -301,6 +311,7 @@ bool ConfigReader::createDefaultConfig() {
 
 bool ConfigReader::parseConfigContent(const std::string& content, std::string &dedupedContent) {
     parsedParams.clear(); // 清空已解析参数集合
+    parsedValues.clear();
 
     // 保存原始每一行，用以重建去重后的内容
     std::vector<std::string> originalLines;
@@ -358,6 +369,7 @@ bool ConfigReader::parseConfigContent(const std::string& content, std::string &d
     for (const auto& kv : lastParsedValues) {
         setParameterValue(kv.first, kv.second);
         parsedParams.insert(kv.first);
+        parsedValues[kv.first] = kv.second;
     }
 
     // 构建去重后的文件内容（仅保留每个参数的最后一次出现）
@@ -568,6 +580,8 @@ bool ConfigReader::writeParameterToFile(const std::string& paramName, double val
             return false;
         }
         
+        notifyConfigChanged();
+
         // 更新内存中的参数值
         setParameterValue(paramName, value);
         
@@ -600,6 +614,16 @@ bool ConfigReader::loadConfig() {
             return false;
         }
         
+        // 每个 ConfigReader 清理一次之前异常中断遗留的临时文件（尽力而为，失败不影响加载）
+        if (!tempFilesCleaned) {
+            tempFilesCleaned = true;
+            try {
+                FileHandler(sshManager).cleanupOrphanedTempFiles(configPath);
+            } catch (const std::exception& e) {
+                qDebug() << "清理残留临时文件失败: " << e.what();
+            }
+        }
+
         qDebug() << "正在检查远程配置文件: " << configPath;
         
         // 检查文件是否存在
@@ -891,6 +915,9 @@ std::vector<std::string> ConfigReader::getMissingParameters() const {
 
 bool ConfigReader::writeMultipleParametersToFile(const std::vector<std::pair<std::string, double>>& params) {
     try {
+        lastWriteBaseline.clear();
+        lastWrittenContent.clear();
+
         // 检查参数列表是否为空
         if (params.empty()) {
             qDebug() << "警告: 参数列表为空，无需写入文件";
@@ -934,85 +961,27 @@ bool ConfigReader::writeMultipleParametersToFile(const std::vector<std::pair<std
             cerr << "配置文件内容为空或读取失败" << endl;
             return false;
         }
+        lastWriteBaseline = fileContent;
         
         qDebug() << "读取到的配置文件内容:";
         qDebug().noquote() << QString::fromStdString(fileContent);
         
-        // 将内容按行分割
-        vector<string> lines;
-        istringstream contentStream(fileContent);
-        string line;
-        
-        while (getline(contentStream, line)) {
-            lines.push_back(line);
-        }
-        
-        qDebug() << "配置文件行数:" << lines.size();
-        
-        // 批量更新参数值
+        // 修改文件内容，并同步已解析参数集合与内存中的参数值
+        string finalContent = applyParameterEdits(fileContent, params);
         for (const auto& param : params) {
             const string& paramName = param.first;
             double value = param.second;
-            bool paramFound = false;
-            
-            // 检查是否为x_vel_limit_walk或x_vel_limit_run且值为NaN，如果是则删除该参数
             if ((paramName == "x_vel_limit_walk" || paramName == "x_vel_limit_run") && std::isnan(value)) {
-                qDebug() << "删除参数" << paramName << "，因为值为NaN";
-                
-                // 从配置文件中删除该参数行
-                auto it = lines.begin();
-                while (it != lines.end()) {
-                    string trimmedLine = *it;
-                    trimmedLine.erase(0, trimmedLine.find_first_not_of(" \t"));
-                    
-                    if (trimmedLine.find(paramName + "=") == 0) {
-                        // 找到参数行，删除它
-                        it = lines.erase(it);
-                        // 从已解析参数集合中删除
-                        parsedParams.erase(paramName);
-                        qDebug() << "已从配置文件中删除参数:" << paramName;
-                    } else {
-                        ++it;
-                    }
-                }
+                parsedParams.erase(paramName);
+                qDebug() << "已从配置文件中删除参数:" << paramName;
                 continue;
             }
-            
-            // 在现有行中查找并更新参数
-            for (auto& currentLine : lines) {
-                string trimmedLine = currentLine;
-                trimmedLine.erase(0, trimmedLine.find_first_not_of(" \t"));
-                
-                if (trimmedLine.find(paramName + "=") == 0) {
-                    // 找到参数行，更新值
-                    stringstream newLine;
-                    newLine << paramName << "=" << value;
-                    currentLine = newLine.str();
-                    paramFound = true;
-                    break;
-                }
-            }
-            
-            // 如果参数不存在，添加到文件末尾
-            if (!paramFound) {
-                stringstream newLine;
-                newLine << paramName << "=" << value;
-                lines.push_back(newLine.str());
-                parsedParams.insert(paramName); // 添加到已解析集合
-            }
-            
-            // 更新内存中的参数值
+            parsedParams.insert(paramName);
             setParameterValue(paramName, value);
         }
         
-        // 显示最终要写入的内容
         qDebug() << "最终要写入的配置文件内容:";
-        string finalContent;
-        for (const auto& currentLine : lines) {
-            finalContent += currentLine + "\n";
-            qDebug().noquote() << QString::fromStdString(currentLine);
-        }
-        qDebug() << "最终配置文件行数:" << lines.size();
+        qDebug().noquote() << QString::fromStdString(finalContent);
         
         // 原子写回文件（写临时文件并 mv）
         bool writeOk = atomicWriteRemoteFile(finalContent);
@@ -1020,6 +989,8 @@ bool ConfigReader::writeMultipleParametersToFile(const std::vector<std::pair<std
             cerr << "批量写入参数失败: 原子写回失败" << endl;
             return false;
         }
+        lastWrittenContent = std::move(finalContent);
+        notifyConfigChanged();
         
         qDebug() << "批量写入" << validParamCount << "个参数成功完成! (原始" << params.size() << "个参数)";
         return true;
@@ -1036,4 +1007,78 @@ bool ConfigReader::writeMultipleParametersToFile(const std::vector<std::pair<std
     }
 }
 
-bool ConfigReader::isConfigLoaded() const { return configLoaded; }
\ No newline at end of file
+// ===== 参数修改（纯文本变换） =====
+// 同步写入与协程写入共用：已有的行就地更新，不存在的追加，NaN 的速度上限删除对应行
+std::string ConfigReader::applyParameterEdits(const std::string& content,
+                                              const std::vector<std::pair<std::string, double>>& params) {
+    vector<string> lines;
+    istringstream contentStream(content);
+    string line;
+    while (getline(contentStream, line)) {
+        lines.push_back(line);
+    }
+
+    auto isParamLine = [](const string& currentLine, const string& paramName) {
+        const size_t first = currentLine.find_first_not_of(" \t");
+        return first != string::npos && currentLine.compare(first, paramName.size() + 1, paramName + "=") == 0;
+    };
+
+    for (const auto& param : params) {
+        const string& paramName = param.first;
+        double value = param.second;
+
+        if ((paramName == "x_vel_limit_walk" || paramName == "x_vel_limit_run") && std::isnan(value)) {
+            lines.erase(std::remove_if(lines.begin(), lines.end(),
+                                       [&](const string& l) { return isParamLine(l, paramName); }),
+                        lines.end());
+            continue;
+        }
+
+        stringstream newLine;
+        newLine << paramName << "=" << value;
+        auto it = std::find_if(lines.begin(), lines.end(),
+                               [&](const string& l) { return isParamLine(l, paramName); });
+        if (it != lines.end()) {
+            *it = newLine.str();
+        } else {
+            lines.push_back(newLine.str());
+        }
+    }
+
+    string result;
+    for (const auto& currentLine : lines) {
+        result += currentLine + "\n";
+    }
+    return result;
+}
+
+bool ConfigReader::isConfigLoaded() const { return configLoaded; }
+
+void ConfigReader::setNotifier(std::shared_ptr<IConfigNotifier> configNotifier) {
+    notifier = std::move(configNotifier);
+    liveUpdated = false;
+}
+
+// ===== 热更新通知 =====
+// 文件已经原子替换，通知失败不影响保存结果，只是回退到“重启后生效”
+void ConfigReader::notifyConfigChanged() {
+    liveUpdated = false;
+    if (!notifier) {
+        return;
+    }
+
+    std::string error;
+    try {
+        liveUpdated = notifier->notify([this](const std::string& command) {
+            return executeRemoteCommand(command, 1);
+        }, configPath, error);
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+
+    if (liveUpdated) {
+        qDebug() << "已通知控制器重新加载配置:" << QString::fromStdString(notifier->describe());
+    } else {
+        cerr << "通知控制器失败 (" << notifier->describe() << "): " << error << endl;
+    }
+}
\ No newline at end of file
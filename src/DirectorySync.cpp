@@ -0,0 +1,439 @@
+#include "DirectorySync.h"
+#include "FileHandler.h"
+#include "RemoteCommandExecutor.h"
+#include "ResourceManager.h"
+#include "Sha256.h"
+#include "Utf8Path.h"
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <sys/stat.h>
+#include <QDebug>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// 单条远端命令的最大长度；远端 ARG_MAX 通常远大于此，留足余量
+const size_t kMaxBatchCommandLength = 64 * 1024;
+
+int64_t localMtime(const fs::path& path) {
+#ifdef _WIN32
+    struct _stat64 st;
+    if (_wstat64(path.c_str(), &st) == 0) {
+        return static_cast<int64_t>(st.st_mtime);
+    }
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0) {
+        return static_cast<int64_t>(st.st_mtime);
+    }
+#endif
+    return 0;
+}
+
+std::string lastSessionError(LIBSSH2_SESSION* session) {
+    char* errmsg = nullptr;
+    libssh2_session_last_error(session, &errmsg, nullptr, 0);
+    return errmsg ? std::string(errmsg) : std::string("unknown error");
+}
+
+// 一个并发上传槽位的状态机，每个阶段都可能返回 EAGAIN，下一轮继续推进
+struct Slot {
+    enum class Phase { Idle, Opening, Sending, SendEof, WaitEof, Closing, WaitClosed };
+
+    Phase phase = Phase::Idle;
+    std::string relPath;
+    std::string remotePath;
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    std::ifstream in;
+    LIBSSH2_CHANNEL* channel = nullptr;
+    std::vector<char> buffer;
+    size_t bufLen = 0;
+    size_t bufOff = 0;
+    uint64_t readBytes = 0;
+
+    void reset() {
+        phase = Phase::Idle;
+        if (in.is_open()) {
+            in.close();
+        }
+        in.clear();
+        channel = nullptr;
+        bufLen = 0;
+        bufOff = 0;
+        readBytes = 0;
+    }
+};
+
+} // namespace
+
+DirectorySync::DirectorySync(SSHManager* manager) : sshManager(manager) {}
+
+int DirectorySync::runRemote(const std::string& command, std::string& output) {
+    RemoteCommandExecutor executor(sshManager, command, false);
+    executor.execute();
+    return executor.waitForExit(&output);
+}
+
+DirectorySync::FileMap DirectorySync::scanLocal(const std::string& localDir) const {
+    FileMap files;
+    const fs::path root(localDir);
+    if (!fs::is_directory(root)) {
+        throw ConfigException("本地目录不存在: " + localDir);
+    }
+    for (const auto& entry : fs::recursive_directory_iterator(root)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        FileInfo info;
+        info.size = static_cast<uint64_t>(entry.file_size());
+        info.mtime = localMtime(entry.path());
+        info.localPath = entry.path();
+        files[utf8GenericPath(fs::relative(entry.path(), root))] = info;
+    }
+    return files;
+}
+
+DirectorySync::FileMap DirectorySync::listRemote(const std::string& remoteDir, bool withChecksum) {
+    FileMap files;
+    const std::string dir = FileHandler::shellQuote(remoteDir);
+
+    // 目录不存在时输出为空，视为全部需要上传
+    std::string output;
+    int exitCode = runRemote("if cd " + dir + " 2>/dev/null; then find . -type f -printf '%s %T@ %P\\n'; fi", output);
+    if (exitCode != 0) {
+        throw RemoteCommandException("列出远端目录失败: " + remoteDir);
+    }
+
+    std::istringstream lines(output);
+    std::string line;
+    while (std::getline(lines, line)) {
+        // 格式: <size> <mtime.frac> <relative path>，路径本身可能含空格
+        size_t first = line.find(' ');
+        size_t second = first == std::string::npos ? first : line.find(' ', first + 1);
+        if (second == std::string::npos) {
+            continue;
+        }
+        try {
+            FileInfo info;
+            info.size = std::stoull(line.substr(0, first));
+            info.mtime = static_cast<int64_t>(std::stod(line.substr(first + 1, second - first - 1)));
+            files[line.substr(second + 1)] = info;
+        } catch (...) {
+            continue;
+        }
+    }
+
+    if (withChecksum && !files.empty()) {
+        output.clear();
+        exitCode = runRemote("cd " + dir + " && find . -type f -exec sha256sum {} +", output);
+        if (exitCode != 0) {
+            throw RemoteCommandException("远端 sha256sum 失败: " + remoteDir);
+        }
+        std::istringstream hashes(output);
+        while (std::getline(hashes, line)) {
+            // 格式: <64 位摘要>  ./<relative path>
+            if (line.size() < 68 || line.compare(64, 4, "  ./") != 0) {
+                continue;
+            }
+            auto it = files.find(line.substr(68));
+            if (it != files.end()) {
+                it->second.sha256 = line.substr(0, 64);
+            }
+        }
+    }
+    return files;
+}
+
+void DirectorySync::runBatched(const std::string& prefix, const std::vector<std::string>& args) {
+    size_t index = 0;
+    while (index < args.size()) {
+        std::string command = prefix;
+        while (index < args.size()) {
+            std::string quoted = " " + FileHandler::shellQuote(args[index]);
+            if (command.size() > prefix.size() && command.size() + quoted.size() > kMaxBatchCommandLength) {
+                break;
+            }
+            command += quoted;
+            ++index;
+        }
+        std::string output;
+        if (runRemote(command, output) != 0) {
+            throw RemoteCommandException("远端批量命令失败: " + prefix);
+        }
+    }
+}
+
+void DirectorySync::transfer(const std::vector<std::pair<std::string, FileInfo>>& files, const std::string& remoteDir,
+                             const Options& options, Report& report) {
+    if (files.empty()) {
+        return;
+    }
+
+    LIBSSH2_SESSION* session = sshManager->getSession();
+    if (!session) {
+        throw SSHException("无法获取有效的SSH会话，无法同步目录");
+    }
+
+    uint64_t totalBytes = 0;
+    for (const auto& file : files) {
+        totalBytes += file.second.size;
+    }
+
+    std::vector<Slot> slots(static_cast<size_t>(std::max(1, options.parallelChannels)));
+    for (auto& slot : slots) {
+        slot.buffer.resize(std::max<size_t>(options.bufferSize, 1));
+    }
+
+    size_t next = 0;
+    // libssh2 在会话上只保存一份“打开通道”的状态，同一时刻只能有一个通道处于 Opening
+    bool opening = false;
+    const auto startTime = std::chrono::steady_clock::now();
+    const auto stallTimeout = std::chrono::milliseconds(options.stallTimeoutMs);
+
+    auto failSlot = [&](Slot& slot, const std::string& reason) {
+        report.failures.emplace_back(slot.relPath, reason);
+        if (slot.phase == Slot::Phase::Opening) {
+            opening = false;
+        }
+        if (slot.channel) {
+            libssh2_channel_free(slot.channel);
+        }
+        slot.reset();
+    };
+
+    try {
+        ResourceManagement::NonBlockingScope nonBlocking(session);
+        auto lastProgress = startTime;
+
+        while (true) {
+            if (g_interrupted) {
+                throw OperationCancelledException("目录同步已中断");
+            }
+
+            bool progressed = false;
+            bool active = false;
+
+            for (auto& slot : slots) {
+                if (slot.phase == Slot::Phase::Idle && next < files.size() && !opening) {
+                    const auto& file = files[next++];
+                    slot.relPath = file.first;
+                    slot.remotePath = remoteDir + "/" + file.first;
+                    slot.size = file.second.size;
+                    slot.mtime = file.second.mtime;
+                    slot.in.open(file.second.localPath, std::ios::binary);
+                    if (!slot.in.is_open()) {
+                        report.failures.emplace_back(slot.relPath, "无法打开本地文件");
+                        slot.reset();
+                        continue;
+                    }
+                    slot.phase = Slot::Phase::Opening;
+                    opening = true;
+                }
+
+                switch (slot.phase) {
+                case Slot::Phase::Idle:
+                    break;
+
+                case Slot::Phase::Opening: {
+                    // 保留本地 mtime，下次同步可以直接按 大小+mtime 判断未变化
+                    LIBSSH2_CHANNEL* channel = libssh2_scp_send64(
+                        session, slot.remotePath.c_str(), options.mode, static_cast<libssh2_int64_t>(slot.size),
+                        static_cast<time_t>(slot.mtime), static_cast<time_t>(slot.mtime));
+                    if (channel) {
+                        slot.channel = channel;
+                        slot.phase = Slot::Phase::Sending;
+                        opening = false;
+                        progressed = true;
+                    } else if (libssh2_session_last_errno(session) != LIBSSH2_ERROR_EAGAIN) {
+                        failSlot(slot, "SCP channel creation failed: " + lastSessionError(session));
+                        progressed = true;
+                    }
+                    break;
+                }
+
+                case Slot::Phase::Sending: {
+                    if (slot.bufOff == slot.bufLen) {
+                        if (slot.readBytes == slot.size) {
+                            slot.phase = Slot::Phase::SendEof;
+                            progressed = true;
+                            break;
+                        }
+                        const size_t toRead =
+                            static_cast<size_t>(std::min<uint64_t>(slot.buffer.size(), slot.size - slot.readBytes));
+                        slot.in.read(slot.buffer.data(), static_cast<std::streamsize>(toRead));
+                        slot.bufLen = static_cast<size_t>(slot.in.gcount());
+                        slot.bufOff = 0;
+                        if (slot.bufLen == 0) {
+                            failSlot(slot, "读取本地文件失败");
+                            progressed = true;
+                            break;
+                        }
+                        slot.readBytes += slot.bufLen;
+                    }
+                    ssize_t written =
+                        libssh2_channel_write(slot.channel, slot.buffer.data() + slot.bufOff, slot.bufLen - slot.bufOff);
+                    if (written > 0) {
+                        slot.bufOff += static_cast<size_t>(written);
+                        report.bytesUploaded += static_cast<uint64_t>(written);
+                        progressed = true;
+                    } else if (written != LIBSSH2_ERROR_EAGAIN && written != 0) {
+                        failSlot(slot, "File upload failed: " + lastSessionError(session));
+                        progressed = true;
+                    }
+                    break;
+                }
+
+                case Slot::Phase::SendEof:
+                case Slot::Phase::WaitEof:
+                case Slot::Phase::Closing:
+                case Slot::Phase::WaitClosed: {
+                    int rc;
+                    Slot::Phase nextPhase;
+                    if (slot.phase == Slot::Phase::SendEof) {
+                        rc = libssh2_channel_send_eof(slot.channel);
+                        nextPhase = Slot::Phase::WaitEof;
+                    } else if (slot.phase == Slot::Phase::WaitEof) {
+                        rc = libssh2_channel_wait_eof(slot.channel);
+                        nextPhase = Slot::Phase::Closing;
+                    } else if (slot.phase == Slot::Phase::Closing) {
+                        rc = libssh2_channel_close(slot.channel);
+                        nextPhase = Slot::Phase::WaitClosed;
+                    } else {
+                        rc = libssh2_channel_wait_closed(slot.channel);
+                        nextPhase = Slot::Phase::Idle;
+                    }
+
+                    if (rc == LIBSSH2_ERROR_EAGAIN) {
+                        break;
+                    }
+                    if (rc < 0) {
+                        failSlot(slot, "关闭 SCP 通道失败: " + lastSessionError(session));
+                    } else if (nextPhase == Slot::Phase::Idle) {
+                        libssh2_channel_free(slot.channel);
+                        report.filesUploaded++;
+                        report.uploaded.push_back(slot.relPath);
+                        slot.reset();
+                    } else {
+                        slot.phase = nextPhase;
+                    }
+                    progressed = true;
+                    break;
+                }
+                }
+
+                if (slot.phase != Slot::Phase::Idle) {
+                    active = true;
+                }
+            }
+
+            if (!active && next >= files.size()) {
+                break;
+            }
+
+            if (progressed) {
+                lastProgress = std::chrono::steady_clock::now();
+                if (options.progress && !options.progress(report.bytesUploaded, totalBytes)) {
+                    throw OperationCancelledException("目录同步已取消");
+                }
+            } else {
+                if (std::chrono::steady_clock::now() - lastProgress > stallTimeout) {
+                    throw NetworkException("目录同步停滞超时");
+                }
+                sshManager->waitSocket(100);
+            }
+        }
+    } catch (...) {
+        // 已恢复阻塞模式，释放所有仍打开的通道
+        for (auto& slot : slots) {
+            if (slot.channel) {
+                libssh2_channel_free(slot.channel);
+                slot.channel = nullptr;
+            }
+        }
+        throw;
+    }
+
+    report.transferSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+DirectorySync::Report DirectorySync::sync(const std::string& localDir, const std::string& remoteDir,
+                                          const Options& options) {
+    if (!sshManager) {
+        throw SSHException("SSH管理器为空，无法同步目录");
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    Report report;
+
+    FileMap local = scanLocal(localDir);
+    report.filesScanned = local.size();
+    FileMap remote = listRemote(remoteDir, options.checksum);
+
+    std::vector<std::pair<std::string, FileInfo>> toUpload;
+    std::set<std::string> dirs;
+    for (auto& entry : local) {
+        auto it = remote.find(entry.first);
+        bool unchanged = false;
+        if (it != remote.end() && it->second.size == entry.second.size) {
+            if (options.checksum) {
+                // 只为大小相同的候选文件计算本地摘要
+                entry.second.sha256 = Sha256::hashFile(entry.second.localPath.string());
+                unchanged = !entry.second.sha256.empty() && entry.second.sha256 == it->second.sha256;
+            } else {
+                unchanged = it->second.mtime == entry.second.mtime;
+            }
+        }
+        if (unchanged) {
+            report.filesSkipped++;
+            continue;
+        }
+        toUpload.emplace_back(entry.first, entry.second);
+        size_t slash = entry.first.rfind('/');
+        dirs.insert(slash == std::string::npos ? remoteDir : remoteDir + "/" + entry.first.substr(0, slash));
+    }
+
+    std::vector<std::string> stale;
+    if (options.deleteStale) {
+        for (const auto& entry : remote) {
+            if (local.find(entry.first) == local.end()) {
+                stale.push_back(entry.first);
+            }
+        }
+    }
+
+    if (options.dryRun) {
+        for (const auto& file : toUpload) {
+            report.uploaded.push_back(file.first);
+        }
+        report.deleted = stale;
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        return report;
+    }
+
+    if (!dirs.empty()) {
+        runBatched("mkdir -p --", std::vector<std::string>(dirs.begin(), dirs.end()));
+    }
+
+    transfer(toUpload, remoteDir, options, report);
+
+    if (!stale.empty()) {
+        std::vector<std::string> stalePaths;
+        stalePaths.reserve(stale.size());
+        for (const auto& rel : stale) {
+            stalePaths.push_back(remoteDir + "/" + rel);
+        }
+        runBatched("rm -f --", stalePaths);
+        report.filesDeleted = stale.size();
+        report.deleted = stale;
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    qDebug() << "目录同步完成:" << QString::fromStdString(localDir) << "->" << QString::fromStdString(remoteDir)
+             << "上传" << report.filesUploaded << "跳过" << report.filesSkipped << "删除" << report.filesDeleted
+             << "失败" << report.failures.size() << "吞吐量" << report.throughputMBps() << "MB/s";
+    return report;
+}
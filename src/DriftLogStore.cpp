@@ -0,0 +1,622 @@
+#include "DriftLogStore.h"
+#include "Exceptions.h"
+#include "TelemetryParser.h"
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ADJUSTBIAS_STORE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang 需要 target 属性才能在默认 -march 下使用 AVX2 内建函数
+#if defined(ADJUSTBIAS_STORE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define STORE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define STORE_TARGET(isa)
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kMagic[8] = {'A', 'B', 'C', 'O', 'L', 'v', '1', '\0'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kFlagHasTime = 1;
+constexpr uint32_t kFlagTimeSorted = 2;
+constexpr uint64_t kAlignment = 64;
+constexpr int kMaxFields = 64;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t channelCount;
+    uint64_t capacity;          // 每个数组的长度（转换时按行数上限分配）
+    uint64_t rowCount;          // 实际行数 <= capacity
+    uint64_t malformedLines;
+    uint64_t timeOffset;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+struct ChannelEntry {
+    char name[56];
+    uint64_t offset;
+};
+
+static_assert(sizeof(FileHeader) == 56, "FileHeader layout");
+static_assert(sizeof(ChannelEntry) == 64, "ChannelEntry layout");
+
+uint64_t alignUp(uint64_t value) {
+    return (value + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+std::string lower(std::string_view s) {
+    std::string out(s);
+    std::transform(out.begin(), out.end(), out.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return out;
+}
+
+bool isTimeName(const std::string& name) {
+    return name == "t" || name == "time" || name == "timestamp" || name == "stamp";
+}
+
+bool isGaitName(const std::string& name) {
+    return name == "gait" || name == "mode";
+}
+
+bool parseGaitValue(std::string_view field, double& value) {
+    const std::string name = lower(field);
+    if (name == "walk") {
+        value = 0.0;
+        return true;
+    }
+    if (name == "run") {
+        value = 1.0;
+        return true;
+    }
+    return false;
+}
+
+// 按行遍历映射的文本（不拷贝）
+class LineCursor {
+public:
+    LineCursor(const char* data, size_t len) : cursor(data), end(data + len) {}
+
+    bool next(std::string_view& line) {
+        if (cursor >= end) {
+            return false;
+        }
+        const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+        const char* lineEnd = newline ? newline : end;
+        line = std::string_view(cursor, static_cast<size_t>(lineEnd - cursor));
+        cursor = newline ? newline + 1 : end;
+        return true;
+    }
+
+    const char* position() const { return cursor; }
+
+private:
+    const char* cursor;
+    const char* end;
+};
+
+// 扫描时使用的已解析条件
+struct ResolvedCondition {
+    const float* column;
+    DriftLogStore::Condition::Op op;
+    float value;
+};
+
+bool matches(float x, const ResolvedCondition& c) {
+    switch (c.op) {
+    case DriftLogStore::Condition::Eq: return x == c.value;
+    case DriftLogStore::Condition::Ne: return x != c.value;
+    case DriftLogStore::Condition::Lt: return x < c.value;
+    case DriftLogStore::Condition::Le: return x <= c.value;
+    case DriftLogStore::Condition::Gt: return x > c.value;
+    case DriftLogStore::Condition::Ge: return x >= c.value;
+    case DriftLogStore::Condition::AbsLt: return std::fabs(x) < c.value;
+    case DriftLogStore::Condition::AbsLe: return std::fabs(x) <= c.value;
+    }
+    return false;
+}
+
+// 扫描累加量：值减去 pivot 后再求和，避免大偏移量下方差的抵消误差
+struct Accumulator {
+    double sum = 0.0;
+    double sumSq = 0.0;
+    float min = std::numeric_limits<float>::infinity();
+    float max = -std::numeric_limits<float>::infinity();
+    size_t count = 0;
+};
+
+void scanScalar(const float* values, const std::vector<ResolvedCondition>& conditions, const double* time,
+                double tFrom, double tTo, size_t begin, size_t end, float pivot, Accumulator& acc) {
+    for (size_t i = begin; i < end; ++i) {
+        const float v = values[i];
+        if (std::isnan(v)) {
+            continue;
+        }
+        if (time && (time[i] < tFrom || time[i] > tTo)) {
+            continue;
+        }
+        bool ok = true;
+        for (const ResolvedCondition& c : conditions) {
+            if (!matches(c.column[i], c)) {
+                ok = false;
+                break;
+            }
+        }
+        if (!ok) {
+            continue;
+        }
+        const double d = static_cast<double>(v - pivot);
+        acc.sum += d;
+        acc.sumSq += d * d;
+        acc.min = std::min(acc.min, v);
+        acc.max = std::max(acc.max, v);
+        ++acc.count;
+    }
+}
+
+#ifdef ADJUSTBIAS_STORE_X86
+
+STORE_TARGET("avx2") inline __m256 compare8(__m256 x, __m256 y, DriftLogStore::Condition::Op op) {
+    switch (op) {
+    case DriftLogStore::Condition::Eq: return _mm256_cmp_ps(x, y, _CMP_EQ_OQ);
+    case DriftLogStore::Condition::Ne: return _mm256_cmp_ps(x, y, _CMP_NEQ_UQ);
+    case DriftLogStore::Condition::Lt:
+    case DriftLogStore::Condition::AbsLt: return _mm256_cmp_ps(x, y, _CMP_LT_OQ);
+    case DriftLogStore::Condition::Le:
+    case DriftLogStore::Condition::AbsLe: return _mm256_cmp_ps(x, y, _CMP_LE_OQ);
+    case DriftLogStore::Condition::Gt: return _mm256_cmp_ps(x, y, _CMP_GT_OQ);
+    case DriftLogStore::Condition::Ge: return _mm256_cmp_ps(x, y, _CMP_GE_OQ);
+    }
+    return _mm256_setzero_ps();
+}
+
+// 每次处理 8 个样本：各条件的比较结果按位与得到掩码，被屏蔽的通道置零后转换为 double 累加，
+// 样本数由掩码的 popcount 得到。返回处理到的行号，剩余不足 8 行由标量实现处理。
+STORE_TARGET("avx2")
+size_t scanAVX2(const float* values, const std::vector<ResolvedCondition>& conditions, size_t begin, size_t end,
+                float pivot, Accumulator& acc) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const __m256 pivot8 = _mm256_set1_ps(pivot);
+    const __m256 posInf = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    const __m256 negInf = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+    __m256d sumLo = _mm256_setzero_pd();
+    __m256d sumHi = _mm256_setzero_pd();
+    __m256d sqLo = _mm256_setzero_pd();
+    __m256d sqHi = _mm256_setzero_pd();
+    __m256 min8 = posInf;
+    __m256 max8 = negInf;
+    size_t count = 0;
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const __m256 v = _mm256_loadu_ps(values + i);
+        __m256 mask = _mm256_cmp_ps(v, v, _CMP_ORD_Q);
+        for (const ResolvedCondition& c : conditions) {
+            __m256 x = _mm256_loadu_ps(c.column + i);
+            if (c.op == DriftLogStore::Condition::AbsLt || c.op == DriftLogStore::Condition::AbsLe) {
+                x = _mm256_and_ps(x, absMask);
+            }
+            mask = _mm256_and_ps(mask, compare8(x, _mm256_set1_ps(c.value), c.op));
+        }
+        const int bits = _mm256_movemask_ps(mask);
+        if (bits == 0) {
+            continue;
+        }
+        count += std::bitset<8>(static_cast<unsigned>(bits)).count();
+
+        const __m256 d = _mm256_and_ps(_mm256_sub_ps(v, pivot8), mask);
+        const __m256d dLo = _mm256_cvtps_pd(_mm256_castps256_ps128(d));
+        const __m256d dHi = _mm256_cvtps_pd(_mm256_extractf128_ps(d, 1));
+        sumLo = _mm256_add_pd(sumLo, dLo);
+        sumHi = _mm256_add_pd(sumHi, dHi);
+        sqLo = _mm256_add_pd(sqLo, _mm256_mul_pd(dLo, dLo));
+        sqHi = _mm256_add_pd(sqHi, _mm256_mul_pd(dHi, dHi));
+        min8 = _mm256_min_ps(min8, _mm256_blendv_ps(posInf, v, mask));
+        max8 = _mm256_max_ps(max8, _mm256_blendv_ps(negInf, v, mask));
+    }
+
+    alignas(32) double sums[4];
+    alignas(32) double squares[4];
+    alignas(32) float mins[8];
+    alignas(32) float maxs[8];
+    _mm256_store_pd(sums, _mm256_add_pd(sumLo, sumHi));
+    _mm256_store_pd(squares, _mm256_add_pd(sqLo, sqHi));
+    _mm256_store_ps(mins, min8);
+    _mm256_store_ps(maxs, max8);
+    acc.sum += (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    acc.sumSq += (squares[0] + squares[1]) + (squares[2] + squares[3]);
+    acc.min = std::min(acc.min, *std::min_element(mins, mins + 8));
+    acc.max = std::max(acc.max, *std::max_element(maxs, maxs + 8));
+    acc.count += count;
+    return i;
+}
+
+bool detectAVX2() {
+#if defined(_MSC_VER)
+    int regs[4] = {0};
+    __cpuid(regs, 0);
+    const int maxLeaf = regs[0];
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool avx = (regs[2] & (1 << 28)) != 0;
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(regs, 7, 0);
+        return (regs[1] & (1 << 5)) != 0;
+    }
+    return false;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // ADJUSTBIAS_STORE_X86
+
+} // namespace
+
+// ===== 实现选择 =====
+
+bool DriftLogStore::isSupported(Impl impl) {
+    switch (impl) {
+    case Impl::Scalar:
+        return true;
+#ifdef ADJUSTBIAS_STORE_X86
+    case Impl::AVX2: {
+        static const bool avx2 = detectAVX2();
+        return avx2;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+DriftLogStore::Impl DriftLogStore::activeImpl() {
+    static const Impl impl = isSupported(Impl::AVX2) ? Impl::AVX2 : Impl::Scalar;
+    return impl;
+}
+
+const char* DriftLogStore::implName(Impl impl) {
+    return impl == Impl::AVX2 ? "avx2" : "scalar";
+}
+
+// ===== 转换 =====
+
+DriftLogStore::ConvertStats DriftLogStore::convert(const std::string& textPath, const std::string& storePath) {
+    const auto started = std::chrono::steady_clock::now();
+    MappedFile text = MappedFile::open(textPath);
+    const char* data = text.data();
+    const size_t len = text.size();
+
+    // 表头：第一个非空行；全部字段都是数字时视为没有表头，该行按数据处理
+    LineCursor lines(data, len);
+    std::string_view line;
+    std::string_view fields[kMaxFields];
+    int count = 0;
+    const char* firstLine = nullptr;
+    for (const char* start = lines.position(); lines.next(line); start = lines.position()) {
+        count = TelemetryLineParser::split(line, fields, kMaxFields);
+        if (count > 0) {
+            firstLine = start;
+            break;
+        }
+    }
+    if (!firstLine) {
+        throw ConfigException("日志为空: " + textPath);
+    }
+
+    bool headerless = true;
+    for (int i = 0; i < count && headerless; ++i) {
+        double value;
+        headerless = TelemetryLineParser::parseNumber(fields[i], value);
+    }
+
+    const int fieldCount = count;
+    int timeField = -1;
+    std::vector<int> channelFields;
+    std::vector<std::string> channelNames;
+    std::vector<bool> gaitFields(fieldCount, false);
+    for (int i = 0; i < fieldCount; ++i) {
+        std::string name = headerless ? "c" + std::to_string(i) : lower(fields[i]);
+        if (!headerless && timeField < 0 && isTimeName(name)) {
+            timeField = i;
+            continue;
+        }
+        gaitFields[i] = isGaitName(name);
+        name.resize(std::min(name.size(), sizeof(ChannelEntry::name) - 1));
+        channelFields.push_back(i);
+        channelNames.push_back(name);
+    }
+    if (headerless) {
+        lines = LineCursor(firstLine, static_cast<size_t>(data + len - firstLine));
+    }
+
+    // 行数上限 = 换行数 + 1，各数组按上限一次分配，转换只需扫描一遍文本
+    const uint64_t capacity = static_cast<uint64_t>(std::count(lines.position(), data + len, '\n')) + 1;
+    const uint64_t tableSize = sizeof(FileHeader) + channelNames.size() * sizeof(ChannelEntry);
+    const uint64_t timeOffset = alignUp(tableSize);
+    uint64_t offset = alignUp(timeOffset + capacity * sizeof(double));
+    std::vector<uint64_t> channelOffsets;
+    for (size_t c = 0; c < channelNames.size(); ++c) {
+        channelOffsets.push_back(offset);
+        offset = alignUp(offset + capacity * sizeof(float));
+    }
+
+    // 先写到临时文件，完整写完后再替换，避免中断时留下半个分析文件
+    const std::string tmpPath = storePath + ".tmp";
+    ConvertStats stats;
+    stats.channels = channelNames.size();
+    {
+        MappedFile out = MappedFile::create(tmpPath, offset);
+        char* base = out.data();
+        double* time = reinterpret_cast<double*>(base + timeOffset);
+        std::vector<float*> columns;
+        for (uint64_t channelOffset : channelOffsets) {
+            columns.push_back(reinterpret_cast<float*>(base + channelOffset));
+        }
+
+        uint64_t rows = 0;
+        bool sorted = true;
+        while (lines.next(line)) {
+            count = TelemetryLineParser::split(line, fields, kMaxFields);
+            if (count == 0) {
+                continue;
+            }
+            double t = static_cast<double>(rows);
+            if (count < fieldCount || (timeField >= 0 && !TelemetryLineParser::parseNumber(fields[timeField], t))) {
+                ++stats.malformedLines;
+                continue;
+            }
+            if (rows > 0 && t < time[rows - 1]) {
+                sorted = false;
+            }
+            time[rows] = t;
+            for (size_t c = 0; c < columns.size(); ++c) {
+                const std::string_view field = fields[channelFields[c]];
+                double value;
+                if (!TelemetryLineParser::parseNumber(field, value) &&
+                    !(gaitFields[channelFields[c]] && parseGaitValue(field, value))) {
+                    value = std::numeric_limits<double>::quiet_NaN();
+                }
+                columns[c][rows] = static_cast<float>(value);
+            }
+            ++rows;
+        }
+
+        FileHeader header = {};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.channelCount = static_cast<uint32_t>(channelNames.size());
+        header.capacity = capacity;
+        header.rowCount = rows;
+        header.malformedLines = stats.malformedLines;
+        header.timeOffset = timeOffset;
+        header.flags = (timeField >= 0 ? kFlagHasTime : 0) | (sorted ? kFlagTimeSorted : 0);
+        std::memcpy(base, &header, sizeof(header));
+        for (size_t c = 0; c < channelNames.size(); ++c) {
+            ChannelEntry entry = {};
+            std::memcpy(entry.name, channelNames[c].data(), channelNames[c].size());
+            entry.offset = channelOffsets[c];
+            std::memcpy(base + sizeof(FileHeader) + c * sizeof(ChannelEntry), &entry, sizeof(entry));
+        }
+        out.flush();
+        stats.rows = static_cast<size_t>(rows);
+    }
+
+    std::error_code ec;
+    fs::rename(fs::u8path(tmpPath), fs::u8path(storePath), ec);
+    if (ec) {
+        fs::remove(fs::u8path(tmpPath), ec);
+        throw ConfigException("无法写入分析文件: " + storePath);
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return stats;
+}
+
+// ===== 打开 =====
+
+DriftLogStore DriftLogStore::open(const std::string& storePath) {
+    DriftLogStore store;
+    store.file = MappedFile::open(storePath);
+    const char* base = store.file.data();
+    const size_t size = store.file.size();
+
+    FileHeader header;
+    if (size < sizeof(header)) {
+        throw ConfigException("不是有效的分析文件: " + storePath);
+    }
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        throw ConfigException("不是有效的分析文件或版本不符: " + storePath);
+    }
+    auto inBounds = [&](uint64_t offset, uint64_t bytes) {
+        return offset % kAlignment == 0 && offset <= size && bytes <= size - offset;
+    };
+    const uint64_t tableSize = sizeof(FileHeader) + static_cast<uint64_t>(header.channelCount) * sizeof(ChannelEntry);
+    if (header.rowCount > header.capacity || tableSize > size ||
+        !inBounds(header.timeOffset, header.capacity * sizeof(double))) {
+        throw ConfigException("分析文件已损坏: " + storePath);
+    }
+
+    for (uint32_t c = 0; c < header.channelCount; ++c) {
+        ChannelEntry entry;
+        std::memcpy(&entry, base + sizeof(FileHeader) + c * sizeof(ChannelEntry), sizeof(entry));
+        if (!inBounds(entry.offset, header.capacity * sizeof(float))) {
+            throw ConfigException("分析文件已损坏: " + storePath);
+        }
+        entry.name[sizeof(entry.name) - 1] = '\0';
+        store.names.emplace_back(entry.name);
+        store.columns.push_back(reinterpret_cast<const float*>(base + entry.offset));
+    }
+    store.timeIndex = reinterpret_cast<const double*>(base + header.timeOffset);
+    store.rowCount = static_cast<size_t>(header.rowCount);
+    store.malformed = static_cast<size_t>(header.malformedLines);
+    store.timeColumn = (header.flags & kFlagHasTime) != 0;
+    store.sorted = (header.flags & kFlagTimeSorted) != 0;
+    return store;
+}
+
+DriftLogStore DriftLogStore::openOrConvert(const std::string& path) {
+    const fs::path source = fs::u8path(path);
+    if (source.extension() == kExtension) {
+        return open(path);
+    }
+
+    const std::string storePath = path + kExtension;
+    std::error_code ec;
+    const fs::path cached = fs::u8path(storePath);
+    if (fs::exists(cached, ec) && fs::last_write_time(cached, ec) >= fs::last_write_time(source, ec) && !ec) {
+        try {
+            return open(storePath);
+        } catch (const ConfigException&) {
+            // 缓存损坏或版本不符，重新转换
+        }
+    }
+    convert(path, storePath);
+    return open(storePath);
+}
+
+const float* DriftLogStore::channel(const std::string& name) const {
+    const std::string key = lower(name);
+    for (size_t c = 0; c < names.size(); ++c) {
+        if (names[c] == key) {
+            return columns[c];
+        }
+    }
+    return nullptr;
+}
+
+// ===== 查询 =====
+
+DriftLogStore::Stats DriftLogStore::stats(const std::string& channelName, const std::vector<Condition>& where,
+                                          double tFrom, double tTo) const {
+    return statsWith(activeImpl(), channelName, where, tFrom, tTo);
+}
+
+DriftLogStore::Stats DriftLogStore::statsWith(Impl impl, const std::string& channelName,
+                                              const std::vector<Condition>& where, double tFrom, double tTo) const {
+    const float* values = channel(channelName);
+    if (!values) {
+        throw ConfigException("分析文件中没有通道: " + channelName);
+    }
+    std::vector<ResolvedCondition> conditions;
+    for (const Condition& condition : where) {
+        const float* column = channel(condition.channel);
+        if (!column) {
+            throw ConfigException("分析文件中没有通道: " + condition.channel);
+        }
+        conditions.push_back({column, condition.op, static_cast<float>(condition.value)});
+    }
+
+    // 时间有序时二分得到行区间；乱序时逐行比较时间（只有标量实现支持）
+    size_t begin = 0;
+    size_t end = rowCount;
+    const double* rowTime = nullptr;
+    const bool timeFiltered = tFrom > -std::numeric_limits<double>::infinity() ||
+                              tTo < std::numeric_limits<double>::infinity();
+    if (timeFiltered) {
+        if (sorted) {
+            begin = static_cast<size_t>(std::lower_bound(timeIndex, timeIndex + rowCount, tFrom) - timeIndex);
+            end = static_cast<size_t>(std::upper_bound(timeIndex + begin, timeIndex + rowCount, tTo) - timeIndex);
+        } else {
+            rowTime = timeIndex;
+            impl = Impl::Scalar;
+        }
+    }
+
+    float pivot = 0.0f;
+    for (size_t i = begin; i < end; ++i) {
+        if (!std::isnan(values[i])) {
+            pivot = values[i];
+            break;
+        }
+    }
+
+    Accumulator acc;
+    size_t scanned = begin;
+#ifdef ADJUSTBIAS_STORE_X86
+    if (impl == Impl::AVX2 && isSupported(Impl::AVX2)) {
+        scanned = scanAVX2(values, conditions, begin, end, pivot, acc);
+    }
+#endif
+    scanScalar(values, conditions, rowTime, tFrom, tTo, scanned, end, pivot, acc);
+
+    Stats result;
+    result.count = acc.count;
+    if (acc.count == 0) {
+        return result;
+    }
+    const double n = static_cast<double>(acc.count);
+    result.mean = pivot + acc.sum / n;
+    result.stddev = acc.count > 1 ? std::sqrt(std::max(0.0, (acc.sumSq - acc.sum * acc.sum / n) / (n - 1.0))) : 0.0;
+    result.min = acc.min;
+    result.max = acc.max;
+    return result;
+}
+
+bool DriftLogStore::parseCondition(const std::string& text, Condition& condition) {
+    std::string_view rest(text);
+    bool absolute = false;
+    std::string_view name;
+    if (!rest.empty() && rest.front() == '|') {
+        const size_t close = rest.find('|', 1);
+        if (close == std::string_view::npos) {
+            return false;
+        }
+        name = rest.substr(1, close - 1);
+        rest.remove_prefix(close + 1);
+        absolute = true;
+    } else {
+        const size_t op = rest.find_first_of("<>=!");
+        if (op == std::string_view::npos) {
+            return false;
+        }
+        name = rest.substr(0, op);
+        rest.remove_prefix(op);
+    }
+
+    static const struct {
+        const char* text;
+        Condition::Op op;
+    } ops[] = {
+        {"<=", Condition::Le}, {">=", Condition::Ge}, {"!=", Condition::Ne}, {"==", Condition::Eq},
+        {"<", Condition::Lt},  {">", Condition::Gt},  {"=", Condition::Eq},
+    };
+    bool found = false;
+    for (const auto& candidate : ops) {
+        const size_t opLen = std::strlen(candidate.text);
+        if (rest.substr(0, opLen) == candidate.text) {
+            condition.op = candidate.op;
+            rest.remove_prefix(opLen);
+            found = true;
+            break;
+        }
+    }
+    if (!found || name.empty()) {
+        return false;
+    }
+    if (absolute) {
+        if (condition.op != Condition::Lt && condition.op != Condition::Le) {
+            return false;
+        }
+        condition.op = condition.op == Condition::Lt ? Condition::AbsLt : Condition::AbsLe;
+    }
+
+    condition.channel = lower(name);
+    return TelemetryLineParser::parseNumber(rest, condition.value) || parseGaitValue(rest, condition.value);
+}
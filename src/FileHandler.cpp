@@ -1,9 +1,87 @@
 #include "FileHandler.h"
+#include "RetryPolicy.h"
+#include "RemoteCommandExecutor.h"
+#include "ResourceManager.h"
+#include "Sha256.h"
+#include "Utf8Path.h"
+#include <algorithm>
+#include <filesystem>
 #include <QDebug>
 
 FileHandler::FileHandler(SSHManager* manager) : sshManager(manager) {}
 
+FileHandler::~FileHandler() {
+    try {
+        if (sftp) {
+            auto sessionLock = sshManager->lockSession();
+            libssh2_sftp_shutdown(sftp);
+            sftp = nullptr;
+        }
+    } catch (...) {
+        // 析构函数不应抛出异常
+    }
+}
+
+LIBSSH2_SFTP* FileHandler::getSftp() {
+    auto sessionLock = sshManager->lockSession();
+    LIBSSH2_SESSION* session = sshManager->getSession();
+    if (!session) {
+        throw SSHException("无法获取有效的SSH会话，无法启动SFTP");
+    }
+    if (sftp && sftpSession == session) {
+        return sftp;
+    }
+    // 旧会话已被 SSHManager 重连替换，其 SFTP 句柄随旧会话一起失效，不能再 shutdown
+    libssh2_session_set_blocking(session, 1);
+    sftp = libssh2_sftp_init(session);
+    sftpSession = session;
+    if (!sftp) {
+        char* errmsg;
+        libssh2_session_last_error(session, &errmsg, nullptr, 0);
+        sftpSession = nullptr;
+        throw SSHException(string("SFTP initialization failed: ") + errmsg);
+    }
+    return sftp;
+}
+
+string FileHandler::sftpError(const string& what) {
+    auto sessionLock = sshManager->lockSession();
+    string message = what;
+    if (sftp) {
+        message += " (sftp error " + to_string(libssh2_sftp_last_error(sftp)) + ")";
+    }
+    if (sftpSession) {
+        char* errmsg = nullptr;
+        libssh2_session_last_error(sftpSession, &errmsg, nullptr, 0);
+        if (errmsg && *errmsg) {
+            message += string(": ") + errmsg;
+        }
+    }
+    return message;
+}
+
+string FileHandler::shellQuote(const string& value) {
+    string quoted = "'";
+    for (char c : value) {
+        if (c == '\'') {
+            quoted += "'\\''";
+        } else {
+            quoted += c;
+        }
+    }
+    quoted += "'";
+    return quoted;
+}
+
 void FileHandler::uploadFile(const string& localPath, const string& remotePath) {
+    uploadFile(localPath, remotePath, UploadOptions());
+}
+
+// ===== 大缓冲区非阻塞 SCP 上传 =====
+// 每次读取 bufferSize 字节，libssh2_channel_write 可能只写出一部分（受对端窗口限制）或返回 EAGAIN，
+// 此时按会话阻塞方向等待 socket 就绪后继续写剩余部分，而不是把短写当成失败。
+FileHandler::UploadResult FileHandler::uploadFile(const string& localPath, const string& remotePath,
+                                                  const UploadOptions& options) {
     LIBSSH2_SESSION* session = sshManager->getSession();
     if (!session) {
         throw SSHException("无法获取有效的SSH会话，无法上传文件");
@@ -16,15 +94,17 @@ void FileHandler::uploadFile(const string& localPath, const string& remotePath)
     }
 
     // 获取文件大小
-    streamsize fileSize = file.tellg();
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
     file.seekg(0, ios::beg);
 
-    // 创建SCP通道
-    LIBSSH2_CHANNEL* scpChannel = libssh2_scp_send(
-        session, 
-        remotePath.c_str(), 
-        0700,
-        static_cast<size_t>(fileSize)
+    // 创建SCP通道（阻塞模式下完成 scp 协议握手）
+    libssh2_session_set_blocking(session, 1);
+    LIBSSH2_CHANNEL* scpChannel = libssh2_scp_send64(
+        session,
+        remotePath.c_str(),
+        options.mode,
+        static_cast<libssh2_int64_t>(fileSize),
+        0, 0
     );
 
     if (!scpChannel) {
@@ -32,86 +112,371 @@ void FileHandler::uploadFile(const string& localPath, const string& remotePath)
         char* errmsg;
         libssh2_session_last_error(session, &errmsg, nullptr, 0);
         error += errmsg;
-        file.close();
         throw SSHException(error);
     }
+    ResourceManagement::ChannelGuard channelGuard(scpChannel, session);
+
+    UploadResult result;
+    Sha256 sha;
+    vector<char> buffer(max<size_t>(options.bufferSize, 1));
+    const auto startTime = chrono::steady_clock::now();
+    const auto stallTimeout = chrono::milliseconds(options.stallTimeoutMs);
+
+    {
+        ResourceManagement::NonBlockingScope nonBlocking(session);
+        auto lastProgress = startTime;
+
+        while (result.bytes < fileSize) {
+            const size_t toRead = static_cast<size_t>(min<uint64_t>(buffer.size(), fileSize - result.bytes));
+            file.read(buffer.data(), static_cast<streamsize>(toRead));
+            const size_t bytesRead = static_cast<size_t>(file.gcount());
+            if (bytesRead == 0) {
+                throw SSHException("读取本地文件失败: " + localPath);
+            }
+            sha.update(buffer.data(), bytesRead);
+
+            size_t offset = 0;
+            while (offset < bytesRead) {
+                if (g_interrupted) {
+                    throw OperationCancelledException("上传已中断: " + remotePath);
+                }
+
+                ssize_t written = libssh2_channel_write(scpChannel, buffer.data() + offset, bytesRead - offset);
+                if (written > 0) {
+                    offset += static_cast<size_t>(written);
+                    result.bytes += static_cast<uint64_t>(written);
+                    lastProgress = chrono::steady_clock::now();
+                    continue;
+                }
+                if (written != LIBSSH2_ERROR_EAGAIN && written != 0) {
+                    char* errmsg;
+                    libssh2_session_last_error(session, &errmsg, nullptr, 0);
+                    throw SSHException(string("File upload failed: ") + errmsg);
+                }
+                if (chrono::steady_clock::now() - lastProgress > stallTimeout) {
+                    throw NetworkException("上传停滞超时: " + remotePath);
+                }
+                sshManager->waitSocket(200);
+            }
 
-    // 上传文件内容
-    vector<char> buffer(1024);
-    while (!file.eof() && !g_interrupted) {
-        file.read(buffer.data(), buffer.size());
-        int bytesRead = static_cast<int>(file.gcount());
-        
-        if (libssh2_channel_write(scpChannel, buffer.data(), bytesRead) != bytesRead) {
-            file.close();
-            libssh2_channel_send_eof(scpChannel);
-            libssh2_channel_close(scpChannel);
-            libssh2_channel_free(scpChannel);
-            throw SSHException("File upload failed");
+            if (options.progress && !options.progress(result.bytes, fileSize)) {
+                throw OperationCancelledException("上传已取消: " + remotePath);
+            }
         }
     }
     file.close();
-    
-    // 关闭SCP通道
+
+    // 关闭SCP通道并等待远端 scp 确认写完
     libssh2_channel_send_eof(scpChannel);
-    libssh2_channel_close(scpChannel);
-    libssh2_channel_free(scpChannel);
+    libssh2_channel_wait_eof(scpChannel);
+    libssh2_channel_wait_closed(scpChannel);
+
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    result.sha256 = sha.finishHex();
+
+    if (options.verifyChecksum) {
+        RemoteCommandExecutor executor(sshManager, "sha256sum -- " + shellQuote(remotePath), false);
+        executor.execute();
+        string output;
+        int exitCode = executor.waitForExit(&output);
+        string remoteHash = output.substr(0, min<size_t>(64, output.size()));
+        if (exitCode != 0 || remoteHash != result.sha256) {
+            throw RemoteCommandException("上传校验失败: " + remotePath + " 本地 " + result.sha256 +
+                                         " 远端 " + (remoteHash.empty() ? executor.getStderr() : remoteHash));
+        }
+        result.verified = true;
+    }
+
+    return result;
 }
 
-void FileHandler::removeRemoteFile(const string& remotePath, int maxRetries) {
-    for (int attempt = 0; attempt < maxRetries; ++attempt) {
-        try {
-            LIBSSH2_SESSION* session = sshManager->getSession();
-            if (!session) {
-                if (attempt < maxRetries - 1) {
-                    qDebug() << "无法获取有效SSH会话，尝试重连 (" << (attempt + 1) << "/" << maxRetries << ")...";
-                    continue;
-                } else {
-                    throw SSHException("无法获取有效SSH会话，删除文件失败");
-                }
-            }
+DirectorySync::Report FileHandler::syncDirectory(const string& localDir, const string& remoteDir,
+                                                 const DirectorySync::Options& options) {
+    DirectorySync sync(sshManager);
+    return sync.sync(localDir, remoteDir, options);
+}
 
-            LIBSSH2_CHANNEL* rmChannel = libssh2_channel_open_session(session);
-            if (!rmChannel) {
-                if (attempt < maxRetries - 1) {
-                    qDebug() << "删除通道打开失败，尝试重新连接 (" << (attempt + 1) << "/" << maxRetries << ")...";
-                    continue;
-                } else {
-                    throw SSHException("Failed to open channel for rm command after " + to_string(maxRetries) + " attempts");
-                }
+// ===== SFTP 下载 =====
+FileHandler::DownloadResult FileHandler::downloadFile(const string& remotePath, const string& localPath) {
+    return downloadFile(remotePath, localPath, DownloadOptions());
+}
+
+FileHandler::DirectoryDownloadReport FileHandler::downloadDirectory(const string& remoteDir, const string& localDir) {
+    return downloadDirectory(remoteDir, localDir, DownloadOptions());
+}
+
+FileHandler::DownloadResult FileHandler::downloadFile(const string& remotePath, const string& localPath,
+                                                      const DownloadOptions& options) {
+    LIBSSH2_SFTP* sftpHandle = getSftp();
+
+    LIBSSH2_SFTP_ATTRIBUTES attrs;
+    if (withSession([&]() { return libssh2_sftp_stat(sftpHandle, remotePath.c_str(), &attrs); }) != 0) {
+        throw SSHException(sftpError("无法获取远端文件信息: " + remotePath));
+    }
+
+    DownloadResult result;
+    result.fileSize = (attrs.flags & LIBSSH2_SFTP_ATTR_SIZE) ? static_cast<uint64_t>(attrs.filesize) : 0;
+
+    const filesystem::path target = filesystem::u8path(localPath);
+    filesystem::path partPath = target;
+    partPath += ".part";
+    filesystem::path metaPath = target;
+    metaPath += ".part.meta";
+    if (target.has_parent_path()) {
+        filesystem::create_directories(target.parent_path());
+    }
+
+    // 续传：.part.meta 记录开始下载时远端文件的 大小 修改时间，两者都未变化才从 .part 末尾继续；
+    // 远端文件被重写、追加或轮转（即使又长到比 .part 大）都从头下载，不会拼出损坏的文件
+    const bool hasMtime = (attrs.flags & LIBSSH2_SFTP_ATTR_ACMODTIME) != 0;
+    const string remoteStamp = to_string(result.fileSize) + " " + to_string(static_cast<uint64_t>(attrs.mtime));
+    error_code ec;
+    if (options.resume && hasMtime && filesystem::exists(partPath, ec)) {
+        string savedStamp;
+        ifstream meta(metaPath, ios::binary);
+        getline(meta, savedStamp);
+        uint64_t partSize = static_cast<uint64_t>(filesystem::file_size(partPath, ec));
+        if (!ec && savedStamp == remoteStamp && partSize <= result.fileSize) {
+            result.resumedFrom = partSize;
+        }
+    }
+    if (result.resumedFrom == 0) {
+        filesystem::remove(metaPath, ec);
+        if (hasMtime) {
+            ofstream meta(metaPath, ios::binary | ios::trunc);
+            meta << remoteStamp << "\n";
+        }
+    }
+
+    ofstream out(partPath, ios::binary | (result.resumedFrom > 0 ? ios::app : ios::trunc));
+    if (!out.is_open()) {
+        throw SSHException("无法写入本地文件: " + utf8Path(partPath));
+    }
+
+    LIBSSH2_SFTP_HANDLE* handle =
+        withSession([&]() { return libssh2_sftp_open(sftpHandle, remotePath.c_str(), LIBSSH2_FXF_READ, 0); });
+    if (!handle) {
+        throw SSHException(sftpError("无法打开远端文件: " + remotePath));
+    }
+    ResourceManagement::ScopeGuard handleGuard([this, handle]() {
+        withSession([handle]() { return libssh2_sftp_close(handle); });
+    });
+    if (result.resumedFrom > 0) {
+        withSession([&]() { libssh2_sftp_seek64(handle, result.resumedFrom); });
+    }
+    LIBSSH2_SESSION* session = sftpSession;
+
+    vector<char> buffer(max<size_t>(options.bufferSize, 32 * 1024));
+    const auto startTime = chrono::steady_clock::now();
+    uint64_t received = result.resumedFrom;
+
+    while (true) {
+        if (g_interrupted) {
+            throw OperationCancelledException("下载已中断: " + remotePath);
+        }
+
+        // 读取超时由 libssh2 会话超时实现：会话超时是全局设置，只在持锁的这一次读取期间生效
+        ssize_t n = withSession([&]() {
+            const long previousTimeout = libssh2_session_get_timeout(session);
+            libssh2_session_set_timeout(session, options.stallTimeoutMs);
+            const ssize_t got = libssh2_sftp_read(handle, buffer.data(), buffer.size());
+            libssh2_session_set_timeout(session, previousTimeout);
+            return got;
+        });
+        if (n == 0) {
+            break;
+        }
+        if (n < 0) {
+            // .part 保留在磁盘上，下次调用可以续传
+            throw SSHException(sftpError("读取远端文件失败: " + remotePath));
+        }
+
+        out.write(buffer.data(), n);
+        if (!out) {
+            throw SSHException("写入本地文件失败: " + utf8Path(partPath));
+        }
+        received += static_cast<uint64_t>(n);
+        result.bytes += static_cast<uint64_t>(n);
+
+        if (options.progress && !options.progress(received, result.fileSize)) {
+            throw OperationCancelledException("下载已取消: " + remotePath);
+        }
+    }
+    out.close();
+
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+    filesystem::rename(partPath, target, ec);
+    if (ec) {
+        throw SSHException("重命名下载文件失败: " + utf8Path(partPath) + " -> " + localPath + ": " + ec.message());
+    }
+    filesystem::remove(metaPath, ec);
+    return result;
+}
+
+FileHandler::DirectoryDownloadReport FileHandler::downloadDirectory(const string& remoteDir, const string& localDir,
+                                                                    const DownloadOptions& options) {
+    LIBSSH2_SFTP* sftpHandle = getSftp();
+    DirectoryDownloadReport report;
+    const auto startTime = chrono::steady_clock::now();
+
+    // 先遍历远端目录树得到文件列表（相对路径），再逐个下载；每个文件都通过 read-ahead 跑满链路
+    vector<string> files;
+    vector<string> pending = {""};
+    vector<char> name(1024);
+    while (!pending.empty()) {
+        string rel = pending.back();
+        pending.pop_back();
+        string dirPath = rel.empty() ? remoteDir : remoteDir + "/" + rel;
+
+        LIBSSH2_SFTP_HANDLE* dir = withSession([&]() { return libssh2_sftp_opendir(sftpHandle, dirPath.c_str()); });
+        if (!dir) {
+            report.failures.emplace_back(rel, sftpError("无法打开远端目录"));
+            continue;
+        }
+        LIBSSH2_SFTP_ATTRIBUTES attrs;
+        int len;
+        while ((len = withSession([&]() { return libssh2_sftp_readdir(dir, name.data(), name.size(), &attrs); })) > 0) {
+            string entry(name.data(), static_cast<size_t>(len));
+            if (entry == "." || entry == "..") {
+                continue;
+            }
+            string child = rel.empty() ? entry : rel + "/" + entry;
+            if (!(attrs.flags & LIBSSH2_SFTP_ATTR_PERMISSIONS)) {
+                continue;
             }
+            if (LIBSSH2_SFTP_S_ISDIR(attrs.permissions)) {
+                pending.push_back(child);
+            } else if (LIBSSH2_SFTP_S_ISREG(attrs.permissions)) {
+                files.push_back(child);
+            }
+        }
+        withSession([dir]() { return libssh2_sftp_closedir(dir); });
+    }
 
-            string command = "rm -f " + remotePath;
-            if (libssh2_channel_exec(rmChannel, command.c_str()) == 0) {
-                // 等待命令执行完成
-                char buffer[1024];
-                int bytesRead;
-                do {
-                    bytesRead = libssh2_channel_read(rmChannel, buffer, sizeof(buffer));
-                } while (bytesRead > 0);
-                
-                // 检查退出状态
-                int exitCode = libssh2_channel_get_exit_status(rmChannel);
-                libssh2_channel_close(rmChannel);
-                libssh2_channel_free(rmChannel);
-                
-                if (exitCode == 0) {
-                    qDebug() << "远程文件 " << remotePath << " 删除成功";
-                    return;
-                } else {
-                    throw SSHException("Failed to delete remote file. Exit code: " + to_string(exitCode));
-                }
-            } else {
-                libssh2_channel_close(rmChannel);
-                libssh2_channel_free(rmChannel);
-                throw SSHException("Failed to execute rm command");
+    for (const auto& rel : files) {
+        try {
+            DownloadResult result = downloadFile(remoteDir + "/" + rel,
+                                                 utf8Path(filesystem::u8path(localDir) / filesystem::u8path(rel)),
+                                                 options);
+            report.files++;
+            report.bytes += result.bytes;
+        } catch (const OperationCancelledException&) {
+            throw;
+        } catch (const exception& e) {
+            report.failures.emplace_back(rel, e.what());
+        }
+    }
+
+    report.seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    qDebug() << "目录下载完成:" << QString::fromStdString(remoteDir) << "文件" << report.files
+             << "失败" << report.failures.size() << "吞吐量" << report.throughputMBps() << "MB/s";
+    return report;
+}
+
+void FileHandler::removeRemoteFile(const string& remotePath, int maxRetries) {
+    removeRemoteFiles({remotePath}, false, maxRetries);
+    qDebug() << "远程文件 " << remotePath << " 删除成功";
+}
+
+string FileHandler::globQuote(const string& pattern) {
+    string quoted;
+    string literal;
+    auto flushLiteral = [&]() {
+        if (!literal.empty()) {
+            quoted += shellQuote(literal);
+            literal.clear();
+        }
+    };
+
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        char c = pattern[i];
+        if (c == '*' || c == '?') {
+            flushLiteral();
+            quoted += c;
+        } else if (c == '[') {
+            // 只接受由字母数字和 !-^ 组成的简单字符类，其它情况按字面处理
+            size_t close = pattern.find(']', i + 1);
+            bool simple = close != string::npos && close > i + 1;
+            for (size_t j = i + 1; simple && j < close; ++j) {
+                char k = pattern[j];
+                simple = isalnum(static_cast<unsigned char>(k)) || k == '!' || k == '-' || k == '^' || k == '_' || k == '.';
             }
-        } catch (const SSHException& e) {
-            if (attempt == maxRetries - 1) {
-                throw; // 最后一次尝试仍然失败，重新抛出异常
+            if (simple) {
+                flushLiteral();
+                quoted += pattern.substr(i, close - i + 1);
+                i = close;
+            } else {
+                literal += c;
             }
-            qDebug() << "删除尝试 " << (attempt + 1) << " 失败: " << e.what();
-            this_thread::sleep_for(chrono::seconds(1)); // 等待1秒后重试
+        } else {
+            literal += c;
+        }
+    }
+    flushLiteral();
+    return quoted;
+}
+
+size_t FileHandler::removeRemoteFiles(const vector<string>& paths, bool allowGlob, int maxRetries) {
+    if (paths.empty()) {
+        return 0;
+    }
+
+    // 拼成尽量少的命令；-v 每删除一个文件输出一行，用于统计
+    const size_t maxCommandLength = 64 * 1024;
+    const string prefix = "rm -fv --";
+    vector<string> commands;
+    string command = prefix;
+    for (const auto& path : paths) {
+        string arg = " " + (allowGlob ? globQuote(path) : shellQuote(path));
+        if (command.size() > prefix.size() && command.size() + arg.size() > maxCommandLength) {
+            commands.push_back(command);
+            command = prefix;
         }
+        command += arg;
+    }
+    commands.push_back(command);
+
+    // rm 本身失败（权限不足等）抛出 RemoteCommandException，不重试
+    RetryPolicy::Options retryOptions;
+    retryOptions.maxAttempts = max(1, maxRetries);
+    retryOptions.cancel = &g_interrupted;
+    size_t removed = 0;
+    for (const auto& rmCommand : commands) {
+        RetryPolicy retry("removeRemoteFiles", sshManager, retryOptions);
+        removed += retry.run([&]() {
+            RemoteCommandExecutor executor(sshManager, rmCommand, false);
+            executor.execute();
+            string output;
+            int exitCode = executor.waitForExit(&output);
+            if (exitCode != 0) {
+                throw RemoteCommandException("rm failed (exit " + to_string(exitCode) + "): " + executor.getStderr());
+            }
+            return static_cast<size_t>(count(output.begin(), output.end(), '\n'));
+        });
     }
-}
\ No newline at end of file
+    return removed;
+}
+
+size_t FileHandler::cleanupOrphanedTempFiles(const string& targetPath, int minAgeMinutes) {
+    size_t slash = targetPath.rfind('/');
+    const string dir = slash == string::npos ? "." : targetPath.substr(0, slash == 0 ? 1 : slash);
+    const string name = slash == string::npos ? targetPath : targetPath.substr(slash + 1);
+
+    // 单条 find 完成匹配和删除，不需要先列出再逐个 rm
+    string command = "find " + shellQuote(dir) + " -maxdepth 1 -type f -name " + shellQuote(name + ".tmp.*") +
+                     " -mmin +" + to_string(max(0, minAgeMinutes)) + " -print -delete";
+    RemoteCommandExecutor executor(sshManager, command, false);
+    executor.execute();
+    string output;
+    int exitCode = executor.waitForExit(&output);
+    if (exitCode != 0) {
+        throw RemoteCommandException("清理临时文件失败 (exit " + to_string(exitCode) + "): " + executor.getStderr());
+    }
+
+    size_t removed = static_cast<size_t>(count(output.begin(), output.end(), '\n'));
+    if (removed > 0) {
+        qDebug() << "已清理残留临时文件" << removed << "个:" << QString::fromStdString(targetPath + ".tmp.*");
+    }
+    return removed;
+}
@@ -0,0 +1,350 @@
+#include "FleetAudit.h"
+#include "AsyncRemote.h"
+#include "ConfigReader.h"
+#include "Exceptions.h"
+#include "FileHandler.h"
+#include "RemoteCommandExecutor.h"
+#include "SSHManager.h"
+#include "TelemetryParser.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+FleetAudit::HostResult auditHost(const FleetHost& host, const FleetAudit::Options& options) {
+    FleetAudit::HostResult result;
+    result.host = host;
+    const auto started = std::chrono::steady_clock::now();
+    try {
+        std::unique_ptr<SSHManager> ssh = FleetAudit::connect(host, options);
+        result.authMethod = ssh->getAuthMethod();
+        const std::string content =
+            FleetAudit::execute(*ssh, "cat -- " + FileHandler::shellQuote(options.configPath), options.commandTimeoutMs);
+
+        ConfigReader reader(ssh.get(), options.configPath);
+        std::string deduped;
+        if (!reader.parseConfigContent(content, deduped)) {
+            throw ConfigException("配置文件解析失败");
+        }
+        result.values = reader.parsedValues;
+        result.ok = true;
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    result.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    return result;
+}
+
+#ifdef ADJUSTBIAS_HAS_COROUTINES
+struct AsyncAuditState {
+    AsyncLoop& loop;
+    const std::vector<FleetHost>& hosts;
+    const FleetAudit::Options& options;
+    const FleetAudit::Progress& progress;
+    std::vector<FleetAudit::HostResult> results;
+    std::atomic<size_t> done{0};
+    std::mutex progressMutex;
+};
+
+// 与 auditHost 相同的流程：建连与断开在阻塞线程池中执行，cat 在事件循环上等待，不占用线程。
+// 状态通过参数传入（不用带捕获的 lambda 协程，lambda 对象在协程挂起后就已销毁）
+AsyncTask<void> auditHostAsync(AsyncAuditState& state, size_t index) {
+    const FleetHost& host = state.hosts[index];
+    const FleetAudit::Options& options = state.options;
+    FleetAudit::HostResult& result = state.results[index];
+    result.host = host;
+    const auto started = std::chrono::steady_clock::now();
+    std::unique_ptr<SSHManager> ssh;
+    try {
+        ssh = co_await state.loop.offload([&]() { return FleetAudit::connect(host, options); });
+        result.authMethod = ssh->getAuthMethod();
+
+        AsyncSession session(state.loop, *ssh);
+        const AsyncSession::ExecResult r = co_await session.exec(
+            "cat -- " + FileHandler::shellQuote(options.configPath), std::string(), options.commandTimeoutMs);
+        if (r.exitCode != 0) {
+            std::string error = r.error;
+            error.erase(error.find_last_not_of(" \t\r\n") + 1);
+            throw RemoteCommandException(error.empty() ? "退出码 " + std::to_string(r.exitCode) : error);
+        }
+
+        ConfigReader reader(ssh.get(), options.configPath);
+        std::string deduped;
+        if (!reader.parseConfigContent(r.output, deduped)) {
+            throw ConfigException("配置文件解析失败");
+        }
+        result.values = reader.parsedValues;
+        result.ok = true;
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    if (ssh) {
+        // 断开连接会等待远端应答，同样交给阻塞线程
+        co_await state.loop.offload([&]() { ssh.reset(); });
+    }
+    result.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+
+    const size_t finished = state.done.fetch_add(1) + 1;
+    if (state.progress) {
+        std::lock_guard<std::mutex> lock(state.progressMutex);
+        state.progress(result, finished, state.hosts.size());
+    }
+}
+#endif
+
+std::vector<FleetAudit::HostResult> runCoroutines(const std::vector<FleetHost>& hosts,
+                                                  const FleetAudit::Options& options,
+                                                  const FleetAudit::Progress& progress) {
+#ifdef ADJUSTBIAS_HAS_COROUTINES
+    AsyncLoop loop(2, std::max(1, options.jobs));
+    AsyncAuditState state{loop, hosts, options, progress, std::vector<FleetAudit::HostResult>(hosts.size())};
+    for (size_t i = 0; i < hosts.size(); ++i) {
+        loop.spawn(auditHostAsync(state, i));
+    }
+    loop.wait();
+    return std::move(state.results);
+#else
+    (void)hosts;
+    (void)options;
+    (void)progress;
+    throw ConfigException("协程引擎需要 C++20 构建（CMake 选项 ADJUSTBIAS_CXX20=ON）");
+#endif
+}
+
+} // namespace
+
+// ===== 清单解析 =====
+
+std::vector<FleetHost> FleetInventory::parse(const std::string& text) {
+    std::vector<FleetHost> hosts;
+    std::istringstream in(text);
+    std::string line;
+    int lineNumber = 0;
+    std::string_view fields[4];
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        const int count = TelemetryLineParser::split(line, fields, 4);
+        if (count == 0) {
+            continue;
+        }
+
+        FleetHost host;
+        const std::string address(fields[0]);
+        const size_t colon = address.rfind(':');
+        host.host = address.substr(0, colon);
+        if (colon != std::string::npos) {
+            double port = 0.0;
+            if (!TelemetryLineParser::parseNumber(std::string_view(address).substr(colon + 1), port) || port < 1 ||
+                port > 65535 || port != static_cast<int>(port)) {
+                throw ConfigException("清单第 " + std::to_string(lineNumber) + " 行端口无效: " + address);
+            }
+            host.port = static_cast<int>(port);
+        }
+        if (host.host.empty()) {
+            throw ConfigException("清单第 " + std::to_string(lineNumber) + " 行缺少主机地址");
+        }
+        if (count > 1) {
+            host.username = std::string(fields[1]);
+        }
+        host.name = count > 2 ? std::string(fields[2]) : host.host;
+        hosts.push_back(host);
+    }
+    return hosts;
+}
+
+std::vector<FleetHost> FleetInventory::loadFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw ConfigException("无法打开机器人清单: " + path);
+    }
+    std::ostringstream content;
+    content << in.rdbuf();
+    return parse(content.str());
+}
+
+// ===== 并发审计 =====
+
+std::vector<FleetAudit::HostResult> FleetAudit::run(const std::vector<FleetHost>& hosts, const Options& options,
+                                                    const Progress& progress) {
+    if (options.engine == Engine::Coroutines) {
+        return runCoroutines(hosts, options, progress);
+    }
+    std::vector<HostResult> results(hosts.size());
+    std::atomic<size_t> done{0};
+    std::mutex progressMutex;
+    forEachParallel(hosts.size(), options.jobs, [&](size_t i) {
+        results[i] = auditHost(hosts[i], options);
+        const size_t finished = done.fetch_add(1) + 1;
+        if (progress) {
+            std::lock_guard<std::mutex> lock(progressMutex);
+            progress(results[i], finished, hosts.size());
+        }
+    });
+    return results;
+}
+
+void FleetAudit::forEachParallel(size_t count, int jobs, const std::function<void(size_t index)>& task) {
+    if (count == 0) {
+        return;
+    }
+    // 固定数量的工作线程从共享下标领取任务，慢主机不会阻塞队列中的其他主机
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            task(i);
+        }
+    };
+
+    const size_t threads = std::min(count, static_cast<size_t>(std::max(1, jobs)));
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+
+std::unique_ptr<SSHManager> FleetAudit::connect(const FleetHost& host, const Options& options) {
+    // 超时只作用于本连接：修改进程默认值会影响界面等其他同时建连的调用方
+    return std::make_unique<SSHManager>(host.host, host.username, SSHAuthOptions::preferKeys(options.password),
+                                        host.port, TransportProfileRegistry::forHost(host.host),
+                                        options.connectTimeoutMs);
+}
+
+std::string FleetAudit::execute(SSHManager& ssh, const std::string& command, int timeoutMs) {
+    RemoteCommandExecutor executor(&ssh, command, false);
+    executor.execute();
+    std::string output;
+    const int status = executor.waitForExit(&output, timeoutMs);
+    if (status != 0) {
+        std::string error = executor.getStderr();
+        error.erase(error.find_last_not_of(" \t\r\n") + 1);
+        throw RemoteCommandException(status < 0 ? "命令执行超时"
+                                     : error.empty() ? "退出码 " + std::to_string(status)
+                                                     : error);
+    }
+    return output;
+}
+
+// ===== 输出格式 =====
+
+std::string FleetAudit::csvField(const std::string& s) {
+    if (s.find_first_of(",\"\n\r") == std::string::npos) {
+        return s;
+    }
+    std::string quoted = "\"";
+    for (char c : s) {
+        quoted += c;
+        if (c == '"') {
+            quoted += '"';
+        }
+    }
+    return quoted + "\"";
+}
+
+std::string FleetAudit::jsonString(const std::string& s) {
+    std::ostringstream out;
+    out << '"';
+    for (unsigned char c : s) {
+        switch (c) {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\r': out << "\\r"; break;
+        case '\t': out << "\\t"; break;
+        default:
+            if (c < 0x20) {
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+            } else {
+                out << c;
+            }
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+// 与配置文件保持相同的有效数字，避免 0.1 输出成 0.10000000000000001
+std::string FleetAudit::formatValue(double value) {
+    std::ostringstream out;
+    out << std::setprecision(12) << value;
+    return out.str();
+}
+
+// ===== 输出 =====
+
+std::vector<std::string> FleetAudit::columns(const std::vector<HostResult>& results,
+                                             const std::vector<std::string>& params) {
+    if (!params.empty()) {
+        return params;
+    }
+    std::set<std::string> names;
+    for (const HostResult& result : results) {
+        for (const auto& kv : result.values) {
+            names.insert(kv.first);
+        }
+    }
+    return std::vector<std::string>(names.begin(), names.end());
+}
+
+void FleetAudit::writeCsv(std::ostream& out, const std::vector<HostResult>& results,
+                          const std::vector<std::string>& params) {
+    const std::vector<std::string> names = columns(results, params);
+    out << "name,host,status,error";
+    for (const std::string& name : names) {
+        out << ',' << csvField(name);
+    }
+    out << '\n';
+    for (const HostResult& result : results) {
+        out << csvField(result.host.name) << ',' << csvField(result.host.host) << ',' << (result.ok ? "ok" : "failed")
+            << ',' << csvField(result.error);
+        for (const std::string& name : names) {
+            out << ',';
+            auto it = result.values.find(name);
+            if (it != result.values.end()) {
+                out << formatValue(it->second);
+            }
+        }
+        out << '\n';
+    }
+}
+
+void FleetAudit::writeJson(std::ostream& out, const std::vector<HostResult>& results,
+                           const std::vector<std::string>& params) {
+    const std::vector<std::string> names = columns(results, params);
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const HostResult& result = results[i];
+        out << "  {\"name\": " << jsonString(result.host.name) << ", \"host\": " << jsonString(result.host.host)
+            << ", \"port\": " << result.host.port << ", \"ok\": " << (result.ok ? "true" : "false")
+            << ", \"ms\": " << static_cast<long long>(result.elapsedMs);
+        if (!result.ok) {
+            out << ", \"error\": " << jsonString(result.error);
+        }
+        out << ", \"params\": {";
+        bool first = true;
+        for (const std::string& name : names) {
+            auto it = result.values.find(name);
+            if (it == result.values.end()) {
+                continue;
+            }
+            out << (first ? "" : ", ") << jsonString(name) << ": " << formatValue(it->second);
+            first = false;
+        }
+        out << "}}" << (i + 1 < results.size() ? "," : "") << '\n';
+    }
+    out << "]\n";
+}
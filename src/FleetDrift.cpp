@@ -0,0 +1,221 @@
+#include "FleetDrift.h"
+#include "ConfigReader.h"
+#include "Exceptions.h"
+#include "FileHandler.h"
+#include "SSHManager.h"
+#include "Sha256.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+namespace {
+
+// Windows 上编辑的模板是 CRLF：parseConfigContent 只去除空格和制表符，行尾的 \r 会让所有数值校验失败，
+// 摘要也永远不会与机器人上的 LF 文件一致。比对前统一换成 LF
+std::string normalizeLineEndings(const std::string& content) {
+    std::string normalized;
+    normalized.reserve(content.size());
+    for (size_t i = 0; i < content.size(); ++i) {
+        if (content[i] == '\r' && (i + 1 == content.size() || content[i + 1] == '\n')) {
+            continue;
+        }
+        normalized += content[i];
+    }
+    return normalized;
+}
+
+// 与 ConfigReader::loadConfig 相同的解析（同名参数以最后一次出现为准）
+std::map<std::string, double> parseValues(const std::string& content) {
+    ConfigReader reader(nullptr, "");
+    std::string deduped;
+    if (!reader.parseConfigContent(normalizeLineEndings(content), deduped)) {
+        throw ConfigException("配置文件解析失败");
+    }
+    return reader.parsedValues;
+}
+
+// 一条命令完成“摘要比对 + 不一致时返回内容”：
+//   MISSING              文件不存在或不可读
+//   MATCH <摘要>         与模板一致
+//   DIFF <摘要>\n<内容>  不一致，后面紧跟完整文件
+std::string checkCommand(const std::string& path, const std::string& goldenSha) {
+    return "f=" + FileHandler::shellQuote(path) +
+           "; [ -r \"$f\" ] || { echo MISSING; exit 0; }"
+           "; h=$(sha256sum < \"$f\") || exit 1; h=${h%% *}"
+           "; if [ \"$h\" = " + goldenSha + " ]; then echo \"MATCH $h\"; else echo \"DIFF $h\"; cat -- \"$f\"; fi";
+}
+
+FleetDrift::HostResult checkHost(const FleetHost& host, const FleetDrift::Golden& golden,
+                                 const FleetAudit::Options& options, double tolerance) {
+    FleetDrift::HostResult result;
+    result.host = host;
+    const auto started = std::chrono::steady_clock::now();
+    try {
+        std::unique_ptr<SSHManager> ssh = FleetAudit::connect(host, options);
+        const std::string output =
+            FleetAudit::execute(*ssh, checkCommand(options.configPath, golden.sha256), options.commandTimeoutMs);
+        result.bytesReceived = output.size();
+
+        const size_t newline = output.find('\n');
+        const std::string marker = output.substr(0, newline);
+        if (marker == "MISSING") {
+            result.status = FleetDrift::Status::MissingFile;
+            result.error = "配置文件不存在: " + options.configPath;
+        } else if (marker.rfind("MATCH ", 0) == 0) {
+            result.status = FleetDrift::Status::Match;
+            result.sha256 = marker.substr(6);
+        } else if (marker.rfind("DIFF ", 0) == 0) {
+            result.sha256 = marker.substr(5);
+            const std::string content = newline == std::string::npos ? std::string() : output.substr(newline + 1);
+            result.diffs = FleetDrift::diff(golden.values, parseValues(content), tolerance);
+            result.status = result.diffs.empty() ? FleetDrift::Status::FormatOnly : FleetDrift::Status::Drift;
+        } else {
+            throw RemoteCommandException("无法识别的输出: " + marker);
+        }
+    } catch (const std::exception& e) {
+        result.status = FleetDrift::Status::Error;
+        result.error = e.what();
+    }
+    result.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    return result;
+}
+
+} // namespace
+
+FleetDrift::Golden FleetDrift::Golden::loadFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw ConfigException("无法打开标准模板: " + path);
+    }
+    std::ostringstream content;
+    content << in.rdbuf();
+    return fromContent(content.str());
+}
+
+FleetDrift::Golden FleetDrift::Golden::fromContent(const std::string& content) {
+    // 机器人上的配置由本工具以 LF 写入，摘要按 LF 计算；CRLF 的远端文件走 DIFF 分支后记为 format-only
+    const std::string normalized = normalizeLineEndings(content);
+    Golden golden;
+    golden.sha256 = Sha256::hashString(normalized);
+    golden.values = parseValues(normalized);
+    return golden;
+}
+
+std::vector<FleetDrift::ParamDiff> FleetDrift::diff(const std::map<std::string, double>& golden,
+                                                    const std::map<std::string, double>& actual, double tolerance) {
+    // 两个有序 map 归并一次
+    std::vector<ParamDiff> diffs;
+    auto g = golden.begin();
+    auto a = actual.begin();
+    while (g != golden.end() || a != actual.end()) {
+        ParamDiff d;
+        if (a == actual.end() || (g != golden.end() && g->first < a->first)) {
+            d.param = g->first;
+            d.kind = ParamDiff::Missing;
+            d.golden = g->second;
+            ++g;
+        } else if (g == golden.end() || a->first < g->first) {
+            d.param = a->first;
+            d.kind = ParamDiff::Extra;
+            d.actual = a->second;
+            ++a;
+        } else {
+            const bool same = std::fabs(g->second - a->second) <= tolerance;
+            d.param = g->first;
+            d.golden = g->second;
+            d.actual = a->second;
+            ++g;
+            ++a;
+            if (same) {
+                continue;
+            }
+        }
+        diffs.push_back(d);
+    }
+    return diffs;
+}
+
+std::vector<FleetDrift::HostResult> FleetDrift::run(const std::vector<FleetHost>& hosts, const Golden& golden,
+                                                    const FleetAudit::Options& options, double tolerance,
+                                                    const Progress& progress) {
+    std::vector<HostResult> results(hosts.size());
+    std::atomic<size_t> done{0};
+    std::mutex progressMutex;
+    FleetAudit::forEachParallel(hosts.size(), options.jobs, [&](size_t i) {
+        results[i] = checkHost(hosts[i], golden, options, tolerance);
+        const size_t finished = done.fetch_add(1) + 1;
+        if (progress) {
+            std::lock_guard<std::mutex> lock(progressMutex);
+            progress(results[i], finished, hosts.size());
+        }
+    });
+    return results;
+}
+
+const char* FleetDrift::statusName(Status status) {
+    switch (status) {
+    case Status::Match: return "match";
+    case Status::FormatOnly: return "format-only";
+    case Status::Drift: return "drift";
+    case Status::MissingFile: return "missing";
+    default: return "error";
+    }
+}
+
+const char* FleetDrift::kindName(ParamDiff::Kind kind) {
+    switch (kind) {
+    case ParamDiff::Missing: return "missing";
+    case ParamDiff::Extra: return "extra";
+    default: return "changed";
+    }
+}
+
+// ===== 输出 =====
+
+void FleetDrift::writeCsv(std::ostream& out, const std::vector<HostResult>& results) {
+    out << "name,host,status,param,kind,golden,actual,error\n";
+    for (const HostResult& r : results) {
+        const std::string prefix = FleetAudit::csvField(r.host.name) + "," + FleetAudit::csvField(r.host.host) + "," +
+                                   statusName(r.status) + ",";
+        if (r.diffs.empty()) {
+            out << prefix << ",,,," << FleetAudit::csvField(r.error) << '\n';
+            continue;
+        }
+        for (const ParamDiff& d : r.diffs) {
+            out << prefix << FleetAudit::csvField(d.param) << ',' << kindName(d.kind) << ','
+                << (d.kind == ParamDiff::Extra ? "" : FleetAudit::formatValue(d.golden)) << ','
+                << (d.kind == ParamDiff::Missing ? "" : FleetAudit::formatValue(d.actual)) << ",\n";
+        }
+    }
+}
+
+void FleetDrift::writeJson(std::ostream& out, const std::vector<HostResult>& results) {
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const HostResult& r = results[i];
+        out << "  {\"name\": " << FleetAudit::jsonString(r.host.name) << ", \"host\": " << FleetAudit::jsonString(r.host.host)
+            << ", \"status\": \"" << statusName(r.status) << "\", \"sha256\": " << FleetAudit::jsonString(r.sha256)
+            << ", \"bytes\": " << r.bytesReceived << ", \"ms\": " << static_cast<long long>(r.elapsedMs);
+        if (!r.error.empty()) {
+            out << ", \"error\": " << FleetAudit::jsonString(r.error);
+        }
+        out << ", \"diffs\": [";
+        for (size_t j = 0; j < r.diffs.size(); ++j) {
+            const ParamDiff& d = r.diffs[j];
+            out << (j ? ", " : "") << "{\"param\": " << FleetAudit::jsonString(d.param) << ", \"kind\": \""
+                << kindName(d.kind) << "\"";
+            if (d.kind != ParamDiff::Extra) {
+                out << ", \"golden\": " << FleetAudit::formatValue(d.golden);
+            }
+            if (d.kind != ParamDiff::Missing) {
+                out << ", \"actual\": " << FleetAudit::formatValue(d.actual);
+            }
+            out << "}";
+        }
+        out << "]}" << (i + 1 < results.size() ? "," : "") << '\n';
+    }
+    out << "]\n";
+}
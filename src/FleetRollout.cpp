@@ -0,0 +1,269 @@
+#include "FleetRollout.h"
+#include "ConfigNotifier.h"
+#include "ConfigReader.h"
+#include "Exceptions.h"
+#include "SSHManager.h"
+#include "TelemetryParser.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point started) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+}
+
+// 写入 → 通知 → 等待 → 健康检查。baseline 保存写入前的原始内容，供回滚使用
+void applyHost(FleetRollout::HostResult& result, std::string& baseline,
+               const std::vector<std::pair<std::string, double>>& params, const FleetRollout::Options& options) {
+    const auto started = Clock::now();
+    try {
+        std::unique_ptr<SSHManager> ssh = FleetAudit::connect(result.host, options.fleet);
+        ConfigReader reader(ssh.get(), options.fleet.configPath);
+        reader.setNotifier(options.notifier);
+
+        const bool ok = reader.writeMultipleParametersToFile(params);
+        baseline = reader.lastWriteBaseline;
+        result.written = ok;
+        result.applyMs = msSince(started);
+        if (!ok) {
+            throw ConfigException("写入配置文件失败");
+        }
+        // wasLiveUpdated 只有在控制器通过 ack 文件确认重新加载后才为 true
+        if (options.notifier && !reader.wasLiveUpdated()) {
+            throw ConfigException("通知控制器失败: " + options.notifier->describe());
+        }
+
+        if (!options.probeCommand.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::max(0, options.settleMs)));
+            const auto probeStarted = Clock::now();
+            try {
+                FleetAudit::execute(*ssh, options.probeCommand, options.probeTimeoutMs);
+            } catch (const std::exception& e) {
+                result.probeMs = msSince(probeStarted);
+                throw RemoteCommandException(std::string("健康检查失败: ") + e.what());
+            }
+            result.probeMs = msSince(probeStarted);
+        }
+        result.state = FleetRollout::State::Applied;
+    } catch (const std::exception& e) {
+        result.state = FleetRollout::State::Failed;
+        result.error = e.what();
+    }
+    result.elapsedMs = msSince(started);
+}
+
+// 原样写回原始内容（不做换行规范化），再通知控制器重新加载
+void rollbackHost(FleetRollout::HostResult& result, const std::string& baseline, const FleetRollout::Options& options) {
+    try {
+        std::unique_ptr<SSHManager> ssh = FleetAudit::connect(result.host, options.fleet);
+        ConfigReader reader(ssh.get(), options.fleet.configPath);
+        std::istringstream in(baseline);
+        if (!reader.atomicWriteRemoteStream(in)) {
+            throw ConfigException("写回原始内容失败");
+        }
+        if (options.notifier) {
+            std::string error;
+            const bool notified = options.notifier->notify(
+                [&reader](const std::string& command) { return reader.executeRemoteCommand(command, 1); },
+                options.fleet.configPath, error);
+            if (!notified) {
+                // 文件已恢复，只是需要重启控制器才能生效
+                result.rollbackError = "已恢复文件，但通知控制器失败: " + error;
+            }
+        }
+        result.state = FleetRollout::State::RolledBack;
+    } catch (const std::exception& e) {
+        result.state = FleetRollout::State::RollbackFailed;
+        result.rollbackError = e.what();
+    }
+}
+
+FleetRollout::StageReport summarizeStage(int index, const std::vector<FleetRollout::HostResult>& results,
+                                         size_t begin, size_t end, double durationMs) {
+    FleetRollout::StageReport stage;
+    stage.index = index;
+    stage.hosts = end - begin;
+    stage.durationMs = durationMs;
+
+    std::vector<double> latencies;
+    latencies.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        const FleetRollout::HostResult& r = results[i];
+        if (r.state == FleetRollout::State::NotStarted) {
+            continue;
+        }
+        (r.state == FleetRollout::State::Applied ? stage.succeeded : stage.failed)++;
+        latencies.push_back(r.elapsedMs);
+    }
+    if (!latencies.empty()) {
+        const size_t mid = latencies.size() / 2;
+        std::nth_element(latencies.begin(), latencies.begin() + mid, latencies.end());
+        stage.p50Ms = latencies[mid];
+        stage.maxMs = *std::max_element(latencies.begin(), latencies.end());
+    }
+    return stage;
+}
+
+} // namespace
+
+std::vector<size_t> FleetRollout::planStages(const std::string& spec, size_t hostCount) {
+    std::vector<size_t> ends;
+    if (hostCount == 0) {
+        return ends;
+    }
+
+    std::string_view fields[32];
+    const int count = TelemetryLineParser::split(spec, fields, 32);
+    for (int i = 0; i < count; ++i) {
+        std::string_view field = fields[i];
+        const bool percent = !field.empty() && field.back() == '%';
+        if (percent) {
+            field.remove_suffix(1);
+        }
+        double value = 0.0;
+        if (!TelemetryLineParser::parseNumber(field, value) || !(value > 0.0) ||
+            (percent ? value > 100.0 : value != std::floor(value))) {
+            throw ConfigException("发布阶段格式错误: " + std::string(fields[i]));
+        }
+
+        const double hosts = percent ? std::ceil(value * static_cast<double>(hostCount) / 100.0) : value;
+        const size_t end = static_cast<size_t>(std::min(hosts, static_cast<double>(hostCount)));
+        if (!ends.empty() && end <= ends.back()) {
+            continue;   // 累计数没有增加（如主机较少时 1 与 10% 重合）
+        }
+        ends.push_back(end);
+    }
+    if (ends.empty() || ends.back() < hostCount) {
+        ends.push_back(hostCount);
+    }
+    return ends;
+}
+
+FleetRollout::Report FleetRollout::run(const std::vector<FleetHost>& hosts,
+                                       const std::vector<std::pair<std::string, double>>& params,
+                                       const Options& options, const Progress& progress, const StageDone& stageDone) {
+    const std::vector<size_t> stageEnds = planStages(options.stages, hosts.size());
+
+    Report report;
+    report.hosts.resize(hosts.size());
+    for (size_t i = 0; i < hosts.size(); ++i) {
+        report.hosts[i].host = hosts[i];
+    }
+    std::vector<std::string> baselines(hosts.size());
+
+    std::atomic<bool> aborted{false};
+    std::atomic<size_t> done{0};
+    std::mutex progressMutex;
+    size_t begin = 0;
+    for (size_t s = 0; s < stageEnds.size() && !aborted; ++s) {
+        const size_t end = stageEnds[s];
+        const auto stageStarted = Clock::now();
+        FleetAudit::forEachParallel(end - begin, options.fleet.jobs, [&](size_t offset) {
+            HostResult& result = report.hosts[begin + offset];
+            result.stage = static_cast<int>(s);
+            // 同阶段已有主机失败时，尚未开始的主机不再写入
+            if (aborted) {
+                return;
+            }
+            applyHost(result, baselines[begin + offset], params, options);
+            if (result.state != State::Applied) {
+                aborted = true;
+            }
+            const size_t finished = done.fetch_add(1) + 1;
+            if (progress) {
+                std::lock_guard<std::mutex> lock(progressMutex);
+                progress(result, finished, hosts.size());
+            }
+        });
+
+        report.stages.push_back(summarizeStage(static_cast<int>(s), report.hosts, begin, end, msSince(stageStarted)));
+        if (stageDone) {
+            stageDone(report.stages.back());
+        }
+        begin = end;
+    }
+
+    report.completed = !aborted;
+    if (report.completed) {
+        return report;
+    }
+
+    // ===== 回滚 =====
+    // 凡是读到了原始内容的主机都写回，而不只是报告写入成功的主机：mv 已执行但 "ok" 回显丢失时
+    // 远端已经是新文件，written 却为 false。写回原始内容是幂等的，对未被替换的主机没有影响
+    std::vector<size_t> touched;
+    for (size_t i = 0; i < report.hosts.size(); ++i) {
+        if (!baselines[i].empty()) {
+            touched.push_back(i);
+        }
+    }
+    const auto rollbackStarted = Clock::now();
+    FleetAudit::forEachParallel(touched.size(), options.fleet.jobs, [&](size_t k) {
+        const size_t i = touched[k];
+        rollbackHost(report.hosts[i], baselines[i], options);
+    });
+    report.rollbackMs = msSince(rollbackStarted);
+    for (size_t i : touched) {
+        (report.hosts[i].state == State::RolledBack ? report.rolledBack : report.rollbackFailed)++;
+    }
+    return report;
+}
+
+const char* FleetRollout::stateName(State state) {
+    switch (state) {
+    case State::Applied: return "applied";
+    case State::Failed: return "failed";
+    case State::RolledBack: return "rolled-back";
+    case State::RollbackFailed: return "rollback-failed";
+    default: return "not-started";
+    }
+}
+
+// ===== 输出 =====
+
+void FleetRollout::writeCsv(std::ostream& out, const Report& report) {
+    out << "name,host,stage,state,apply_ms,probe_ms,error,rollback_error\n";
+    for (const HostResult& r : report.hosts) {
+        out << FleetAudit::csvField(r.host.name) << ',' << FleetAudit::csvField(r.host.host) << ','
+            << (r.stage < 0 ? std::string() : std::to_string(r.stage)) << ',' << stateName(r.state) << ','
+            << static_cast<long long>(r.applyMs) << ',' << static_cast<long long>(r.probeMs) << ','
+            << FleetAudit::csvField(r.error) << ',' << FleetAudit::csvField(r.rollbackError) << '\n';
+    }
+}
+
+void FleetRollout::writeJson(std::ostream& out, const Report& report) {
+    out << "{\n  \"completed\": " << (report.completed ? "true" : "false") << ", \"rolled_back\": " << report.rolledBack
+        << ", \"rollback_failed\": " << report.rollbackFailed << ", \"rollback_ms\": "
+        << static_cast<long long>(report.rollbackMs) << ",\n  \"stages\": [\n";
+    for (size_t i = 0; i < report.stages.size(); ++i) {
+        const StageReport& s = report.stages[i];
+        out << "    {\"index\": " << s.index << ", \"hosts\": " << s.hosts << ", \"succeeded\": " << s.succeeded
+            << ", \"failed\": " << s.failed << ", \"p50_ms\": " << static_cast<long long>(s.p50Ms)
+            << ", \"max_ms\": " << static_cast<long long>(s.maxMs) << ", \"duration_ms\": "
+            << static_cast<long long>(s.durationMs) << "}" << (i + 1 < report.stages.size() ? "," : "") << '\n';
+    }
+    out << "  ],\n  \"hosts\": [\n";
+    for (size_t i = 0; i < report.hosts.size(); ++i) {
+        const HostResult& r = report.hosts[i];
+        out << "    {\"name\": " << FleetAudit::jsonString(r.host.name) << ", \"host\": "
+            << FleetAudit::jsonString(r.host.host) << ", \"stage\": " << r.stage << ", \"state\": \""
+            << stateName(r.state) << "\", \"apply_ms\": " << static_cast<long long>(r.applyMs)
+            << ", \"probe_ms\": " << static_cast<long long>(r.probeMs);
+        if (!r.error.empty()) {
+            out << ", \"error\": " << FleetAudit::jsonString(r.error);
+        }
+        if (!r.rollbackError.empty()) {
+            out << ", \"rollback_error\": " << FleetAudit::jsonString(r.rollbackError);
+        }
+        out << "}" << (i + 1 < report.hosts.size() ? "," : "") << '\n';
+    }
+    out << "  ]\n}\n";
+}
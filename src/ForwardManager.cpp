@@ -0,0 +1,484 @@
+#include "ForwardManager.h"
+#include "ResourceManager.h"
+#include <algorithm>
+
+namespace {
+
+// 每个方向的缓冲区大小：与 libssh2 单个通道数据包上限（32KB）同量级，单次 read/write 即可填满一个包
+constexpr size_t kBufferSize = 64 * 1024;
+
+// 空闲时的最长等待：SSH socket 可写等事件不在 select 集合中，靠超时兜底
+constexpr int kIdleWaitMs = 20;
+
+std::string lastError(LIBSSH2_SESSION* session) {
+    char* errmsg = nullptr;
+    libssh2_session_last_error(session, &errmsg, nullptr, 0);
+    return errmsg ? std::string(errmsg) : std::string("unknown error");
+}
+
+void setNonBlocking(SOCKET s) {
+    u_long mode = 1;
+    ioctlsocket(s, FIONBIO, &mode);
+}
+
+void setNoDelay(SOCKET s) {
+    // 遥测多为小包，关闭 Nagle 避免额外的合并延迟
+    int flag = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&flag), sizeof(flag));
+}
+
+SOCKET connectLocal(const std::string& host, int port) {
+    SOCKET s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s == INVALID_SOCKET) {
+        return INVALID_SOCKET;
+    }
+
+    sockaddr_in sin{};
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(static_cast<u_short>(port));
+    if (inet_pton(AF_INET, host.c_str(), &sin.sin_addr) != 1 ||
+        connect(s, reinterpret_cast<sockaddr*>(&sin), sizeof(sin))) {
+        closesocket(s);
+        return INVALID_SOCKET;
+    }
+    return s;
+}
+
+} // namespace
+
+ForwardManager::ForwardManager(SSHManager* manager) : sshManager(manager) {}
+
+ForwardManager::~ForwardManager() {
+    try {
+        stop();
+    } catch (...) {
+        // 析构函数不应抛出异常
+    }
+}
+
+int ForwardManager::addLocalForward(const std::string& remoteHost, int remotePort, int localPort,
+                                    const std::string& bindAddress) {
+    LIBSSH2_SESSION* current = sshManager ? sshManager->getSession() : nullptr;
+    if (!current) {
+        throw SSHSessionException("无法获取有效的SSH会话");
+    }
+
+    SOCKET listenSock = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenSock == INVALID_SOCKET) {
+        throw NetworkException("Forward socket creation failed: " + std::to_string(WSAGetLastError()));
+    }
+
+    int reuse = 1;
+    setsockopt(listenSock, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in sin{};
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(static_cast<u_short>(localPort));
+    if (inet_pton(AF_INET, bindAddress.c_str(), &sin.sin_addr) != 1) {
+        closesocket(listenSock);
+        throw NetworkException("Invalid forward bind address: " + bindAddress);
+    }
+    if (bind(listenSock, reinterpret_cast<sockaddr*>(&sin), sizeof(sin)) || listen(listenSock, 16)) {
+        std::string errorMsg = "Forward bind/listen failed: " + std::to_string(WSAGetLastError());
+        closesocket(listenSock);
+        throw NetworkException(errorMsg);
+    }
+
+    socklen_t len = sizeof(sin);
+    getsockname(listenSock, reinterpret_cast<sockaddr*>(&sin), &len);
+    setNonBlocking(listenSock);
+
+    LocalForward forward;
+    forward.listenSock = listenSock;
+    forward.remoteHost = remoteHost;
+    forward.remotePort = remotePort;
+    forward.localPort = ntohs(sin.sin_port);
+
+    std::lock_guard<std::mutex> lock(forwardsMutex);
+    session = current;
+    localForwards.push_back(forward);
+    qDebug() << "本地转发:" << QString::fromStdString(bindAddress) << forward.localPort << "->"
+             << QString::fromStdString(remoteHost) << remotePort;
+    return forward.localPort;
+}
+
+int ForwardManager::addRemoteForward(int remotePort, const std::string& localHost, int localPort,
+                                     const std::string& remoteBind) {
+    LIBSSH2_SESSION* current = sshManager ? sshManager->getSession() : nullptr;
+    if (!current) {
+        throw SSHSessionException("无法获取有效的SSH会话");
+    }
+
+    // 泵线程运行时会话可能处于非阻塞模式，持锁期间泵线程已恢复阻塞模式
+    auto sessionLock = sshManager->lockSession();
+    int boundPort = 0;
+    LIBSSH2_LISTENER* listener =
+        libssh2_channel_forward_listen_ex(current, remoteBind.c_str(), remotePort, &boundPort, 16);
+    if (!listener) {
+        throw SSHSessionException("远程转发被拒绝 (" + remoteBind + ":" + std::to_string(remotePort) +
+                                  "): " + lastError(current));
+    }
+
+    RemoteForward forward;
+    forward.listener = listener;
+    forward.remotePort = boundPort > 0 ? boundPort : remotePort;
+    forward.localHost = localHost;
+    forward.localPort = localPort;
+
+    std::lock_guard<std::mutex> lock(forwardsMutex);
+    session = current;
+    remoteForwards.push_back(forward);
+    qDebug() << "远程转发:" << QString::fromStdString(remoteBind) << forward.remotePort << "->"
+             << QString::fromStdString(localHost) << localPort;
+    return forward.remotePort;
+}
+
+void ForwardManager::start() {
+    if (running.load()) {
+        return;
+    }
+    if (pumpThread.joinable()) {
+        pumpThread.join();   // 上一次因会话失效自行退出的线程
+    }
+    running.store(true);
+    pumpThread = std::thread(&ForwardManager::pumpLoop, this);
+}
+
+void ForwardManager::stop() {
+    running.store(false);
+    if (pumpThread.joinable()) {
+        pumpThread.join();
+    }
+
+    if (sshManager && !sessionChanged()) {
+        auto sessionLock = sshManager->lockSession();
+        releaseAll(true);
+    } else {
+        releaseAll(false);
+    }
+}
+
+ForwardManager::Stats ForwardManager::getStats() const {
+    Stats stats;
+    stats.bytesToRemote = bytesToRemote.load();
+    stats.bytesFromRemote = bytesFromRemote.load();
+    stats.connections = connectionCount.load();
+    stats.activeConnections = activeCount.load();
+    stats.failedConnections = failedCount.load();
+    return stats;
+}
+
+bool ForwardManager::sessionChanged() const {
+    std::lock_guard<std::mutex> lock(forwardsMutex);
+    return !sshManager->isSessionValid() || sshManager->peekSession() != session;
+}
+
+// ===== 泵线程 =====
+
+void ForwardManager::pumpLoop() {
+    bool progressed = false;
+    while (running.load()) {
+        // 上一轮有进展时 libssh2 内部可能还缓存着其它通道的数据，立即再泵一轮
+        waitForActivity(progressed ? 0 : kIdleWaitMs);
+        if (!running.load()) {
+            break;
+        }
+
+        auto sessionLock = sshManager->lockSession();
+        if (sessionChanged()) {
+            qDebug() << "SSH会话已失效，端口转发停止";
+            releaseAll(false);
+            running.store(false);
+            break;
+        }
+
+        // 通道的打开、读写与关闭都在非阻塞模式下推进，需要等待对端时留到下一轮
+        {
+            ResourceManagement::NonBlockingScope nonBlocking(session);
+            progressed = acceptLocal();
+            progressed = openPending() || progressed;
+            progressed = acceptRemote() || progressed;
+            for (auto& conn : connections) {
+                if (conn->closing) {
+                    progressed = closeConnection(*conn, true) || progressed;
+                    continue;
+                }
+                progressed = pumpConnection(*conn) || progressed;
+                if (conn->failed || (conn->eofSent && conn->channelEof && conn->toSocket.pending() == 0)) {
+                    conn->closing = true;
+                    closeConnection(*conn, true);
+                    progressed = true;
+                }
+            }
+        }
+
+        connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                         [](const std::unique_ptr<Connection>& c) {
+                                             return c->closing && c->channel == nullptr;
+                                         }),
+                          connections.end());
+    }
+}
+
+void ForwardManager::waitForActivity(int timeoutMs) {
+    fd_set readSet;
+    fd_set writeSet;
+    FD_ZERO(&readSet);
+    FD_ZERO(&writeSet);
+    SOCKET maxSock = 0;
+    auto watch = [&maxSock](SOCKET s, fd_set* set) {
+        FD_SET(s, set);
+        maxSock = std::max(maxSock, s);
+    };
+
+    SOCKET sshSock = sshManager->getSocket();
+    if (sshSock != INVALID_SOCKET) {
+        watch(sshSock, &readSet);
+    }
+    {
+        std::lock_guard<std::mutex> lock(forwardsMutex);
+        for (const auto& forward : localForwards) {
+            watch(forward.listenSock, &readSet);
+        }
+    }
+    for (const auto& conn : connections) {
+        if (conn->sock == INVALID_SOCKET) {
+            continue;   // 正在关闭，只等 SSH socket
+        }
+        // 缓冲区未写出前不再读，背压自然传回发送方
+        if (!conn->socketEof && conn->toChannel.pending() == 0) {
+            watch(conn->sock, &readSet);
+        }
+        if (conn->toSocket.pending() > 0) {
+            watch(conn->sock, &writeSet);
+        }
+    }
+
+    timeval tv;
+    tv.tv_sec = timeoutMs / 1000;
+    tv.tv_usec = (timeoutMs % 1000) * 1000;
+    select(static_cast<int>(maxSock + 1), &readSet, &writeSet, nullptr, &tv);
+}
+
+bool ForwardManager::acceptLocal() {
+    std::vector<LocalForward> forwards;
+    {
+        std::lock_guard<std::mutex> lock(forwardsMutex);
+        forwards = localForwards;
+    }
+
+    bool accepted = false;
+    for (const auto& forward : forwards) {
+        SOCKET client;
+        while ((client = accept(forward.listenSock, nullptr, nullptr)) != INVALID_SOCKET) {
+            // 通道在 openPending 中打开，在此之前不读取客户端数据
+            PendingOpen pending;
+            pending.sock = client;
+            pending.remoteHost = forward.remoteHost;
+            pending.remotePort = forward.remotePort;
+            pending.localPort = forward.localPort;
+            pendingOpens.push_back(pending);
+            accepted = true;
+        }
+    }
+    return accepted;
+}
+
+bool ForwardManager::openPending() {
+    bool opened = false;
+    while (!pendingOpens.empty()) {
+        // 进行中的打开必须以相同参数重复调用，直到不再返回 EAGAIN
+        const PendingOpen& pending = pendingOpens.front();
+        LIBSSH2_CHANNEL* channel = libssh2_channel_direct_tcpip_ex(
+            session, pending.remoteHost.c_str(), pending.remotePort, "127.0.0.1", pending.localPort);
+        if (!channel) {
+            if (libssh2_session_last_errno(session) == LIBSSH2_ERROR_EAGAIN) {
+                break;   // 等待 sshd 回复 CHANNEL_OPEN_CONFIRMATION
+            }
+            qDebug() << "打开转发通道失败:" << QString::fromStdString(pending.remoteHost) << pending.remotePort
+                     << QString::fromStdString(lastError(session));
+            failedCount.fetch_add(1);
+            closesocket(pending.sock);
+        } else {
+            addConnection(pending.sock, channel);
+        }
+        pendingOpens.erase(pendingOpens.begin());
+        opened = true;
+    }
+    return opened;
+}
+
+bool ForwardManager::acceptRemote() {
+    std::vector<RemoteForward> forwards;
+    {
+        std::lock_guard<std::mutex> lock(forwardsMutex);
+        forwards = remoteForwards;
+    }
+
+    bool accepted = false;
+    for (const auto& forward : forwards) {
+        LIBSSH2_CHANNEL* channel;
+        // 非阻塞模式下没有待接受的连接时返回 nullptr（EAGAIN）
+        while ((channel = libssh2_channel_forward_accept(forward.listener)) != nullptr) {
+            SOCKET target = connectLocal(forward.localHost, forward.localPort);
+            if (target == INVALID_SOCKET) {
+                qDebug() << "远程转发连接本地目标失败:" << QString::fromStdString(forward.localHost) << forward.localPort;
+                failedCount.fetch_add(1);
+                // 关闭同样可能需要等待对端，交给泵循环完成
+                auto conn = std::make_unique<Connection>();
+                conn->channel = channel;
+                conn->closing = true;
+                connections.push_back(std::move(conn));
+                continue;
+            }
+            addConnection(target, channel);
+            accepted = true;
+        }
+    }
+    return accepted;
+}
+
+void ForwardManager::addConnection(SOCKET sock, LIBSSH2_CHANNEL* channel) {
+    setNonBlocking(sock);
+    setNoDelay(sock);
+
+    auto conn = std::make_unique<Connection>();
+    conn->sock = sock;
+    conn->channel = channel;
+    conn->toChannel.data.reset(new char[kBufferSize]);
+    conn->toSocket.data.reset(new char[kBufferSize]);
+    connections.push_back(std::move(conn));
+
+    connectionCount.fetch_add(1);
+    activeCount.fetch_add(1);
+}
+
+bool ForwardManager::pumpConnection(Connection& conn) {
+    bool progressed = false;
+
+    // 本地 socket -> 通道
+    Buffer& up = conn.toChannel;
+    if (up.pending() == 0 && !conn.socketEof) {
+        int n = recv(conn.sock, up.data.get(), static_cast<int>(kBufferSize), 0);
+        if (n > 0) {
+            up.begin = 0;
+            up.end = static_cast<size_t>(n);
+        } else if (n == 0) {
+            conn.socketEof = true;
+        } else if (WSAGetLastError() != WSAEWOULDBLOCK) {
+            conn.failed = true;
+            return progressed;
+        }
+    }
+    while (up.pending() > 0) {
+        ssize_t written = libssh2_channel_write(conn.channel, up.data.get() + up.begin, up.pending());
+        if (written == LIBSSH2_ERROR_EAGAIN) {
+            break;   // 通道窗口已满，等对端调整窗口
+        }
+        if (written < 0) {
+            conn.failed = true;
+            return progressed;
+        }
+        up.begin += static_cast<size_t>(written);
+        bytesToRemote.fetch_add(static_cast<uint64_t>(written));
+        progressed = true;
+    }
+    if (conn.socketEof && up.pending() == 0 && !conn.eofSent) {
+        if (libssh2_channel_send_eof(conn.channel) != LIBSSH2_ERROR_EAGAIN) {
+            conn.eofSent = true;
+        }
+    }
+
+    // 通道 -> 本地 socket
+    Buffer& down = conn.toSocket;
+    if (down.pending() == 0 && !conn.channelEof) {
+        ssize_t n = libssh2_channel_read(conn.channel, down.data.get(), kBufferSize);
+        if (n > 0) {
+            down.begin = 0;
+            down.end = static_cast<size_t>(n);
+        } else if (n == 0 || n == LIBSSH2_ERROR_EAGAIN) {
+            conn.channelEof = libssh2_channel_eof(conn.channel) != 0;
+        } else {
+            conn.failed = true;
+            return progressed;
+        }
+    }
+    while (down.pending() > 0) {
+        int sent = send(conn.sock, down.data.get() + down.begin, static_cast<int>(down.pending()), 0);
+        if (sent < 0) {
+            if (WSAGetLastError() != WSAEWOULDBLOCK) {
+                conn.failed = true;
+            }
+            break;
+        }
+        down.begin += static_cast<size_t>(sent);
+        bytesFromRemote.fetch_add(static_cast<uint64_t>(sent));
+        progressed = true;
+    }
+    if (conn.channelEof && down.pending() == 0 && !conn.socketShutdown) {
+        shutdown(conn.sock, SD_SEND);
+        conn.socketShutdown = true;
+    }
+
+    return progressed;
+}
+
+bool ForwardManager::closeConnection(Connection& conn, bool freeChannel) {
+    if (conn.sock != INVALID_SOCKET) {
+        closesocket(conn.sock);
+        conn.sock = INVALID_SOCKET;
+        activeCount.fetch_sub(1);
+    }
+    if (!conn.channel) {
+        return true;
+    }
+    if (!freeChannel) {
+        conn.channel = nullptr;
+        return true;
+    }
+    if (!conn.closeSent) {
+        if (libssh2_channel_close(conn.channel) == LIBSSH2_ERROR_EAGAIN) {
+            return false;
+        }
+        conn.closeSent = true;
+    }
+    if (libssh2_channel_free(conn.channel) == LIBSSH2_ERROR_EAGAIN) {
+        return false;
+    }
+    conn.channel = nullptr;
+    return true;
+}
+
+void ForwardManager::releaseAll(bool freeSsh) {
+    // 在阻塞模式下调用（stop 或会话已失效），closeConnection 一次即可完成
+    for (auto& conn : connections) {
+        closeConnection(*conn, freeSsh);
+    }
+    connections.clear();
+
+    // 进行中的通道打开必须完成，否则会话上的下一次 direct-tcpip 打开会接续这一次
+    if (freeSsh && !pendingOpens.empty()) {
+        const PendingOpen& pending = pendingOpens.front();
+        if (LIBSSH2_CHANNEL* channel = libssh2_channel_direct_tcpip_ex(
+                session, pending.remoteHost.c_str(), pending.remotePort, "127.0.0.1", pending.localPort)) {
+            libssh2_channel_free(channel);
+        }
+    }
+    for (const auto& pending : pendingOpens) {
+        closesocket(pending.sock);
+    }
+    pendingOpens.clear();
+
+    std::lock_guard<std::mutex> lock(forwardsMutex);
+    for (const auto& forward : localForwards) {
+        closesocket(forward.listenSock);
+    }
+    localForwards.clear();
+    for (const auto& forward : remoteForwards) {
+        if (freeSsh) {
+            libssh2_channel_forward_cancel(forward.listener);
+        }
+    }
+    remoteForwards.clear();
+    session = nullptr;
+}
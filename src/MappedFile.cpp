@@ -0,0 +1,152 @@
+#include "MappedFile.h"
+#include "Exceptions.h"
+#include <filesystem>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+#ifdef _WIN32
+        mapping = std::exchange(other.mapping, nullptr);
+#endif
+        handle = std::exchange(other.handle, kInvalid);
+        base = std::exchange(other.base, nullptr);
+        length = std::exchange(other.length, 0);
+    }
+    return *this;
+}
+
+MappedFile MappedFile::open(const std::string& path, Mode mode) {
+    MappedFile file;
+    file.map(path, mode);
+    return file;
+}
+
+MappedFile MappedFile::create(const std::string& path, uint64_t size) {
+#ifdef _WIN32
+    HANDLE h = CreateFileW(std::filesystem::u8path(path).c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                           CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (h == INVALID_HANDLE_VALUE) {
+        throw ConfigException("无法创建文件: " + path);
+    }
+    LARGE_INTEGER li;
+    li.QuadPart = static_cast<LONGLONG>(size);
+    const bool sized = SetFilePointerEx(h, li, nullptr, FILE_BEGIN) && SetEndOfFile(h);
+    CloseHandle(h);
+#else
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw ConfigException("无法创建文件: " + path);
+    }
+    const bool sized = ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+    ::close(fd);
+#endif
+    if (!sized) {
+        throw ConfigException("无法设置文件大小: " + path);
+    }
+    return open(path, Mode::ReadWrite);
+}
+
+void MappedFile::map(const std::string& path, Mode mode) {
+    const bool writable = mode == Mode::ReadWrite;
+#ifdef _WIN32
+    HANDLE h = CreateFileW(std::filesystem::u8path(path).c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                           FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (h == INVALID_HANDLE_VALUE) {
+        throw ConfigException("无法打开文件: " + path);
+    }
+    handle = h;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(h, &fileSize)) {
+        close();
+        throw ConfigException("无法获取文件大小: " + path);
+    }
+    length = static_cast<size_t>(fileSize.QuadPart);
+    if (length == 0) {
+        return;
+    }
+    mapping = CreateFileMappingW(h, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        close();
+        throw ConfigException("无法映射文件: " + path);
+    }
+    base = static_cast<char*>(view);
+#else
+    int fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+    if (fd < 0) {
+        throw ConfigException("无法打开文件: " + path);
+    }
+    handle = fd;
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        close();
+        throw ConfigException("无法获取文件大小: " + path);
+    }
+    length = static_cast<size_t>(st.st_size);
+    if (length == 0) {
+        return;
+    }
+    void* view = ::mmap(nullptr, length, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        close();
+        throw ConfigException("无法映射文件: " + path);
+    }
+    // 分析与转换都是顺序扫描，提示内核加大预读
+    ::madvise(view, length, MADV_SEQUENTIAL);
+    base = static_cast<char*>(view);
+#endif
+}
+
+void MappedFile::flush() {
+    if (!base) {
+        return;
+    }
+#ifdef _WIN32
+    FlushViewOfFile(base, 0);
+#else
+    ::msync(base, length, MS_SYNC);
+#endif
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (base) {
+        UnmapViewOfFile(base);
+    }
+    if (mapping) {
+        CloseHandle(mapping);
+        mapping = nullptr;
+    }
+    if (handle != kInvalid) {
+        CloseHandle(handle);
+    }
+#else
+    if (base) {
+        ::munmap(base, length);
+    }
+    if (handle != kInvalid) {
+        ::close(static_cast<int>(handle));
+    }
+#endif
+    base = nullptr;
+    length = 0;
+    handle = kInvalid;
+}
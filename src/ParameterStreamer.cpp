@@ -0,0 +1,181 @@
+#include "ParameterStreamer.h"
+#include "ResourceManager.h"
+#include <algorithm>
+#include <cstdio>
+#include <QDebug>
+
+namespace {
+
+// 超过这个时间仍未确认的消息不再等待（控制器可能不回 ACK），避免 sentAt 无限增长
+constexpr auto kAckExpiry = std::chrono::seconds(10);
+
+std::string lastError(LIBSSH2_SESSION* session) {
+    char* errmsg = nullptr;
+    libssh2_session_last_error(session, &errmsg, nullptr, 0);
+    return errmsg ? std::string(errmsg) : std::string("unknown error");
+}
+
+} // namespace
+
+ParameterStreamer::ParameterStreamer(SSHManager* manager) : sshManager(manager) {}
+
+ParameterStreamer::~ParameterStreamer() {
+    stop();
+}
+
+void ParameterStreamer::start() {
+    start(Options());
+}
+
+void ParameterStreamer::start(const Options& streamOptions) {
+    stop();
+    options = streamOptions;
+
+    session = sshManager ? sshManager->getSession() : nullptr;
+    if (!session) {
+        throw SSHSessionException("无法获取有效的SSH会话");
+    }
+
+    // 源地址/端口只用于对端日志，填本地回环即可
+    channel = libssh2_channel_direct_tcpip_ex(session, options.remoteHost.c_str(), options.remotePort, "127.0.0.1", 0);
+    if (!channel) {
+        throw SSHSessionException("打开实时参数通道失败 (" + options.remoteHost + ":" +
+                                  std::to_string(options.remotePort) + "): " + lastError(session));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    counters = Stats();
+    sentAt.clear();
+    outgoing.clear();
+    incoming.clear();
+    qDebug() << "实时参数通道已打开:" << QString::fromStdString(options.remoteHost) << options.remotePort;
+}
+
+bool ParameterStreamer::sessionChanged() const {
+    return !sshManager->isSessionValid() || sshManager->peekSession() != session;
+}
+
+void ParameterStreamer::stop() {
+    if (!channel) {
+        return;
+    }
+    if (!sessionChanged()) {
+        auto sessionLock = sshManager->lockSession();
+        libssh2_channel_send_eof(channel);
+        libssh2_channel_close(channel);
+        libssh2_channel_free(channel);
+    }
+    channel = nullptr;
+    session = nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.clear();
+}
+
+void ParameterStreamer::push(const std::string& name, double value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending[name] = value;
+    ++counters.updates;
+}
+
+bool ParameterStreamer::tick() {
+    if (!channel) {
+        return false;
+    }
+    // 50Hz 调用，不能用 getSession()（每次都会打开测试通道）
+    if (sessionChanged()) {
+        stop();
+        return false;
+    }
+
+    // 遥测 / 端口转发 / 保存工作线程可能正在使用会话（保存最长要等控制器确认数秒）。
+    // 在 GUI 线程中不等待会话锁：会话忙时跳过本轮，pending 继续合并，下一轮再发送
+    auto sessionLock = sshManager->tryLockSession();
+    if (!sessionLock.owns_lock()) {
+        return true;
+    }
+    ResourceManagement::NonBlockingScope nonBlocking(session);
+
+    // 上一轮没写完时先不取新的变化，pending 会继续合并
+    if (outgoing.empty()) {
+        std::map<std::string, double> batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batch.swap(pending);
+        }
+        const auto now = std::chrono::steady_clock::now();
+        const long long nowUs = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
+        for (const auto& [name, value] : batch) {
+            char line[256];
+            int len = std::snprintf(line, sizeof(line), "SET %s %.9g %llu %lld\n", name.c_str(), value,
+                                    static_cast<unsigned long long>(nextSeq), nowUs);
+            if (len <= 0 || len >= static_cast<int>(sizeof(line))) {
+                continue;
+            }
+            outgoing.append(line, static_cast<size_t>(len));
+            sentAt[nextSeq++] = now;
+        }
+        if (!batch.empty()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            counters.messagesSent += batch.size();
+        }
+    }
+
+    while (!outgoing.empty()) {
+        ssize_t written = libssh2_channel_write(channel, outgoing.data(), outgoing.size());
+        if (written == LIBSSH2_ERROR_EAGAIN) {
+            break;  // 对端窗口已满，下一轮继续
+        }
+        if (written < 0) {
+            qDebug() << "实时参数通道写入失败:" << QString::fromStdString(lastError(session));
+            stop();
+            return false;
+        }
+        outgoing.erase(0, static_cast<size_t>(written));
+    }
+
+    readAcks();
+    if (channel && libssh2_channel_eof(channel)) {
+        qDebug() << "实时参数通道已被对端关闭";
+        stop();
+        return false;
+    }
+    return channel != nullptr;
+}
+
+void ParameterStreamer::readAcks() {
+    char buffer[1024];
+    ssize_t n;
+    while ((n = libssh2_channel_read(channel, buffer, sizeof(buffer))) > 0) {
+        incoming.append(buffer, static_cast<size_t>(n));
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    size_t newline;
+    std::lock_guard<std::mutex> lock(mutex);
+    while ((newline = incoming.find('\n')) != std::string::npos) {
+        unsigned long long seq = 0;
+        if (std::sscanf(incoming.c_str(), "ACK %llu", &seq) == 1) {
+            auto it = sentAt.find(seq);
+            if (it != sentAt.end()) {
+                const double latency = std::chrono::duration<double, std::milli>(now - it->second).count();
+                ++counters.acked;
+                counters.lastLatencyMs = latency;
+                counters.maxLatencyMs = std::max(counters.maxLatencyMs, latency);
+                counters.meanLatencyMs += (latency - counters.meanLatencyMs) / static_cast<double>(counters.acked);
+                sentAt.erase(it);
+            }
+        }
+        incoming.erase(0, newline + 1);
+    }
+
+    while (!sentAt.empty() && now - sentAt.begin()->second > kAckExpiry) {
+        sentAt.erase(sentAt.begin());
+    }
+    counters.inFlight = sentAt.size();
+}
+
+ParameterStreamer::Stats ParameterStreamer::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
@@ -0,0 +1,212 @@
+#include "RemoteAgent.h"
+#include "FileHandler.h"
+#include <QDebug>
+
+namespace {
+
+const char* kReadyBanner = "ADJUSTBIAS_AGENT 1";
+
+// 远端循环。read 在管道上逐字节读取，head -c 只读取 LEN 字节，不会吞掉下一帧；
+// 子命令的 stdin 一律重定向到 /dev/null，避免它们读走协议数据。
+const char* kAgentScript = R"AGENT(
+T=$(mktemp "${TMPDIR:-/tmp}/adjustBias_agent.XXXXXX") || exit 1
+E="$T.err"; I="$T.in"
+trap 'rm -f "$T" "$E" "$I"' EXIT
+reply() { printf '%s %s\n' "$1" "$(wc -c < "$T")"; cat "$T"; }
+run() { if "$@" < /dev/null > "$T" 2> "$E"; then reply 0; else s=$?; cat "$E" > "$T"; reply "$s"; fi; }
+wr() { cat "$I" > "$p.tmp.$$" && mv -f "$p.tmp.$$" "$p" || { rm -f "$p.tmp.$$"; return 1; }; }
+printf 'ADJUSTBIAS_AGENT 1\n'
+while read -r op len; do
+  IFS= read -r p || break
+  if [ "$len" -gt 0 ]; then head -c "$len" > "$I"; else : > "$I"; fi
+  case "$op" in
+    P) : > "$T"; reply 0 ;;
+    R) run cat -- "$p" ;;
+    S) run stat -c '%s %Y %a' -- "$p" ;;
+    H) run sha256sum -- "$p" ;;
+    W) run wr ;;
+    E) sh "$I" < /dev/null > "$T" 2> "$E"; reply $? ;;
+    Q) exit 0 ;;
+    *) printf 'unknown op %s' "$op" > "$T"; reply 127 ;;
+  esac
+done
+)AGENT";
+
+// 帧负载按块写入通道，内存占用与负载大小无关
+constexpr size_t kWriteChunkSize = 32 * 1024;
+
+} // namespace
+
+RemoteAgent::RemoteAgent(SSHManager* manager) : sshManager(manager) {}
+
+RemoteAgent::~RemoteAgent() {
+    try {
+        stop();
+    } catch (...) {
+        // 析构函数不应抛出异常
+    }
+}
+
+bool RemoteAgent::start(int timeoutMs) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (executor) {
+        return true;
+    }
+
+    try {
+        executor = std::make_unique<RemoteCommandExecutor>(
+            sshManager, "sh -c " + FileHandler::shellQuote(kAgentScript), false);
+        executor->execute();
+        pending.clear();
+
+        std::string banner = readLine(timeoutMs);
+        if (banner != kReadyBanner) {
+            qDebug() << "远端代理启动失败:" << QString::fromStdString(banner + executor->getStderr());
+            executor.reset();
+            return false;
+        }
+        return true;
+    } catch (const std::exception& e) {
+        qDebug() << "远端代理启动失败:" << e.what();
+        executor.reset();
+        return false;
+    }
+}
+
+void RemoteAgent::stop() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!executor) {
+        return;
+    }
+    try {
+        const char quit[] = "Q 0\n\n";
+        executor->writeInput(quit, sizeof(quit) - 1, 1000);
+        executor->sendEof(1000);
+    } catch (...) {
+        // 通道可能已经断开，直接释放
+    }
+    executor.reset();
+    pending.clear();
+}
+
+[[noreturn]] void RemoteAgent::fail(const std::string& message) {
+    // 帧已失去同步，丢弃通道；SSHManager 下次需要时会重新启动代理
+    executor.reset();
+    pending.clear();
+    throw SSHSessionException("远端代理: " + message);
+}
+
+std::string RemoteAgent::readLine(int timeoutMs) {
+    size_t newline;
+    while ((newline = pending.find('\n')) == std::string::npos) {
+        char buffer[4096];
+        size_t n = executor->readSome(buffer, sizeof(buffer), timeoutMs);
+        if (n == 0) {
+            throw SSHException("远端代理已退出: " + executor->getStderr());
+        }
+        pending.append(buffer, n);
+    }
+    std::string line = pending.substr(0, newline);
+    pending.erase(0, newline + 1);
+    return line;
+}
+
+void RemoteAgent::readExact(size_t len, std::string& out, int timeoutMs) {
+    out.clear();
+    out.reserve(len);
+    const size_t fromPending = std::min(len, pending.size());
+    out.append(pending, 0, fromPending);
+    pending.erase(0, fromPending);
+
+    std::vector<char> buffer(std::min<size_t>(std::max<size_t>(len, 1), 256 * 1024));
+    while (out.size() < len) {
+        size_t n = executor->readSome(buffer.data(), std::min(buffer.size(), len - out.size()), timeoutMs);
+        if (n == 0) {
+            throw SSHException("远端代理在响应中途退出");
+        }
+        out.append(buffer.data(), n);
+    }
+}
+
+RemoteAgent::Response RemoteAgent::request(char op, const std::string& path, const std::string& payload, int timeoutMs) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!executor) {
+        throw SSHSessionException("远端代理未运行");
+    }
+    if (path.find('\n') != std::string::npos) {
+        throw RemoteCommandException("路径中不能包含换行符: " + path);
+    }
+
+    try {
+        std::string header;
+        header += op;
+        header += ' ' + std::to_string(payload.size()) + '\n' + path + '\n';
+        executor->writeInput(header.data(), header.size(), timeoutMs);
+        for (size_t offset = 0; offset < payload.size(); offset += kWriteChunkSize) {
+            executor->writeInput(payload.data() + offset, std::min(kWriteChunkSize, payload.size() - offset), timeoutMs);
+        }
+
+        std::istringstream statusLine(readLine(timeoutMs));
+        Response response;
+        size_t len = 0;
+        if (!(statusLine >> response.status >> len)) {
+            fail("响应帧格式错误");
+        }
+        readExact(len, response.payload, timeoutMs);
+        return response;
+    } catch (const SSHSessionException&) {
+        throw;
+    } catch (const std::exception& e) {
+        fail(e.what());
+    }
+}
+
+double RemoteAgent::ping() {
+    auto start = std::chrono::steady_clock::now();
+    request('P', "", "");
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string RemoteAgent::readFile(const std::string& path) {
+    Response response = request('R', path, "");
+    if (response.status != 0) {
+        throw RemoteCommandException("读取远端文件失败: " + path + ": " + response.payload);
+    }
+    return response.payload;
+}
+
+void RemoteAgent::atomicWrite(const std::string& path, const std::string& content) {
+    Response response = request('W', path, content);
+    if (response.status != 0) {
+        throw RemoteCommandException("写入远端文件失败: " + path + ": " + response.payload);
+    }
+}
+
+std::string RemoteAgent::sha256(const std::string& path) {
+    Response response = request('H', path, "");
+    if (response.status != 0) {
+        throw RemoteCommandException("计算远端文件哈希失败: " + path + ": " + response.payload);
+    }
+    // sha256sum 输出为 "<hash>  <path>"
+    return response.payload.substr(0, response.payload.find(' '));
+}
+
+bool RemoteAgent::stat(const std::string& path, StatInfo& info) {
+    Response response = request('S', path, "");
+    if (response.status != 0) {
+        return false;
+    }
+    std::istringstream fields(response.payload);
+    std::string mode;
+    if (!(fields >> info.size >> info.mtime >> mode)) {
+        return false;
+    }
+    info.mode = static_cast<int>(std::stoul(mode, nullptr, 8));
+    return true;
+}
+
+int RemoteAgent::exec(const std::string& command, std::string& output) {
+    Response response = request('E', "", command);
+    output = std::move(response.payload);
+    return response.status;
+}
@@ -1,4 +1,5 @@
 #include "RemoteCommandExecutor.h"
+#include "ResourceManager.h"
 #include <QDebug>
 
 LIBSSH2_CHANNEL* RemoteCommandExecutor::getChannel() { return channel; }
@@ -134,6 +135,170 @@ void RemoteCommandExecutor::readOutput() {
     }
 }
 
+// ===== stdin 流式写入 =====
+
+namespace {
+
+string lastSessionError(LIBSSH2_SESSION* session) {
+    char* errmsg = nullptr;
+    libssh2_session_last_error(session, &errmsg, nullptr, 0);
+    return errmsg ? string(errmsg) : string();
+}
+
+} // namespace
+
+void RemoteCommandExecutor::drainOutput() {
+    char buffer[4096];
+    while (libssh2_channel_read(channel, buffer, sizeof(buffer)) > 0) {
+        // stdout 在写入阶段没有用处，直接丢弃
+    }
+    ssize_t n;
+    while ((n = libssh2_channel_read_stderr(channel, buffer, sizeof(buffer))) > 0) {
+        if (stderrOutput.size() < 64 * 1024) {
+            stderrOutput.append(buffer, static_cast<size_t>(n));
+        }
+    }
+}
+
+void RemoteCommandExecutor::writeInput(const char* data, size_t len, int timeoutMs) {
+    if (!channel) {
+        throw SSHException("SSH通道无效，无法写入数据");
+    }
+
+    ResourceManagement::NonBlockingScope nonBlocking(session);
+    auto lastProgress = chrono::steady_clock::now();
+    size_t offset = 0;
+
+    while (offset < len) {
+        ssize_t written = libssh2_channel_write(channel, data + offset, len - offset);
+        if (written > 0) {
+            offset += static_cast<size_t>(written);
+            lastProgress = chrono::steady_clock::now();
+            continue;
+        }
+        if (written != LIBSSH2_ERROR_EAGAIN && written != 0) {
+            throw SSHException("写入远端 stdin 失败: " + lastSessionError(session));
+        }
+        if (libssh2_channel_eof(channel)) {
+            drainOutput();
+            throw SSHException("远端进程已提前退出: " + stderrOutput);
+        }
+
+        // 对端窗口已满：读取输出让远端继续消费，然后等待 socket 就绪
+        drainOutput();
+        auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - lastProgress);
+        if (elapsed.count() >= timeoutMs) {
+            throw SSHException("写入远端 stdin 超时");
+        }
+        sshManager->waitSocket(static_cast<int>(std::min<long long>(timeoutMs - elapsed.count(), 1000)));
+    }
+}
+
+void RemoteCommandExecutor::sendEof(int timeoutMs) {
+    if (!channel) {
+        return;
+    }
+
+    ResourceManagement::NonBlockingScope nonBlocking(session);
+    auto start = chrono::steady_clock::now();
+    int rc;
+    while ((rc = libssh2_channel_send_eof(channel)) == LIBSSH2_ERROR_EAGAIN) {
+        if (chrono::steady_clock::now() - start > chrono::milliseconds(timeoutMs)) {
+            throw SSHException("发送 EOF 超时");
+        }
+        sshManager->waitSocket(1000);
+    }
+    if (rc < 0) {
+        throw SSHException("发送 EOF 失败: " + lastSessionError(session));
+    }
+}
+
+size_t RemoteCommandExecutor::readSome(char* buffer, size_t len, int timeoutMs) {
+    if (!channel) {
+        throw SSHException("SSH通道无效，无法读取数据");
+    }
+
+    ResourceManagement::NonBlockingScope nonBlocking(session);
+    auto start = chrono::steady_clock::now();
+
+    while (true) {
+        ssize_t n = libssh2_channel_read(channel, buffer, len);
+        if (n > 0) {
+            return static_cast<size_t>(n);
+        }
+        if (n < 0 && n != LIBSSH2_ERROR_EAGAIN) {
+            throw SSHException("读取远端输出失败: " + lastSessionError(session));
+        }
+        if (libssh2_channel_eof(channel)) {
+            return 0;
+        }
+
+        // stdout 暂无数据：顺带收集 stderr，避免 stderr 窗口填满后远端阻塞
+        char errBuffer[1024];
+        ssize_t errBytes;
+        while ((errBytes = libssh2_channel_read_stderr(channel, errBuffer, sizeof(errBuffer))) > 0) {
+            if (stderrOutput.size() < 64 * 1024) {
+                stderrOutput.append(errBuffer, static_cast<size_t>(errBytes));
+            }
+        }
+
+        auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+        if (elapsed.count() >= timeoutMs) {
+            throw SSHException("读取远端输出超时");
+        }
+        sshManager->waitSocket(static_cast<int>(std::min<long long>(timeoutMs - elapsed.count(), 1000)));
+    }
+}
+
+int RemoteCommandExecutor::waitForExit(string* output, int timeoutMs) {
+    if (!channel) {
+        return -1;
+    }
+
+    ResourceManagement::NonBlockingScope nonBlocking(session);
+    auto lastProgress = chrono::steady_clock::now();
+    char buffer[4096];
+
+    // 读到远端 EOF 为止（stdout 交给调用方，stderr 留作错误信息）
+    while (!libssh2_channel_eof(channel)) {
+        ssize_t n = libssh2_channel_read(channel, buffer, sizeof(buffer));
+        if (n > 0) {
+            if (output) {
+                output->append(buffer, static_cast<size_t>(n));
+            }
+            lastProgress = chrono::steady_clock::now();
+            continue;
+        }
+        if (n < 0 && n != LIBSSH2_ERROR_EAGAIN) {
+            return -1;
+        }
+        ssize_t errBytes = libssh2_channel_read_stderr(channel, buffer, sizeof(buffer));
+        if (errBytes > 0) {
+            if (stderrOutput.size() < 64 * 1024) {
+                stderrOutput.append(buffer, static_cast<size_t>(errBytes));
+            }
+            lastProgress = chrono::steady_clock::now();
+            continue;
+        }
+        if (chrono::steady_clock::now() - lastProgress > chrono::milliseconds(timeoutMs)) {
+            return -1;
+        }
+        sshManager->waitSocket(1000);
+    }
+
+    // 关闭通道并等待对端确认，此时 exit-status 消息必然已经到达
+    auto start = chrono::steady_clock::now();
+    int rc;
+    while ((rc = libssh2_channel_close(channel)) == LIBSSH2_ERROR_EAGAIN ||
+           (rc == 0 && (rc = libssh2_channel_wait_closed(channel)) == LIBSSH2_ERROR_EAGAIN)) {
+        if (chrono::steady_clock::now() - start > chrono::milliseconds(timeoutMs)) {
+            return -1;
+        }
+        sshManager->waitSocket(1000);
+    }
+    return libssh2_channel_get_exit_status(channel);
+}
+
 RemoteCommandExecutor::~RemoteCommandExecutor() {
     try {
         if (channel) {
@@ -0,0 +1,186 @@
+#include "RetryPolicy.h"
+#include "Exceptions.h"
+#include "SSHManager.h"
+#include <libssh2.h>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+struct Counters {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> attempts{0};
+    std::atomic<uint64_t> retries{0};
+    std::atomic<uint64_t> recovered{0};
+    std::atomic<uint64_t> reconnects{0};
+    std::atomic<uint64_t> reconnectFailures{0};
+    std::atomic<uint64_t> fatal{0};
+    std::atomic<uint64_t> exhausted{0};
+    std::atomic<uint64_t> backoffMs{0};
+};
+
+Counters& counters() {
+    static Counters instance;
+    return instance;
+}
+
+} // namespace
+
+RetryPolicy::RetryPolicy(std::string name, SSHManager* ssh, const Options& options)
+    : name(std::move(name)), ssh(ssh), opts(options), backoff(options.backoff) {}
+
+void RetryPolicy::begin() {
+    backoff.reset();
+    started = Clock::now();
+    ++counters().calls;
+}
+
+void RetryPolicy::succeeded(int attempt) {
+    counters().attempts += static_cast<uint64_t>(attempt);
+    if (attempt > 1) {
+        ++counters().recovered;
+        qDebug() << QString::fromStdString(name) << "第" << attempt << "次尝试成功";
+    }
+}
+
+bool RetryPolicy::shouldRetry(const std::exception& e, int attempt) {
+    const ErrorClass errorClass = classify(e, ssh);
+    const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - started).count();
+
+    auto giveUp = [&](std::atomic<uint64_t>& counter, const char* reason) {
+        counters().attempts += static_cast<uint64_t>(attempt);
+        ++counter;
+        qDebug() << QString::fromStdString(name) << "失败(" << className(errorClass) << "," << reason << "): 尝试"
+                 << attempt << "次, 耗时" << elapsedMs << "ms:" << e.what();
+        return false;
+    };
+
+    if (errorClass == ErrorClass::Fatal) {
+        return giveUp(counters().fatal, "不可重试");
+    }
+    if (errorClass == ErrorClass::Disconnected && (!opts.reconnect || !ssh)) {
+        return giveUp(counters().fatal, "连接已断开");
+    }
+    if (attempt >= opts.maxAttempts) {
+        return giveUp(counters().exhausted, "次数用尽");
+    }
+    if (opts.cancel && opts.cancel->load()) {
+        return giveUp(counters().exhausted, "已取消");
+    }
+
+    // 断线：立即重连（链路恢复后马上重试）；重连失败或普通的临时错误才退避
+    if (errorClass == ErrorClass::Disconnected) {
+        qDebug() << QString::fromStdString(name) << "连接已断开，重连后重试 (" << attempt << "/" << opts.maxAttempts
+                 << "):" << e.what();
+        if (ssh->tryReconnect()) {
+            ++counters().reconnects;
+            ++counters().retries;
+            return true;
+        }
+        ++counters().reconnectFailures;
+    }
+
+    const auto delay = backoff.next();
+    if (Clock::now() + delay >= started + opts.deadline) {
+        return giveUp(counters().exhausted, "超过时限");
+    }
+    qDebug() << QString::fromStdString(name) << "尝试" << attempt << "/" << opts.maxAttempts << "失败("
+             << className(errorClass) << "), " << delay.count() << "ms 后重试:" << e.what();
+    counters().backoffMs += static_cast<uint64_t>(delay.count());
+    if (!Backoff::sleepFor(delay, opts.cancel)) {
+        return giveUp(counters().exhausted, "已取消");
+    }
+    ++counters().retries;
+    return true;
+}
+
+RetryPolicy::ErrorClass RetryPolicy::classify(const std::exception& e, SSHManager* ssh) {
+    // 按异常类型：调用方明确表达的失败原因优先
+    if (dynamic_cast<const OperationCancelledException*>(&e) || dynamic_cast<const SSHAuthenticationException*>(&e) ||
+        dynamic_cast<const ConfigException*>(&e) || dynamic_cast<const RemoteCommandException*>(&e)) {
+        // 命令已在远端执行并返回非零退出码（权限不足、文件不存在等），重试结果相同
+        return ErrorClass::Fatal;
+    }
+    if (dynamic_cast<const SSHConnectionException*>(&e) || dynamic_cast<const NetworkException*>(&e)) {
+        return ErrorClass::Disconnected;
+    }
+    if (!dynamic_cast<const ApplicationException*>(&e)) {
+        // bad_alloc、逻辑错误等与链路无关
+        return ErrorClass::Fatal;
+    }
+    if (!ssh) {
+        // 没有会话管理器，重试不会改变任何东西
+        return ErrorClass::Fatal;
+    }
+
+    // 通用的 SSHException：先看传输层是否已断，再看 libssh2 记录的错误码。
+    // 不能用 isSSHDisconnected / getSession：它们会打开测试通道，通道被拒绝（MaxSessions）
+    // 会被误判为断线并拆掉其他线程仍在使用的共享会话
+    if (ssh->isTransportLost()) {
+        return ErrorClass::Disconnected;
+    }
+    return classifyLibssh2(ssh->lastErrorCode());
+}
+
+RetryPolicy::ErrorClass RetryPolicy::classifyLibssh2(int code) {
+    switch (code) {
+    // 传输层已损坏，只能重建连接
+    case LIBSSH2_ERROR_SOCKET_NONE:
+    case LIBSSH2_ERROR_BANNER_RECV:
+    case LIBSSH2_ERROR_BANNER_SEND:
+    case LIBSSH2_ERROR_SOCKET_SEND:
+    case LIBSSH2_ERROR_SOCKET_RECV:
+    case LIBSSH2_ERROR_SOCKET_DISCONNECT:
+    case LIBSSH2_ERROR_SOCKET_TIMEOUT:
+    case LIBSSH2_ERROR_BAD_SOCKET:
+    case LIBSSH2_ERROR_KEX_FAILURE:
+    case LIBSSH2_ERROR_KEY_EXCHANGE_FAILURE:
+    case LIBSSH2_ERROR_DECRYPT:
+    case LIBSSH2_ERROR_ENCRYPT:
+    case LIBSSH2_ERROR_PROTO:
+        return ErrorClass::Disconnected;
+
+    // 认证 / 权限 / 用法错误，重试结果相同
+    case LIBSSH2_ERROR_AUTHENTICATION_FAILED:
+    case LIBSSH2_ERROR_PUBLICKEY_UNVERIFIED:
+    case LIBSSH2_ERROR_PASSWORD_EXPIRED:
+    case LIBSSH2_ERROR_METHOD_NONE:
+    case LIBSSH2_ERROR_METHOD_NOT_SUPPORTED:
+    case LIBSSH2_ERROR_REQUEST_DENIED:
+    case LIBSSH2_ERROR_CHANNEL_REQUEST_DENIED:
+    case LIBSSH2_ERROR_SFTP_PROTOCOL:
+    case LIBSSH2_ERROR_SCP_PROTOCOL:
+    case LIBSSH2_ERROR_FILE:
+    case LIBSSH2_ERROR_INVAL:
+    case LIBSSH2_ERROR_BAD_USE:
+        return ErrorClass::Fatal;
+
+    // EAGAIN、超时、通道打开失败（MaxSessions）、窗口 / 通道状态等
+    default:
+        return ErrorClass::Transient;
+    }
+}
+
+const char* RetryPolicy::className(ErrorClass errorClass) {
+    switch (errorClass) {
+    case ErrorClass::Transient: return "transient";
+    case ErrorClass::Disconnected: return "disconnected";
+    case ErrorClass::Fatal: return "fatal";
+    }
+    return "unknown";
+}
+
+RetryPolicy::Metrics RetryPolicy::metrics() {
+    const Counters& c = counters();
+    Metrics m;
+    m.calls = c.calls.load();
+    m.attempts = c.attempts.load();
+    m.retries = c.retries.load();
+    m.recovered = c.recovered.load();
+    m.reconnects = c.reconnects.load();
+    m.reconnectFailures = c.reconnectFailures.load();
+    m.fatal = c.fatal.load();
+    m.exhausted = c.exhausted.load();
+    m.backoffMs = c.backoffMs.load();
+    return m;
+}
@@ -0,0 +1,211 @@
+#include "SSHAuth.h"
+#include "Exceptions.h"
+#include "Utf8Path.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <QDebug>
+
+std::mutex SSHKeyCache::mutex;
+std::map<std::string, std::shared_ptr<const SSHKey>> SSHKeyCache::keys;
+
+namespace {
+
+bool readWholeFile(const std::filesystem::path& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    out = buffer.str();
+    return true;
+}
+
+std::string lastError(LIBSSH2_SESSION* session) {
+    char* errmsg = nullptr;
+    libssh2_session_last_error(session, &errmsg, nullptr, 0);
+    return errmsg ? std::string(errmsg) : std::string("unknown error");
+}
+
+bool methodAllowed(const std::string& allowed, const char* method) {
+    // userauth_list 返回 NULL 时（例如服务器允许 none 认证）不做过滤
+    return allowed.empty() || allowed.find(method) != std::string::npos;
+}
+
+// 逐个尝试 agent 中的身份，每尝试一个消耗一次 keyAttempts
+bool authenticateWithAgent(LIBSSH2_SESSION* session, const std::string& username, int& keyAttempts,
+                           std::string& failure) {
+    LIBSSH2_AGENT* agent = libssh2_agent_init(session);
+    if (!agent) {
+        failure = "agent init failed";
+        return false;
+    }
+
+    bool ok = false;
+    if (libssh2_agent_connect(agent) != 0) {
+        failure = "no agent running";
+    } else {
+        if (libssh2_agent_list_identities(agent) != 0) {
+            failure = "agent list identities failed";
+        } else {
+            libssh2_agent_publickey* identity = nullptr;
+            libssh2_agent_publickey* previous = nullptr;
+            failure = "no agent identity accepted";
+            while (keyAttempts > 0 && libssh2_agent_get_identity(agent, &identity, previous) == 0) {
+                --keyAttempts;
+                if (libssh2_agent_userauth(agent, username.c_str(), identity) == 0) {
+                    ok = true;
+                    break;
+                }
+                previous = identity;
+            }
+        }
+        libssh2_agent_disconnect(agent);
+    }
+    libssh2_agent_free(agent);
+    return ok;
+}
+
+} // namespace
+
+// ===== SSHKeyCache =====
+
+std::shared_ptr<const SSHKey> SSHKeyCache::load(const std::string& path, const std::string& passphrase) {
+    if (path.empty()) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = keys.find(path);
+    if (it != keys.end() && it->second->passphrase == passphrase) {
+        return it->second;
+    }
+
+    auto key = std::make_shared<SSHKey>();
+    const std::filesystem::path keyPath = std::filesystem::u8path(path);
+    if (!readWholeFile(keyPath, key->privateKey)) {
+        return nullptr;
+    }
+    std::filesystem::path pubPath = keyPath;
+    pubPath += ".pub";
+    readWholeFile(pubPath, key->publicKey);
+    key->sourcePath = path;
+    key->passphrase = passphrase;
+
+    keys[path] = key;
+    return key;
+}
+
+std::string SSHKeyCache::defaultKeyPath() {
+    if (const char* env = std::getenv("ADJUSTBIAS_SSH_KEY")) {
+        if (*env) {
+            return env;
+        }
+    }
+
+    const char* home = std::getenv("USERPROFILE");
+    if (!home || !*home) {
+        home = std::getenv("HOME");
+    }
+    if (!home || !*home) {
+        return std::string();
+    }
+    for (const char* name : {"id_ed25519", "id_ecdsa", "id_rsa"}) {
+        std::filesystem::path candidate = std::filesystem::u8path(home) / ".ssh" / name;
+        std::error_code ec;
+        if (std::filesystem::exists(candidate, ec)) {
+            return utf8Path(candidate);
+        }
+    }
+    return std::string();
+}
+
+void SSHKeyCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    keys.clear();
+}
+
+// ===== SSHAuthOptions =====
+
+SSHAuthOptions SSHAuthOptions::withPassword(const std::string& password) {
+    SSHAuthOptions options;
+    options.password = password;
+    return options;
+}
+
+SSHAuthOptions SSHAuthOptions::preferKeys(const std::string& password) {
+    SSHAuthOptions options;
+    options.password = password;
+    options.useAgent = true;
+    options.key = SSHKeyCache::load(SSHKeyCache::defaultKeyPath());
+    return options;
+}
+
+SSHAuthOptions SSHAuthOptions::passwordThenKeys(const std::string& password) {
+    SSHAuthOptions options = preferKeys(password);
+    options.passwordBeforeKeys = true;
+    return options;
+}
+
+// ===== 认证链 =====
+
+std::string authenticateSession(LIBSSH2_SESSION* session, const std::string& username, const SSHAuthOptions& options) {
+    // 查询服务器允许的认证方式（同时也是 SSH 协议要求的第一步）
+    const char* list = libssh2_userauth_list(session, username.c_str(), static_cast<unsigned int>(username.size()));
+    if (!list && libssh2_userauth_authenticated(session)) {
+        return "none";
+    }
+    const std::string allowed = list ? list : "";
+
+    std::string failures;
+    auto recordFailure = [&failures](const std::string& method, const std::string& reason) {
+        failures += (failures.empty() ? "" : "; ") + method + ": " + reason;
+    };
+
+    const bool passwordAllowed = !options.password.empty() && methodAllowed(allowed, "password");
+    auto tryPassword = [&]() {
+        if (libssh2_userauth_password(session, username.c_str(), options.password.c_str()) == 0) {
+            return true;
+        }
+        recordFailure("password", lastError(session));
+        return false;
+    };
+
+    if (options.passwordBeforeKeys && passwordAllowed && tryPassword()) {
+        return "password";
+    }
+
+    int keyAttempts = options.maxKeyAttempts;
+    if (options.useAgent && methodAllowed(allowed, "publickey")) {
+        std::string reason;
+        if (authenticateWithAgent(session, username, keyAttempts, reason)) {
+            return "agent";
+        }
+        recordFailure("agent", reason);
+    }
+
+    if (options.key && keyAttempts > 0 && methodAllowed(allowed, "publickey")) {
+        --keyAttempts;
+        const SSHKey& key = *options.key;
+        int rc = libssh2_userauth_publickey_frommemory(
+            session, username.c_str(), username.size(),
+            key.publicKey.empty() ? nullptr : key.publicKey.c_str(), key.publicKey.size(),
+            key.privateKey.c_str(), key.privateKey.size(),
+            key.passphrase.empty() ? nullptr : key.passphrase.c_str());
+        if (rc == 0) {
+            return "publickey";
+        }
+        recordFailure("publickey(" + key.sourcePath + ")", lastError(session));
+    }
+
+    if (!options.passwordBeforeKeys && passwordAllowed && tryPassword()) {
+        return "password";
+    }
+
+    if (failures.empty()) {
+        failures = "no usable authentication method (server allows: " + allowed + ")";
+    }
+    throw SSHAuthenticationException("Authentication failed: " + failures);
+}
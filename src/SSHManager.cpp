@@ -1,5 +1,7 @@
 #include "SSHManager.h"
 #include "Logger.h"
+#include "RemoteAgent.h"
+#include <algorithm>
 
 // 全局中断标志定义
 std::atomic<bool> g_interrupted(false);
@@ -7,6 +9,42 @@ std::atomic<bool> g_interrupted(false);
 // ===== Optimization #7: Removed old SSHException class =====
 // Now using structured exception hierarchy from Exceptions.h
 
+namespace {
+
+// libssh2_init / libssh2_exit 内部的引用计数没有加锁；批量审计会在多个线程中同时创建、销毁 SSHManager
+std::mutex g_libssh2InitMutex;
+
+int lockedLibssh2Init() {
+    std::lock_guard<std::mutex> lock(g_libssh2InitMutex);
+    return libssh2_init(0);
+}
+
+void lockedLibssh2Exit() {
+    std::lock_guard<std::mutex> lock(g_libssh2InitMutex);
+    libssh2_exit();
+}
+
+// 建连超时（毫秒），-1 表示尚未从环境变量读取
+std::atomic<int> g_connectTimeoutMs{-1};
+constexpr int kDefaultConnectTimeoutMs = 10000;
+
+} // namespace
+
+void SSHManager::setConnectTimeoutMs(int timeoutMs) {
+    g_connectTimeoutMs.store(timeoutMs > 0 ? timeoutMs : kDefaultConnectTimeoutMs);
+}
+
+int SSHManager::connectTimeoutMs() {
+    int timeoutMs = g_connectTimeoutMs.load();
+    if (timeoutMs < 0) {
+        const char* env = std::getenv("ADJUSTBIAS_CONNECT_TIMEOUT_MS");
+        timeoutMs = env ? std::atoi(env) : 0;
+        timeoutMs = timeoutMs > 0 ? timeoutMs : kDefaultConnectTimeoutMs;
+        g_connectTimeoutMs.store(timeoutMs);
+    }
+    return timeoutMs;
+}
+
 inline BOOL WINAPI ConsoleHandler(DWORD dwCtrlType) {
     if (dwCtrlType == CTRL_C_EVENT) {
         g_interrupted = true;
@@ -16,6 +54,8 @@ inline BOOL WINAPI ConsoleHandler(DWORD dwCtrlType) {
 }
 
 void SSHManager::cleanup() {
+    // 代理通道属于当前会话，必须先于会话释放
+    stopRemoteAgent();
     if (session) {
         libssh2_session_disconnect(session, "Normal shutdown");
         libssh2_session_free(session);
@@ -53,12 +93,47 @@ void SSHManager::connectSocket() {
             throw SSHConnectionException(errorMsg);
         }
 
-        // 连接服务器
+        // 连接服务器（TCP 三次握手耗时约等于一个 RTT，供 auto 传输方案使用）
+        // 非阻塞 connect + select 等待，离线主机在建连超时后失败，而不是等系统默认的约 21 秒
+        auto connectStart = std::chrono::steady_clock::now();
+        u_long nonBlocking = 1;
+        ioctlsocket(sock, FIONBIO, &nonBlocking);
         if (connect(sock, (struct sockaddr*)(&sin), sizeof(sin))) {
-            std::string errorMsg = "Connection failed: " + std::to_string(WSAGetLastError());
-            Logger::logException("SSHConnectionException", errorMsg, "connectSocket");
-            throw SSHConnectionException(errorMsg);
+            const int error = WSAGetLastError();
+            if (error != WSAEWOULDBLOCK && error != WSAEINPROGRESS) {
+                std::string errorMsg = "Connection failed: " + std::to_string(error);
+                Logger::logException("SSHConnectionException", errorMsg, "connectSocket");
+                throw SSHConnectionException(errorMsg);
+            }
+
+            const int timeoutMs = connectTimeoutOverrideMs > 0 ? connectTimeoutOverrideMs : connectTimeoutMs();
+            fd_set writeSet;
+            fd_set errorSet;
+            FD_ZERO(&writeSet);
+            FD_ZERO(&errorSet);
+            FD_SET(sock, &writeSet);
+            FD_SET(sock, &errorSet);
+            timeval tv;
+            tv.tv_sec = timeoutMs / 1000;
+            tv.tv_usec = (timeoutMs % 1000) * 1000;
+            const int ready = select(static_cast<int>(sock + 1), nullptr, &writeSet, &errorSet, &tv);
+            if (ready == 0) {
+                std::string errorMsg = "Connection timed out after " + std::to_string(timeoutMs) + " ms";
+                Logger::logException("SSHConnectionException", errorMsg, "connectSocket");
+                throw SSHConnectionException(errorMsg);
+            }
+            int soError = 0;
+            socklen_t len = sizeof(soError);
+            if (ready < 0 || getsockopt(sock, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&soError), &len) != 0 ||
+                soError != 0) {
+                std::string errorMsg = "Connection failed: " + std::to_string(ready < 0 ? WSAGetLastError() : soError);
+                Logger::logException("SSHConnectionException", errorMsg, "connectSocket");
+                throw SSHConnectionException(errorMsg);
+            }
         }
+        u_long blocking = 0;
+        ioctlsocket(sock, FIONBIO, &blocking);
+        connectRttMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - connectStart).count();
     } catch (...) {
         // 如果发生异常，确保关闭socket
         if (sock != INVALID_SOCKET) {
@@ -71,7 +146,7 @@ void SSHManager::connectSocket() {
 
 void SSHManager::initializeSSH() {
     // 初始化libssh2
-    if (libssh2_init(0)) {
+    if (lockedLibssh2Init()) {
         cleanup();
         std::string errorMsg = "libssh2 initialization failed";
         Logger::logException("SSHConnectionException", errorMsg, "initializeSSH");
@@ -82,7 +157,7 @@ void SSHManager::initializeSSH() {
     session = libssh2_session_init();
     if (!session) {
         cleanup();
-        libssh2_exit();
+        lockedLibssh2Exit();
         std::string errorMsg = "Failed to create SSH session";
         Logger::logException("SSHSessionException", errorMsg, "initializeSSH");
         throw SSHSessionException(errorMsg);
@@ -92,25 +167,8 @@ void SSHManager::initializeSSH() {
         // 设置会话为阻塞模式（文件操作需要）
         libssh2_session_set_blocking(session, 1);
 
-        // 握手
-        if (libssh2_session_handshake(session, sock)) {
-            std::string error = "SSH handshake failed: ";
-            char* errmsg;
-            libssh2_session_last_error(session, &errmsg, nullptr, 0);
-            error += errmsg;
-            Logger::logException("SSHConnectionException", error, "initializeSSH - handshake");
-            throw SSHConnectionException(error);
-        }
-
-        // 认证
-        if (libssh2_userauth_password(session, username.c_str(), password.c_str())) {
-            std::string error = "Authentication failed: ";
-            char* errmsg;
-            libssh2_session_last_error(session, &errmsg, nullptr, 0);
-            error += errmsg;
-            Logger::logException("SSHAuthenticationException", error, "initializeSSH - authentication");
-            throw SSHAuthenticationException(error);
-        }
+        // 握手 + 认证
+        handshakeAndAuthenticate("initializeSSH");
         
         sessionValid = true;
     } catch (const std::exception& e) {
@@ -121,60 +179,110 @@ void SSHManager::initializeSSH() {
             session = nullptr;
         }
         cleanup();
-        libssh2_exit();
+        lockedLibssh2Exit();
         throw; // 重新抛出异常
     }
 
-    // ===== Optimization #6: Use condition_variable instead of polling =====
-    // Benefits: Reduces CPU usage, improves responsiveness, allows graceful shutdown
-    if (!monitorRunning.load()) {
-        monitorRunning.store(true);
-        monitorThread = std::thread([this]() {
-            while (monitorRunning.load()) {
-                try {
-                    std::unique_lock<std::mutex> lock(monitorMutex);
-                    // Wait up to monitorIntervalMs for shutdown signal
-                    // If CV notified (shutdown), exit immediately
-                    // If timeout expires, continue monitoring
-                    if (monitorCV.wait_for(lock, std::chrono::milliseconds(monitorIntervalMs), 
-                        [this]() { return !monitorRunning.load(); })) {
-                        // Shutdown signal received
-                        break;
-                    }
-                    
-                    // Lock session for monitoring check
-                    std::lock_guard<std::mutex> sessionLock(sessionMutex);
-                    
-                    // Check if connection is still valid
-                    if (!sessionValid) {
-                        continue;
-                    }
-                    
-                    // Heartbeat check: verify SSH session is still active
-                    if (session && sessionValid) {
-                        libssh2_session_set_blocking(session, 0);
-                        // Simple heartbeat: check if we can read without blocking
-                        // EAGAIN means no data, which is OK for alive connection
-                        int rc = LIBSSH2_ERROR_EAGAIN;
-                        if (rc == LIBSSH2_ERROR_EAGAIN || rc >= 0) {
-                            // Connection appears healthy
-                        } else {
-                            qDebug() << "Heartbeat check failed, connection may be down";
-                            sessionValid = false;
-                        }
-                        libssh2_session_set_blocking(session, 1);
-                    }
-                    
-                    if (isSSHDisconnected()) {
-                        qDebug() << "Monitor: SSH connection detected as disconnected";
-                        sessionValid = false;
-                    }
-                } catch (...) {
-                    // Ignore monitoring exceptions, continue next iteration
-                }
-            }
-        });
+    // 断线检测与保活交给进程共用的事件循环
+    registerWithReactor();
+}
+
+// ===== 算法偏好 =====
+// 按传输方案（TransportProfile）设置算法偏好。libssh2_session_method_pref 替换（而不是重排）可协商的算法列表，
+// 因此列表为：方案中本地 libssh2 支持的算法在前，其余 libssh2 支持的算法按其默认顺序附在后面，
+// 服务器不支持偏好算法时仍能协商到与原来相同的算法，不会因偏好而握手失败。
+namespace {
+
+std::string preferredThenSupported(LIBSSH2_SESSION* session, int methodType, const std::string& preferred) {
+    if (preferred.empty()) {
+        return std::string();
+    }
+
+    const char** algs = nullptr;
+    int count = libssh2_session_supported_algs(session, methodType, &algs);
+    if (count <= 0 || !algs) {
+        return std::string();
+    }
+
+    std::vector<std::string> ordered;
+    auto supported = [&](const std::string& name) {
+        return std::any_of(algs, algs + count, [&](const char* alg) { return name == alg; });
+    };
+    auto listed = [&](const std::string& name) {
+        return std::find(ordered.begin(), ordered.end(), name) != ordered.end();
+    };
+    std::stringstream stream(preferred);
+    std::string name;
+    while (std::getline(stream, name, ',')) {
+        if (supported(name) && !listed(name)) {
+            ordered.push_back(name);
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        if (!listed(algs[i])) {
+            ordered.push_back(algs[i]);
+        }
+    }
+    libssh2_free(session, algs);
+
+    std::string result;
+    for (const std::string& alg : ordered) {
+        result += (result.empty() ? "" : ",") + alg;
+    }
+    return result;
+}
+
+void setPreference(LIBSSH2_SESSION* session, int methodType, const std::string& preferred) {
+    const std::string supported = preferredThenSupported(session, methodType, preferred);
+    // 设置失败不影响连接，libssh2 会回退到默认算法列表
+    if (!supported.empty()) {
+        libssh2_session_method_pref(session, methodType, supported.c_str());
+    }
+}
+
+} // namespace
+
+void SSHManager::applyMethodPreferences() {
+    // auto 方案按本次 TCP 建连测得的 RTT 解析（重连时重新测量）
+    activeTransport = transportProfile.isAuto() ? TransportProfile::forRtt(connectRttMs) : transportProfile;
+
+    setPreference(session, LIBSSH2_METHOD_KEX, activeTransport.kex);
+    setPreference(session, LIBSSH2_METHOD_HOSTKEY, activeTransport.hostKey);
+    setPreference(session, LIBSSH2_METHOD_CRYPT_CS, activeTransport.cipher);
+    setPreference(session, LIBSSH2_METHOD_CRYPT_SC, activeTransport.cipher);
+    setPreference(session, LIBSSH2_METHOD_MAC_CS, activeTransport.mac);
+    setPreference(session, LIBSSH2_METHOD_MAC_SC, activeTransport.mac);
+
+    // 压缩须在握手前打开；服务器未启用压缩时协商结果为 none
+    if (activeTransport.compress) {
+        libssh2_session_flag(session, LIBSSH2_FLAG_COMPRESS, 1);
+        setPreference(session, LIBSSH2_METHOD_COMP_CS, "zlib@openssh.com,zlib,none");
+        setPreference(session, LIBSSH2_METHOD_COMP_SC, "zlib@openssh.com,zlib,none");
+    }
+
+    qDebug() << "SSH transport profile:" << QString::fromStdString(activeTransport.name)
+             << "connect RTT(ms):" << connectRttMs;
+}
+
+void SSHManager::handshakeAndAuthenticate(const std::string& context) {
+    applyMethodPreferences();
+
+    if (libssh2_session_handshake(session, sock)) {
+        std::string error = "SSH handshake failed: ";
+        char* errmsg;
+        libssh2_session_last_error(session, &errmsg, nullptr, 0);
+        error += errmsg;
+        Logger::logException("SSHConnectionException", error, context + " - handshake");
+        throw SSHConnectionException(error);
+    }
+
+    try {
+        authMethod = authenticateSession(session, username, authOptions);
+    } catch (const SSHAuthenticationException& e) {
+        Logger::logException("SSHAuthenticationException", e.what(), context + " - authentication");
+        throw;
     }
+    qDebug() << "SSH authenticated via" << QString::fromStdString(authMethod);
 }
 
 // 异常日志记录已移至 Logger 类实现
@@ -308,8 +416,12 @@ bool SSHManager::checkSocketDisconnected() {
 // 对外接口：判断 SSH 是否断开（会检查 session 有效性和底层 socket）
 // 返回 true 表示已断开或不可用，false 表示连接看起来还活着
 bool SSHManager::isSSHDisconnected() {
-    // 首先快速检查内部标志
+    // 首先快速检查内部标志（包括事件循环检测到的断线）
     if (!sessionValid || !session) return true;
+    if (linkLost) {
+        sessionValid = false;
+        return true;
+    }
 
     // 检查 socket 层面是否断开
     if (checkSocketDisconnected()) {
@@ -326,29 +438,38 @@ bool SSHManager::isSSHDisconnected() {
     return false;
 }
 
+bool SSHManager::isTransportLost() {
+    if (!sessionValid || !session || linkLost) {
+        return true;
+    }
+    return checkSocketDisconnected();
+}
+
+int SSHManager::lastErrorCode() {
+    std::lock_guard<std::recursive_mutex> lock(sessionMutex);
+    return session ? libssh2_session_last_errno(session) : LIBSSH2_ERROR_SOCKET_NONE;
+}
+
 // 重新建立SSH连接
 void SSHManager::reconnect() {
-    std::lock_guard<std::mutex> lock(sessionMutex);
+    std::lock_guard<std::recursive_mutex> lock(sessionMutex);
     std::cout << "尝试重新建立SSH连接..." << std::endl;
     
     try {
-        // 停止监控线程
-        monitorRunning.store(false);
-        if (monitorThread.joinable()) {
-            monitorThread.join();
+        // 旧 socket 即将关闭，先让事件循环停止监视
+        if (reactorId) {
+            SessionReactor::instance().setSocket(reactorId, INVALID_SOCKET);
         }
-        
+
         // 清理现有资源
         cleanup();
         session = nullptr;
         
-        // 短暂等待后重新连接
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-        
-        // 重新连接
+        // 重新连接（重试间隔由调用方的退避策略控制：SessionReactor / RetryPolicy）
         connectSocket();
         
         // 重新初始化SSH
+        agentStartFailed = false;
         session = libssh2_session_init();
         if (!session) {
             throw SSHSessionException("Failed to recreate SSH session");
@@ -356,42 +477,18 @@ void SSHManager::reconnect() {
         
         libssh2_session_set_blocking(session, 1);
         
-        if (libssh2_session_handshake(session, sock)) {
-            std::string error = "SSH rehandshake failed: ";
-            char* errmsg;
-            libssh2_session_last_error(session, &errmsg, nullptr, 0);
-            error += errmsg;
-            throw SSHConnectionException(error);
-        }
-        
-        if (libssh2_userauth_password(session, username.c_str(), password.c_str())) {
-            std::string error = "Reauthentication failed: ";
-            char* errmsg;
-            libssh2_session_last_error(session, &errmsg, nullptr, 0);
-            error += errmsg;
-            throw SSHAuthenticationException(error);
-        }
+        handshakeAndAuthenticate("reconnect");
         
         sessionValid = true;
         std::cout << "SSH连接重新建立成功" << std::endl;
         
-        // 重新启动监控线程
-        monitorRunning.store(true);
-        monitorThread = std::thread([this]() {
-            while (monitorRunning.load()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(monitorIntervalMs));
-                try {
-                    std::lock_guard<std::mutex> lock(sessionMutex);
-                    if (isSSHDisconnected()) {
-                        std::cout << "监控: 检测到 SSH 连接已断开" << std::endl;
-                        sessionValid = false;
-                    }
-                } catch (...) {
-                    // 忽略监控中的异常，继续下一轮
-                }
-            }
-        });
-        
+        linkLost = false;
+        if (reactorId) {
+            SessionReactor::instance().setSocket(reactorId, sock);
+        } else {
+            registerWithReactor();
+        }
+
     } catch (...) {
         // 重连失败时确保资源清理
         cleanup();
@@ -400,9 +497,58 @@ void SSHManager::reconnect() {
     }
 }
 
+bool SSHManager::tryReconnect() {
+    try {
+        reconnect();
+        return true;
+    } catch (const std::exception& e) {
+        qDebug() << "自动重连失败:" << QString::fromStdString(host) << e.what();
+        return false;
+    }
+}
+
+// ===== 会话事件循环注册 =====
+// 回调捕获 this：析构 / 移动赋值前必须先 remove，SessionReactor::remove 返回后不会再调用回调
+void SSHManager::registerWithReactor() {
+    SessionReactor::Callbacks callbacks;
+    callbacks.keepalive = [this](int intervalSec) {
+        int next = intervalSec;
+        switch (sendKeepalive(intervalSec, &next)) {
+        case KeepaliveResult::Alive: return next > 0 ? next : 1;
+        case KeepaliveResult::Busy: return 0;
+        default: return -1;
+        }
+    };
+    callbacks.disconnected = [this]() {
+        linkLost = true;
+    };
+    callbacks.reconnect = [this]() {
+        return tryReconnect();
+    };
+    linkLost = false;
+    try {
+        reactorId = SessionReactor::instance().add(sock, callbacks);
+    } catch (const std::exception& e) {
+        // 事件循环不可用时只失去保活与断线检测，连接本身仍可使用
+        Logger::logException("NetworkException", std::string(e.what()), "registerWithReactor");
+        reactorId = 0;
+    }
+}
+
 SSHManager::SSHManager(const std::string& host, const std::string& username, 
            const std::string& password, int port)
-    : host(host), username(username), password(password), port(port) {
+    : SSHManager(host, username, SSHAuthOptions::withPassword(password), port) {
+}
+
+SSHManager::SSHManager(const std::string& host, const std::string& username,
+           const SSHAuthOptions& auth, int port)
+    : SSHManager(host, username, auth, port, TransportProfileRegistry::forHost(host)) {
+}
+
+SSHManager::SSHManager(const std::string& host, const std::string& username,
+           const SSHAuthOptions& auth, int port, const TransportProfile& transport, int connectTimeoutMs)
+    : host(host), username(username), password(auth.password), port(port), authOptions(auth),
+      transportProfile(transport), connectTimeoutOverrideMs(std::max(0, connectTimeoutMs)) {
     
     // 初始化Winsock
     WSADATA wsadata;
@@ -421,14 +567,20 @@ SSHManager::SSHManager(SSHManager&& other) noexcept {
 
 SSHManager& SSHManager::operator=(SSHManager&& other) noexcept {
     if (this != &other) {
-        // 释放当前资源
-        if (monitorRunning.load()) {
-            monitorRunning.store(false);
-            if (monitorThread.joinable()) {
-                monitorThread.join();
-            }
+        // 释放当前资源（回调捕获的是各自的 this，两边都先从事件循环注销）
+        if (reactorId) {
+            SessionReactor::instance().remove(reactorId);
+            reactorId = 0;
+        }
+        if (other.reactorId) {
+            SessionReactor::instance().remove(other.reactorId);
+            other.reactorId = 0;
         }
         cleanup();
+        // 代理持有原对象的指针，不随移动转移，由新对象按需重新启动
+        other.stopRemoteAgent();
+        agentEnabled = other.agentEnabled;
+        agentStartFailed = false;
         
         // 转移资源
         sock = other.sock;
@@ -436,6 +588,12 @@ SSHManager& SSHManager::operator=(SSHManager&& other) noexcept {
         host = std::move(other.host);
         username = std::move(other.username);
         password = std::move(other.password);
+        authOptions = std::move(other.authOptions);
+        authMethod = std::move(other.authMethod);
+        transportProfile = std::move(other.transportProfile);
+        activeTransport = std::move(other.activeTransport);
+        connectRttMs = other.connectRttMs;
+        connectTimeoutOverrideMs = other.connectTimeoutOverrideMs;
         port = other.port;
         sessionValid = other.sessionValid;
         
@@ -443,19 +601,22 @@ SSHManager& SSHManager::operator=(SSHManager&& other) noexcept {
         other.sock = INVALID_SOCKET;
         other.session = nullptr;
         other.sessionValid = false;
+
+        if (sock != INVALID_SOCKET) {
+            registerWithReactor();
+        }
     }
     return *this;
 }
 
 SSHManager::~SSHManager() {
     try {
-        // 停止监控线程
-        monitorRunning.store(false);
-        if (monitorThread.joinable()) {
-            monitorThread.join();
+        // 先注销，之后事件循环不会再访问本对象
+        if (reactorId) {
+            SessionReactor::instance().remove(reactorId);
         }
         cleanup();
-        libssh2_exit();
+        lockedLibssh2Exit();
         WSACleanup();
     } catch (...) {
         // 析构函数不应抛出异常，忽略所有异常
@@ -463,7 +624,7 @@ SSHManager::~SSHManager() {
 }
 
 LIBSSH2_SESSION* SSHManager::getSession() { 
-    std::lock_guard<std::mutex> lock(sessionMutex);
+    std::lock_guard<std::recursive_mutex> lock(sessionMutex);
     try {
         // 不再自动重连，仅检查会话有效性
         if (!checkSessionValidity()) {
@@ -481,31 +642,133 @@ LIBSSH2_SESSION* SSHManager::getSession() {
 std::string SSHManager::getPassword() { return password; }
 
 std::string SSHManager::getHost() { return host; }
-bool SSHManager::isSessionValid() { return sessionValid; }
+std::string SSHManager::getAuthMethod() const { return authMethod; }
+TransportProfile SSHManager::getTransportProfile() const { return activeTransport; }
+double SSHManager::getConnectRttMs() const { return connectRttMs; }
+bool SSHManager::isSessionValid() { return sessionValid && !linkLost; }
+
+SOCKET SSHManager::getSocket() const { return sock; }
+
+bool SSHManager::waitSocket(int timeoutMs) {
+    if (sock == INVALID_SOCKET || !session) {
+        return false;
+    }
+
+    fd_set readSet;
+    fd_set writeSet;
+    FD_ZERO(&readSet);
+    FD_ZERO(&writeSet);
+
+    int directions = libssh2_session_block_directions(session);
+    if (directions & LIBSSH2_SESSION_BLOCK_INBOUND) {
+        FD_SET(sock, &readSet);
+    }
+    if (directions & LIBSSH2_SESSION_BLOCK_OUTBOUND) {
+        FD_SET(sock, &writeSet);
+    }
+    if (directions == 0) {
+        // libssh2 没有报告方向时只等可读（socket 几乎总是可写，等可写会变成空转）
+        FD_SET(sock, &readSet);
+    }
+
+    timeval tv;
+    tv.tv_sec = timeoutMs / 1000;
+    tv.tv_usec = (timeoutMs % 1000) * 1000;
+    return select(static_cast<int>(sock + 1), &readSet, &writeSet, nullptr, &tv) > 0;
+}
+
+// ===== 常驻远端代理 =====
+
+void SSHManager::enableRemoteAgent(bool enabled) {
+    std::lock_guard<std::mutex> lock(agentMutex);
+    agentEnabled = enabled;
+    agentStartFailed = false;
+    if (!enabled) {
+        remoteAgent.reset();
+    }
+}
+
+RemoteAgent* SSHManager::getRemoteAgent() {
+    {
+        std::lock_guard<std::mutex> lock(agentMutex);
+        if (!agentEnabled || agentStartFailed || !sessionValid) {
+            return nullptr;
+        }
+        if (remoteAgent && remoteAgent->isRunning()) {
+            return remoteAgent.get();
+        }
+    }
+
+    // 启动过程会调用 getSession()（持有 sessionMutex），不能在持有 agentMutex 时进行，
+    // 否则与 reconnect()（持有 sessionMutex 后在 cleanup 中获取 agentMutex）形成锁顺序反转
+    auto agent = std::make_unique<RemoteAgent>(this);
+    const bool started = agent->start();
+
+    std::lock_guard<std::mutex> lock(agentMutex);
+    if (!started) {
+        agentStartFailed = true;
+        return nullptr;
+    }
+    if (!remoteAgent || !remoteAgent->isRunning()) {
+        remoteAgent = std::move(agent);
+        qDebug() << "远端代理已启动:" << QString::fromStdString(host);
+    }
+    return remoteAgent.get();
+}
+
+void SSHManager::stopRemoteAgent() {
+    std::lock_guard<std::mutex> lock(agentMutex);
+    remoteAgent.reset();
+}
+
+// ===== 保活 =====
+// 由 SessionReactor 的事件循环线程按定时器调用，代替每个连接一个监控线程。
+// 会话正被其他线程使用时不等待锁：此时连接显然还活着，本轮跳过即可。
+// 发送期间临时切换为非阻塞，发送缓冲区满时不会卡住事件循环（未发出的部分由下一次 libssh2 调用继续）。
+SSHManager::KeepaliveResult SSHManager::sendKeepalive(int intervalSec, int* nextSeconds) {
+    std::unique_lock<std::recursive_mutex> lock(sessionMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return KeepaliveResult::Busy;
+    }
+    if (!sessionValid || !session) {
+        return KeepaliveResult::Dead;
+    }
+
+    // libssh2 只在距上次发送超过 interval 秒时才真正发送，频繁调用没有额外开销
+    libssh2_keepalive_config(session, 1, static_cast<unsigned>(intervalSec > 0 ? intervalSec : 1));
+    int next = intervalSec;
+    const int wasBlocking = libssh2_session_get_blocking(session);
+    libssh2_session_set_blocking(session, 0);
+    const int rc = libssh2_keepalive_send(session, &next);
+    libssh2_session_set_blocking(session, wasBlocking);
+    if (nextSeconds) {
+        *nextSeconds = next;
+    }
+    if ((rc < 0 && rc != LIBSSH2_ERROR_EAGAIN) || checkSocketDisconnected()) {
+        qDebug() << "保活失败，连接已断开:" << QString::fromStdString(host);
+        sessionValid = false;
+        return KeepaliveResult::Dead;
+    }
+    return KeepaliveResult::Alive;
+}
 
 // 强制设置会话为无效（用于模拟中断后的状态）
 void SSHManager::invalidateSession() { 
     // 快速标记会话无效
     sessionValid = false;
     
-    // ===== Optimization #6: Signal condition variable for immediate shutdown =====
-    // This ensures the monitoring thread wakes up and exits immediately
-    // instead of waiting for the full timeout period
-    {
-        std::lock_guard<std::mutex> lock(monitorMutex);
-        monitorRunning.store(false);
-        monitorCV.notify_one();  // Wake up the monitoring thread
-    }
-    
-    // 等待监控线程结束（最多等待1秒）
-    if (monitorThread.joinable()) {
-        monitorThread.join();
+    // socket 即将关闭，事件循环停止监视（不当作断线上报）
+    if (reactorId) {
+        SessionReactor::instance().setSocket(reactorId, INVALID_SOCKET);
     }
     
     // 彻底清理SSH资源和socket连接
     if (session) {
         // 使用非阻塞方式断开连接，避免等待
         libssh2_session_set_blocking(session, 0);
+
+        // 代理通道随会话一起丢弃（非阻塞模式下不会等待对端确认）
+        stopRemoteAgent();
         
         // 发送断开请求（非阻塞）
         libssh2_session_disconnect(session, "User requested disconnect");
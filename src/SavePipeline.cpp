@@ -0,0 +1,193 @@
+#include "SavePipeline.h"
+#include "ConfigReader.h"
+#include "Exceptions.h"
+#include "TelemetryParser.h"
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+// 与 ConfigReader::writeMultipleParametersToFile 相同的格式化（默认 6 位有效数字）再解析回来，
+// 即写入后文件中应出现的数值
+double writtenValue(double value) {
+    std::ostringstream out;
+    out << value;
+    double parsed = value;
+    TelemetryLineParser::parseNumber(out.str(), parsed);
+    return parsed;
+}
+
+std::string trimmed(const std::string& s) {
+    const size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    return s.substr(begin, s.find_last_not_of(" \t\r\n") - begin + 1);
+}
+
+} // namespace
+
+SavePipeline::SavePipeline(ConfigReader* reader) : reader(reader) {}
+
+SavePipeline::~SavePipeline() {
+    wait();
+}
+
+bool SavePipeline::start(const Inputs& inputs, const Archiver& archiver) {
+    if (running.exchange(true)) {
+        return false;
+    }
+    if (worker.joinable()) {
+        worker.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        state = Progress();
+        outcome = Result();
+    }
+    worker = std::thread(&SavePipeline::run, this, inputs, archiver);
+    return true;
+}
+
+void SavePipeline::wait() {
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+SavePipeline::Progress SavePipeline::progress() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return state;
+}
+
+SavePipeline::Result SavePipeline::result() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return outcome;
+}
+
+const char* SavePipeline::stageName(Stage stage) {
+    switch (stage) {
+    case Stage::Validate: return "校验";
+    case Stage::Diff: return "比较";
+    case Stage::Write: return "写入";
+    case Stage::Verify: return "核对";
+    case Stage::Archive: return "存档";
+    default: return "完成";
+    }
+}
+
+bool SavePipeline::isDeletable(const std::string& param) {
+    return param == "x_vel_limit_walk" || param == "x_vel_limit_run";
+}
+
+void SavePipeline::enter(Stage stage, const std::string& message) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    state.stage = stage;
+    state.completedStages = static_cast<int>(stage);
+    state.message = message;
+}
+
+void SavePipeline::run(Inputs inputs, Archiver archiver) {
+    using Clock = std::chrono::steady_clock;
+    Result r;
+    Stage current = Stage::Validate;
+    auto stageStarted = Clock::now();
+    auto advance = [&](Stage next, const std::string& message) {
+        const auto now = Clock::now();
+        r.stageMs[static_cast<int>(current)] = std::chrono::duration<double, std::milli>(now - stageStarted).count();
+        current = next;
+        stageStarted = now;
+        enter(next, message);
+    };
+
+    try {
+        // ===== 校验 =====
+        enter(Stage::Validate, "校验输入");
+        for (const auto& input : inputs) {
+            const std::string text = trimmed(input.second);
+            if (isDeletable(input.first) && (text.empty() || text == "nan" || text == "未设置")) {
+                r.values.emplace_back(input.first, std::numeric_limits<double>::quiet_NaN());
+                continue;
+            }
+            double value = 0.0;
+            if (!TelemetryLineParser::parseNumber(text, value) || !std::isfinite(value)) {
+                throw ConfigException(input.first + " 不是有效数字: " + input.second);
+            }
+            r.values.emplace_back(input.first, value);
+        }
+
+        // ===== 比较 =====
+        advance(Stage::Diff, "比较改动");
+        for (const auto& target : r.values) {
+            Change change;
+            change.param = target.first;
+            change.after = target.second;
+            auto it = reader->parsedValues.find(target.first);
+            change.hadValue = it != reader->parsedValues.end();
+            change.before = change.hadValue ? it->second : 0.0;
+            const bool remove = std::isnan(target.second);
+            if (remove ? change.hadValue : (!change.hadValue || change.before != writtenValue(target.second))) {
+                r.changes.push_back(change);
+            }
+        }
+
+        // ===== 写入 =====
+        advance(Stage::Write, r.changes.empty() ? std::string("写入配置文件（无改动）")
+                                                : "写入 " + std::to_string(r.changes.size()) + " 处改动");
+        if (!reader->writeMultipleParametersToFile(r.values)) {
+            throw ConfigException("写入配置文件失败");
+        }
+        r.content = reader->lastWrittenContent;
+        r.liveUpdated = reader->wasLiveUpdated();
+
+        // ===== 核对 =====
+        // 解析实际写入的内容（同名参数以最后一次出现为准），确认每个参数都已是目标值
+        advance(Stage::Verify, "核对写入内容");
+        ConfigReader parser(nullptr, "");
+        std::string deduped;
+        if (!parser.parseConfigContent(r.content, deduped)) {
+            throw ConfigException("写入的配置内容无法解析");
+        }
+        for (const auto& target : r.values) {
+            auto it = parser.parsedValues.find(target.first);
+            if (std::isnan(target.second)) {
+                if (it != parser.parsedValues.end()) {
+                    throw ConfigException("核对失败: " + target.first + " 未被删除");
+                }
+            } else if (it == parser.parsedValues.end() || it->second != writtenValue(target.second)) {
+                throw ConfigException("核对失败: " + target.first + " 不是目标值");
+            }
+        }
+        // 作为下一次保存的比较基准
+        reader->parsedValues = parser.parsedValues;
+
+        // ===== 存档 =====
+        advance(Stage::Archive, "存档");
+        if (archiver) {
+            try {
+                r.archivePath = archiver(r.content);
+            } catch (const std::exception& e) {
+                r.archiveError = e.what();
+            }
+        }
+        advance(Stage::Done, "保存完成");
+        r.ok = true;
+    } catch (const std::exception& e) {
+        r.stageMs[static_cast<int>(current)] =
+            std::chrono::duration<double, std::milli>(Clock::now() - stageStarted).count();
+        r.failedStage = current;
+        r.error = e.what();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        outcome = std::move(r);
+        state.finished = true;
+        if (!outcome.ok) {
+            state.message = std::string(stageName(outcome.failedStage)) + "失败: " + outcome.error;
+        }
+    }
+    running = false;
+}
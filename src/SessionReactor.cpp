@@ -0,0 +1,334 @@
+#include "SessionReactor.h"
+#include "Exceptions.h"
+#include <ws2tcpip.h>
+#include <QDebug>
+#include <cstdlib>
+
+namespace {
+
+// 没有任何定时器到期时的最长等待；新增 / 更换 socket 会立即唤醒事件循环
+constexpr int kMaxWaitMs = 5000;
+
+int envIntOr(const char* name, int fallback) {
+    const char* value = std::getenv(name);
+    const int parsed = value ? std::atoi(value) : 0;
+    return parsed > 0 ? parsed : fallback;
+}
+
+} // namespace
+
+SessionReactor& SessionReactor::instance() {
+    static SessionReactor reactor(optionsFromEnvironment());
+    return reactor;
+}
+
+SessionReactor::Options SessionReactor::optionsFromEnvironment() {
+    Options options;
+    options.keepaliveSec = envIntOr("ADJUSTBIAS_KEEPALIVE_SEC", options.keepaliveSec);
+    options.workers = envIntOr("ADJUSTBIAS_REACTOR_WORKERS", options.workers);
+    const char* autoReconnect = std::getenv("ADJUSTBIAS_AUTO_RECONNECT");
+    options.autoReconnect = autoReconnect && std::atoi(autoReconnect) > 0;
+    return options;
+}
+
+SessionReactor::SessionReactor(const Options& options) : opts(options) {
+    WSADATA wsadata;
+    if (WSAStartup(MAKEWORD(2, 2), &wsadata)) {
+        throw NetworkException("WSAStartup failed: " + std::to_string(WSAGetLastError()));
+    }
+
+    // 唤醒用的 UDP socket：绑定回环地址的随机端口并 connect 到自身，wake() 发一个字节即可打断 WSAPoll
+    wakeSocket = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = 0;
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    socklen_t len = sizeof(addr);
+    u_long nonBlocking = 1;
+    if (wakeSocket == INVALID_SOCKET ||
+        bind(wakeSocket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        getsockname(wakeSocket, reinterpret_cast<sockaddr*>(&addr), &len) != 0 ||
+        connect(wakeSocket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ioctlsocket(wakeSocket, FIONBIO, &nonBlocking) != 0) {
+        const int error = WSAGetLastError();
+        if (wakeSocket != INVALID_SOCKET) {
+            closesocket(wakeSocket);
+        }
+        WSACleanup();
+        throw NetworkException("Reactor wakeup socket failed: " + std::to_string(error));
+    }
+
+    loopThread = std::thread(&SessionReactor::loop, this);
+    for (int i = 0; i < (opts.workers > 0 ? opts.workers : 1); ++i) {
+        workers.emplace_back(&SessionReactor::workerLoop, this);
+    }
+}
+
+SessionReactor::~SessionReactor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    wake();
+    if (loopThread.joinable()) {
+        loopThread.join();
+    }
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    closesocket(wakeSocket);
+    WSACleanup();
+}
+
+SessionReactor::Id SessionReactor::add(SOCKET sock, const Callbacks& callbacks) {
+    Id id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        id = nextId++;
+        Entry& entry = entries[id];
+        entry.callbacks = callbacks;
+        entry.backoff = Backoff(opts.reconnectBackoff);
+        entry.sock = sock;
+        entry.state = sock != INVALID_SOCKET ? State::Watching : State::Paused;
+        entry.nextKeepalive = Clock::now() + std::chrono::seconds(opts.keepaliveSec);
+        entry.quietUntil = Clock::now();
+    }
+    wake();
+    return id;
+}
+
+void SessionReactor::remove(Id id) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto it = entries.find(id);
+        if (it == entries.end()) {
+            return;
+        }
+        it->second.removing = true;
+        // 工作线程正在为该会话重连时等它结束（重连回调持有调用方对象的指针）
+        changed.wait(lock, [&]() { return stopping || it->second.state != State::Reconnecting; });
+        entries.erase(it);
+    }
+    wake();
+}
+
+void SessionReactor::setSocket(Id id, SOCKET sock) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(id);
+        if (it == entries.end()) {
+            return;
+        }
+        Entry& entry = it->second;
+        entry.sock = sock;
+        if (sock != INVALID_SOCKET) {
+            entry.state = State::Watching;
+            entry.backoff.reset();
+            entry.nextKeepalive = Clock::now() + std::chrono::seconds(opts.keepaliveSec);
+            entry.quietUntil = Clock::now();
+        } else if (entry.state != State::Reconnecting) {
+            // 重连过程中关闭旧 socket 时保持 Reconnecting，由工作线程根据结果决定下一状态
+            entry.state = State::Paused;
+        }
+    }
+    wake();
+}
+
+SessionReactor::Stats SessionReactor::stats() const {
+    Stats s;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        s.sessions = entries.size();
+    }
+    s.watched = watchedCount.load();
+    s.threads = 1 + workers.size();
+    s.loopIterations = iterations.load();
+    s.keepalives = keepalives.load();
+    s.disconnects = disconnects.load();
+    s.reconnects = reconnects.load();
+    s.reconnectFailures = reconnectFailures.load();
+    return s;
+}
+
+void SessionReactor::wake() {
+    const char byte = 0;
+    send(wakeSocket, &byte, 1, 0);
+}
+
+// 须持有 mutex
+void SessionReactor::markDead(Id id, Entry& entry, Clock::time_point now) {
+    entry.state = State::Dead;
+    entry.nextReconnect = now + entry.backoff.next();
+    ++disconnects;
+    qDebug() << "会话事件循环: 检测到连接断开, id =" << id;
+    if (entry.callbacks.disconnected) {
+        entry.callbacks.disconnected();
+    }
+}
+
+void SessionReactor::loop() {
+    std::vector<WSAPOLLFD> fds;
+    std::vector<Id> ids;
+
+    while (true) {
+        fds.clear();
+        ids.clear();
+        WSAPOLLFD wakeFd = {};
+        wakeFd.fd = wakeSocket;
+        wakeFd.events = POLLRDNORM;
+        fds.push_back(wakeFd);
+
+        auto now = Clock::now();
+        auto deadline = now + std::chrono::milliseconds(kMaxWaitMs);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) {
+                break;
+            }
+            for (auto& item : entries) {
+                Entry& entry = item.second;
+                if (entry.removing) {
+                    continue;
+                }
+                if (entry.state == State::Watching && now >= entry.nextKeepalive) {
+                    // 回调只 try_lock 会话锁，不会阻塞事件循环
+                    const int next = entry.callbacks.keepalive ? entry.callbacks.keepalive(opts.keepaliveSec)
+                                                               : opts.keepaliveSec;
+                    if (next < 0) {
+                        markDead(item.first, entry, now);
+                    } else {
+                        if (next > 0) {
+                            ++keepalives;
+                        }
+                        entry.nextKeepalive = now + std::chrono::seconds(next > 0 ? next : 1);
+                        entry.quietUntil = now;
+                    }
+                }
+
+                if (entry.state == State::Watching) {
+                    if (now >= entry.quietUntil) {
+                        WSAPOLLFD fd = {};
+                        fd.fd = entry.sock;
+                        fd.events = POLLRDNORM;
+                        fds.push_back(fd);
+                        ids.push_back(item.first);
+                    }
+                    deadline = (std::min)(deadline, entry.nextKeepalive);
+                } else if (entry.state == State::Dead && opts.autoReconnect && entry.callbacks.reconnect) {
+                    if (now >= entry.nextReconnect) {
+                        entry.state = State::Reconnecting;
+                        reconnectQueue.push_back(item.first);
+                        changed.notify_all();
+                    } else {
+                        deadline = (std::min)(deadline, entry.nextReconnect);
+                    }
+                }
+            }
+            watchedCount.store(ids.size());
+        }
+
+        // 向上取整到毫秒，避免最后不足 1 毫秒时以 0 超时空转
+        const auto waitMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - Clock::now() + std::chrono::microseconds(999)).count();
+        const int ready = WSAPoll(fds.data(), static_cast<ULONG>(fds.size()),
+                                  static_cast<int>(waitMs > 0 ? waitMs : 0));
+        ++iterations;
+        if (ready <= 0) {
+            continue;
+        }
+
+        if (fds[0].revents) {
+            char buf[64];
+            while (recv(wakeSocket, buf, sizeof(buf), 0) > 0) {
+            }
+        }
+
+        now = Clock::now();
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 1; i < fds.size(); ++i) {
+            if (!fds[i].revents) {
+                continue;
+            }
+            auto it = entries.find(ids[i - 1]);
+            // 等待期间会话可能已移除、重连或暂停，socket 已不是这一个
+            if (it == entries.end() || it->second.removing || it->second.state != State::Watching ||
+                it->second.sock != fds[i].fd) {
+                continue;
+            }
+            Entry& entry = it->second;
+            if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                markDead(it->first, entry, now);
+                continue;
+            }
+            // 可读：peek 区分对端关闭与待读数据（libssh2 握手后 socket 为非阻塞，peek 不会阻塞）
+            char byte;
+            const int n = recv(entry.sock, &byte, 1, MSG_PEEK);
+            if (n == 0) {
+                markDead(it->first, entry, now);
+            } else if (n < 0) {
+                const int error = WSAGetLastError();
+                if (error != WSAEWOULDBLOCK && error != WSAEINPROGRESS) {
+                    markDead(it->first, entry, now);
+                }
+            } else {
+                // 数据留给会话的使用方读取，到下一次保活前不再轮询这个 socket
+                entry.quietUntil = entry.nextKeepalive;
+            }
+        }
+    }
+}
+
+void SessionReactor::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this]() { return stopping || !reconnectQueue.empty(); });
+        if (stopping) {
+            return;
+        }
+        const Id id = reconnectQueue.front();
+        reconnectQueue.pop_front();
+        auto it = entries.find(id);
+        if (it == entries.end()) {
+            continue;
+        }
+        if (it->second.removing) {
+            it->second.state = State::Paused;
+            changed.notify_all();
+            continue;
+        }
+
+        // 处于 Reconnecting 状态时 remove() 会等待，条目在回调期间不会被删除
+        const auto reconnect = it->second.callbacks.reconnect;
+        lock.unlock();
+        bool ok = false;
+        try {
+            ok = reconnect();
+        } catch (...) {
+            ok = false;
+        }
+        lock.lock();
+
+        it = entries.find(id);
+        Entry& entry = it->second;
+        if (ok) {
+            ++reconnects;
+            if (entry.state == State::Reconnecting) {
+                // 回调没有通过 setSocket 提供新 socket，无从监视
+                entry.state = State::Paused;
+            }
+        } else {
+            ++reconnectFailures;
+            if (entry.state == State::Reconnecting) {
+                entry.state = State::Dead;
+                entry.nextReconnect = Clock::now() + entry.backoff.next();
+            }
+        }
+        changed.notify_all();
+        lock.unlock();
+        wake();
+        lock.lock();
+    }
+}
@@ -0,0 +1,168 @@
+#include "TelemetryParser.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+// 单行最长长度：超过时丢弃残行，避免无换行的垃圾数据无限占用内存
+constexpr size_t kMaxLineLength = 4096;
+constexpr int kMaxFields = 32;
+
+bool isSeparator(char c) {
+    return c == ',' || c == ' ' || c == '\t' || c == ';' || c == '\r';
+}
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+} // namespace
+
+int TelemetryLineParser::split(std::string_view line, std::string_view* fields, int maxFields) {
+    int count = 0;
+    size_t i = 0;
+    while (i < line.size() && count < maxFields) {
+        while (i < line.size() && isBlank(line[i])) {
+            ++i;
+        }
+        if (i == line.size()) {
+            break;
+        }
+        size_t start = i;
+        while (i < line.size() && !isSeparator(line[i])) {
+            ++i;
+        }
+        fields[count++] = line.substr(start, i - start);
+        while (i < line.size() && isBlank(line[i])) {
+            ++i;
+        }
+        if (i < line.size() && (line[i] == ',' || line[i] == ';')) {
+            ++i;
+        }
+    }
+    return count;
+}
+
+bool TelemetryLineParser::parseNumber(std::string_view field, double& value) {
+    const char* begin = field.data();
+    const char* end = begin + field.size();
+    if (begin != end && *begin == '+') {
+        ++begin;
+    }
+    auto result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+namespace {
+
+std::string lower(std::string_view s) {
+    std::string out(s);
+    std::transform(out.begin(), out.end(), out.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return out;
+}
+
+int fieldForName(const std::string& name) {
+    static const struct {
+        const char* name;
+        int field;
+    } aliases[] = {
+        {"t", TelemetryLineParser::Time}, {"time", TelemetryLineParser::Time},
+        {"timestamp", TelemetryLineParser::Time}, {"stamp", TelemetryLineParser::Time},
+        {"roll", TelemetryLineParser::Roll}, {"xsense_data_roll", TelemetryLineParser::Roll},
+        {"pitch", TelemetryLineParser::Pitch}, {"xsense_data_pitch", TelemetryLineParser::Pitch},
+        {"vx", TelemetryLineParser::Vx}, {"x_vel", TelemetryLineParser::Vx}, {"vel_x", TelemetryLineParser::Vx},
+        {"vy", TelemetryLineParser::Vy}, {"y_vel", TelemetryLineParser::Vy}, {"vel_y", TelemetryLineParser::Vy},
+        {"wz", TelemetryLineParser::Wz}, {"yaw_rate", TelemetryLineParser::Wz}, {"yaw_vel", TelemetryLineParser::Wz},
+        {"vyaw", TelemetryLineParser::Wz},
+    };
+    for (const auto& alias : aliases) {
+        if (name == alias.name) {
+            return alias.field;
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+TelemetryLineParser::TelemetryLineParser() {
+    reset();
+}
+
+void TelemetryLineParser::reset() {
+    for (int i = 0; i < FieldCount; ++i) {
+        columns[i] = i;
+    }
+    partial.clear();
+    malformed = 0;
+}
+
+const void* TelemetryLineParser::memchrSafe(const char* begin, const char* end) {
+    return begin < end ? std::memchr(begin, '\n', static_cast<size_t>(end - begin)) : nullptr;
+}
+
+void TelemetryLineParser::appendPartial(const char* begin, const char* end) {
+    if (partial.size() + static_cast<size_t>(end - begin) > kMaxLineLength) {
+        partial.clear();
+        ++malformed;
+        return;
+    }
+    partial.append(begin, end);
+}
+
+bool TelemetryLineParser::parseHeader(std::string_view line) {
+    std::string_view fields[kMaxFields];
+    const int count = split(line, fields, kMaxFields);
+
+    int mapped[FieldCount];
+    std::fill(std::begin(mapped), std::end(mapped), -1);
+    bool any = false;
+    for (int i = 0; i < count; ++i) {
+        int field = fieldForName(lower(fields[i]));
+        if (field >= 0 && mapped[field] < 0) {
+            mapped[field] = i;
+            any = true;
+        }
+    }
+    if (!any) {
+        return false;
+    }
+
+    std::copy(std::begin(mapped), std::end(mapped), columns);
+    return true;
+}
+
+bool TelemetryLineParser::parseLine(std::string_view line, TelemetrySample& sample) {
+    std::string_view fields[kMaxFields];
+    const int count = split(line, fields, kMaxFields);
+    if (count == 0) {
+        return false;   // 空行
+    }
+
+    double values[FieldCount];
+    for (int field = 0; field < FieldCount; ++field) {
+        const int column = columns[field];
+        if (column < 0) {
+            values[field] = field == Time ? std::numeric_limits<double>::quiet_NaN() : 0.0;
+            continue;
+        }
+        if (column >= count || !parseNumber(fields[column], values[field])) {
+            // 日志中途重启时表头可能再次出现
+            if (!parseHeader(line)) {
+                ++malformed;
+            }
+            return false;
+        }
+    }
+
+    sample.t = values[Time];
+    sample.roll = static_cast<float>(values[Roll]);
+    sample.pitch = static_cast<float>(values[Pitch]);
+    sample.vx = static_cast<float>(values[Vx]);
+    sample.vy = static_cast<float>(values[Vy]);
+    sample.wz = static_cast<float>(values[Wz]);
+    return true;
+}
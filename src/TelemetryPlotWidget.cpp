@@ -0,0 +1,239 @@
+#include "TelemetryPlotWidget.h"
+#include "TelemetryStream.h"
+#include <QCloseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QPolygonF>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr int kFrameIntervalMs = 33;             // 约 30 FPS
+constexpr size_t kHistoryCapacity = 1 << 17;     // 1kHz 输入下约 130 秒，覆盖最长显示窗口
+
+// 每个像素列的 M4 抽取结果
+struct Column {
+    float first = 0.0f;
+    float last = 0.0f;
+    float min = std::numeric_limits<float>::max();
+    float max = std::numeric_limits<float>::lowest();
+    bool used = false;
+};
+
+} // namespace
+
+TelemetryPlotWidget::TelemetryPlotWidget(QWidget* parent)
+    : QWidget(parent), history(kHistoryCapacity) {
+    setWindowTitle("遥测曲线");
+    resize(900, 520);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+
+    connect(&frameTimer, &QTimer::timeout, this, &TelemetryPlotWidget::onFrame);
+    frameTimer.start(kFrameIntervalMs);
+    rateClock.start();
+}
+
+void TelemetryPlotWidget::attach(TelemetryStream* newStream) {
+    stream = newStream;
+    clear();
+}
+
+void TelemetryPlotWidget::setWindowSeconds(double seconds) {
+    windowSeconds = std::max(0.5, seconds);
+    update();
+}
+
+void TelemetryPlotWidget::clear() {
+    historyStart = 0;
+    historySize = 0;
+    samplesSinceRate = 0;
+    inputRateHz = 0.0;
+    statusText.clear();
+    rateClock.restart();
+    update();
+}
+
+void TelemetryPlotWidget::closeEvent(QCloseEvent* event) {
+    emit closed();
+    QWidget::closeEvent(event);
+}
+
+void TelemetryPlotWidget::append(const TelemetrySample& sample) {
+    // 时间戳明显倒退说明数据源重启（日志轮转、节点重启），丢弃旧历史
+    if (historySize > 0 && sample.t < at(historySize - 1).t - 1.0) {
+        historyStart = 0;
+        historySize = 0;
+    }
+    if (historySize < history.size()) {
+        history[(historyStart + historySize) % history.size()] = sample;
+        ++historySize;
+    } else {
+        history[historyStart] = sample;
+        historyStart = (historyStart + 1) % history.size();
+    }
+}
+
+void TelemetryPlotWidget::onFrame() {
+    if (!stream) {
+        return;
+    }
+
+    samplesSinceRate += stream->samples().drain([this](const TelemetrySample& sample) { append(sample); });
+
+    const qint64 elapsed = rateClock.elapsed();
+    if (elapsed >= 1000) {
+        inputRateHz = samplesSinceRate * 1000.0 / static_cast<double>(elapsed);
+        samplesSinceRate = 0;
+        rateClock.restart();
+
+        TelemetryStream::Stats stats = stream->stats();
+        statusText = QString("%1 Hz  丢弃 %2  无效行 %3  绘制 %4 ms")
+                         .arg(inputRateHz, 0, 'f', 0)
+                         .arg(stats.dropped)
+                         .arg(stats.malformed)
+                         .arg(lastPaintMs, 0, 'f', 1);
+        if (!stream->isRunning()) {
+            statusText += "  已停止: " + QString::fromStdString(stream->lastError());
+        }
+    }
+
+    if (isVisible()) {
+        update();
+    }
+}
+
+void TelemetryPlotWidget::paintEvent(QPaintEvent* /*event*/) {
+    QElapsedTimer paintClock;
+    paintClock.start();
+
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+
+    if (historySize == 0) {
+        painter.setPen(Qt::darkGray);
+        painter.drawText(rect(), Qt::AlignCenter, statusText.isEmpty() ? QString("等待遥测数据...") : statusText);
+        return;
+    }
+
+    const double tEnd = at(historySize - 1).t;
+    const double tStart = tEnd - windowSeconds;
+
+    const QRect area = rect().adjusted(0, 16, 0, 0);
+    const QRect top(area.left(), area.top(), area.width(), area.height() / 2);
+    const QRect bottom(area.left(), top.bottom() + 1, area.width(), area.bottom() - top.bottom());
+
+    drawPane(painter, top, "姿态 (°)",
+             {{"roll", &TelemetrySample::roll, QColor(220, 50, 47)},
+              {"pitch", &TelemetrySample::pitch, QColor(38, 139, 210)}},
+             tStart, tEnd);
+    drawPane(painter, bottom, "速度 (m/s, rad/s)",
+             {{"vx", &TelemetrySample::vx, QColor(133, 153, 0)},
+              {"vy", &TelemetrySample::vy, QColor(211, 54, 130)},
+              {"wz", &TelemetrySample::wz, QColor(108, 113, 196)}},
+             tStart, tEnd);
+
+    painter.setPen(Qt::darkGray);
+    painter.drawText(rect().adjusted(8, 2, -8, 0), Qt::AlignRight | Qt::AlignTop,
+                     QString("窗口 %1 s  %2").arg(windowSeconds, 0, 'f', 0).arg(statusText));
+
+    lastPaintMs = paintClock.nsecsElapsed() / 1e6;
+}
+
+void TelemetryPlotWidget::drawPane(QPainter& painter, const QRect& area, const QString& title,
+                                   const std::vector<Series>& series, double tStart, double tEnd) {
+    const QRect plot = area.adjusted(56, 22, -12, -8);
+    const int width = plot.width();
+    if (width <= 1 || plot.height() <= 1 || tEnd <= tStart) {
+        return;
+    }
+
+    // 历史按时间有序，二分查找窗口起点
+    size_t lo = 0;
+    size_t hi = historySize;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (at(mid).t < tStart) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    // 一次遍历完成所有曲线的按列抽取、纵轴范围与均值
+    std::vector<Column> columns(series.size() * static_cast<size_t>(width));
+    std::vector<double> sums(series.size(), 0.0);
+    size_t count = 0;
+    float yMin = std::numeric_limits<float>::max();
+    float yMax = std::numeric_limits<float>::lowest();
+    const double scale = (width - 1) / (tEnd - tStart);
+    for (size_t i = lo; i < historySize; ++i) {
+        const TelemetrySample& sample = at(i);
+        const int x = std::clamp(static_cast<int>((sample.t - tStart) * scale), 0, width - 1);
+        for (size_t s = 0; s < series.size(); ++s) {
+            const float v = sample.*(series[s].field);
+            Column& column = columns[s * width + x];
+            if (!column.used) {
+                column.first = v;
+                column.used = true;
+            }
+            column.last = v;
+            column.min = std::min(column.min, v);
+            column.max = std::max(column.max, v);
+            yMin = std::min(yMin, v);
+            yMax = std::max(yMax, v);
+            sums[s] += v;
+        }
+        ++count;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    // 偏置量级很小（千分之一），留出 10% 余量但不强制放大到固定范围
+    const float pad = std::max((yMax - yMin) * 0.1f, 1e-4f);
+    yMin -= pad;
+    yMax += pad;
+    auto toY = [&](float v) { return plot.bottom() - (v - yMin) / (yMax - yMin) * plot.height(); };
+
+    painter.setPen(QColor(200, 200, 200));
+    painter.drawRect(plot);
+    if (yMin < 0.0f && yMax > 0.0f) {
+        painter.setPen(QPen(QColor(160, 160, 160), 1, Qt::DashLine));
+        painter.drawLine(QPointF(plot.left(), toY(0.0f)), QPointF(plot.right(), toY(0.0f)));
+    }
+
+    painter.setPen(Qt::black);
+    painter.drawText(area.left() + 4, area.top() + 14, title);
+    painter.setPen(Qt::darkGray);
+    painter.drawText(QRect(area.left(), plot.top() - 6, 52, 14), Qt::AlignRight, QString::number(yMax, 'g', 4));
+    painter.drawText(QRect(area.left(), plot.bottom() - 8, 52, 14), Qt::AlignRight, QString::number(yMin, 'g', 4));
+
+    // M4：每列按 首 -> 最小 -> 最大 -> 尾 连接，与逐点绘制的像素结果一致
+    QPolygonF points;
+    points.reserve(width * 4);
+    int legendX = area.left() + 120;
+    const TelemetrySample& latest = at(historySize - 1);
+    for (size_t s = 0; s < series.size(); ++s) {
+        points.clear();
+        for (int x = 0; x < width; ++x) {
+            const Column& column = columns[s * width + x];
+            if (!column.used) {
+                continue;
+            }
+            const double px = plot.left() + x;
+            points << QPointF(px, toY(column.first)) << QPointF(px, toY(column.min))
+                   << QPointF(px, toY(column.max)) << QPointF(px, toY(column.last));
+        }
+        painter.setPen(QPen(series[s].color, 1));
+        painter.drawPolyline(points);
+
+        const QString legend = QString("%1 %2 (均值 %3)")
+                                   .arg(series[s].name)
+                                   .arg(latest.*(series[s].field), 0, 'f', 4)
+                                   .arg(sums[s] / count, 0, 'f', 4);
+        painter.drawText(legendX, area.top() + 14, legend);
+        legendX += painter.fontMetrics().horizontalAdvance(legend) + 16;
+    }
+}
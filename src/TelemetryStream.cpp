@@ -0,0 +1,262 @@
+#include "TelemetryStream.h"
+#include "FileHandler.h"
+#include "ForwardManager.h"
+#include "ResourceManager.h"
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+
+constexpr size_t kReadBufferSize = 64 * 1024;
+
+// 读取线程在没有数据时的最长等待，决定 stop() 的响应时间
+constexpr int kIdleWaitMs = 50;
+
+std::string sessionError(LIBSSH2_SESSION* session) {
+    char* errmsg = nullptr;
+    libssh2_session_last_error(session, &errmsg, nullptr, 0);
+    return errmsg ? std::string(errmsg) : std::string("unknown error");
+}
+
+bool waitReadable(SOCKET s, int timeoutMs) {
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(s, &readSet);
+    timeval tv;
+    tv.tv_sec = timeoutMs / 1000;
+    tv.tv_usec = (timeoutMs % 1000) * 1000;
+    return select(static_cast<int>(s + 1), &readSet, nullptr, nullptr, &tv) > 0;
+}
+
+} // namespace
+
+// ===== 数据源 =====
+
+bool TelemetryStream::Source::parse(const std::string& spec, Source& out) {
+    const size_t colon = spec.find(':');
+    if (colon == std::string::npos || colon + 1 >= spec.size()) {
+        return false;
+    }
+    const std::string kind = spec.substr(0, colon);
+    const std::string rest = spec.substr(colon + 1);
+
+    Source source;
+    if (kind == "tail") {
+        source.kind = Tail;
+        source.path = rest;
+    } else if (kind == "tcp") {
+        source.kind = Tcp;
+        const size_t hostSep = rest.find(':');
+        source.port = std::atoi(rest.substr(0, hostSep).c_str());
+        if (source.port <= 0 || source.port > 65535) {
+            return false;
+        }
+        if (hostSep != std::string::npos && hostSep + 1 < rest.size()) {
+            source.host = rest.substr(hostSep + 1);
+        }
+    } else {
+        return false;
+    }
+    out = source;
+    return true;
+}
+
+bool TelemetryStream::Source::fromEnvironment(Source& out) {
+    const char* spec = std::getenv("ADJUSTBIAS_TELEMETRY");
+    return spec && *spec && parse(spec, out);
+}
+
+std::string TelemetryStream::Source::describe() const {
+    if (kind == Tail) {
+        return "tail:" + path;
+    }
+    return "tcp:" + std::to_string(port) + ":" + host;
+}
+
+// ===== 读取线程 =====
+
+TelemetryStream::TelemetryStream(SSHManager* manager, size_t ringCapacity)
+    : sshManager(manager), ring(ringCapacity) {}
+
+TelemetryStream::~TelemetryStream() {
+    try {
+        stop();
+    } catch (...) {
+        // 析构函数不应抛出异常
+    }
+}
+
+void TelemetryStream::start(const Source& newSource) {
+    stop();
+    source = newSource;
+    parser.reset();
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        error.clear();
+    }
+
+    LIBSSH2_SESSION* current = sshManager ? sshManager->getSession() : nullptr;
+    if (!current) {
+        throw SSHSessionException("无法获取有效的SSH会话");
+    }
+
+    if (source.kind == Source::Tail) {
+        // 先输出表头行，再只跟随新追加的数据（-F：日志轮转后重新打开）
+        const std::string quoted = FileHandler::shellQuote(source.path);
+        const std::string command = "head -n 1 -- " + quoted + "; exec tail -n 0 -F -- " + quoted + " 2>/dev/null";
+
+        auto sessionLock = sshManager->lockSession();
+        channel = libssh2_channel_open_session(current);
+        if (!channel) {
+            throw SSHSessionException("打开遥测通道失败: " + sessionError(current));
+        }
+        if (libssh2_channel_exec(channel, command.c_str())) {
+            std::string message = "启动 tail 失败: " + sessionError(current);
+            libssh2_channel_free(channel);
+            channel = nullptr;
+            throw SSHSessionException(message);
+        }
+        session = current;
+    } else {
+        forwards = std::make_unique<ForwardManager>(sshManager);
+        const int localPort = forwards->addLocalForward(source.host, source.port);
+        forwards->start();
+
+        sock = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in sin{};
+        sin.sin_family = AF_INET;
+        sin.sin_port = htons(static_cast<u_short>(localPort));
+        inet_pton(AF_INET, "127.0.0.1", &sin.sin_addr);
+        if (sock == INVALID_SOCKET || connect(sock, reinterpret_cast<sockaddr*>(&sin), sizeof(sin))) {
+            std::string message = "连接遥测转发端口失败: " + std::to_string(WSAGetLastError());
+            stop();
+            throw NetworkException(message);
+        }
+    }
+
+    startedAt = std::chrono::steady_clock::now();
+    running.store(true);
+    readerThread = std::thread(source.kind == Source::Tail ? &TelemetryStream::tailLoop : &TelemetryStream::socketLoop, this);
+    qDebug() << "遥测数据流已启动:" << QString::fromStdString(source.describe());
+}
+
+void TelemetryStream::stop() {
+    running.store(false);
+    if (readerThread.joinable()) {
+        readerThread.join();
+    }
+
+    if (channel) {
+        if (!sessionChanged()) {
+            auto sessionLock = sshManager->lockSession();
+            libssh2_channel_close(channel);
+            libssh2_channel_free(channel);
+        }
+        channel = nullptr;
+        session = nullptr;
+    }
+    if (sock != INVALID_SOCKET) {
+        closesocket(sock);
+        sock = INVALID_SOCKET;
+    }
+    if (forwards) {
+        forwards->stop();
+        forwards.reset();
+    }
+}
+
+TelemetryStream::Stats TelemetryStream::stats() const {
+    Stats stats;
+    stats.bytes = byteCount.load();
+    stats.samples = sampleCount.load();
+    stats.dropped = ring.dropped();
+    stats.malformed = malformedCount.load();
+    return stats;
+}
+
+std::string TelemetryStream::lastError() const {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    return error;
+}
+
+void TelemetryStream::fail(const std::string& message) {
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        error = message;
+    }
+    qDebug() << "遥测数据流停止:" << QString::fromStdString(message);
+    running.store(false);
+}
+
+bool TelemetryStream::sessionChanged() const {
+    return !sshManager->isSessionValid() || sshManager->peekSession() != session;
+}
+
+void TelemetryStream::consume(const char* data, size_t len) {
+    byteCount.fetch_add(len, std::memory_order_relaxed);
+    const double now = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+    const size_t parsed = parser.feed(data, len, [this, now](const TelemetrySample& sample) {
+        if (std::isnan(sample.t)) {
+            TelemetrySample stamped = sample;
+            stamped.t = now;
+            ring.push(stamped);
+        } else {
+            ring.push(sample);
+        }
+    });
+    sampleCount.fetch_add(parsed, std::memory_order_relaxed);
+    malformedCount.store(parser.malformedLines(), std::memory_order_relaxed);
+}
+
+void TelemetryStream::tailLoop() {
+    std::unique_ptr<char[]> buffer(new char[kReadBufferSize]);
+    bool progressed = false;
+    while (running.load()) {
+        // 上一轮读满了缓冲区时 libssh2 内部可能还有数据，不等待直接再读
+        if (!progressed) {
+            waitReadable(sshManager->getSocket(), kIdleWaitMs);
+        }
+        progressed = false;
+
+        auto sessionLock = sshManager->lockSession();
+        if (sessionChanged()) {
+            fail("SSH会话已失效");
+            break;
+        }
+
+        ResourceManagement::NonBlockingScope nonBlocking(session);
+        ssize_t n = libssh2_channel_read(channel, buffer.get(), kReadBufferSize);
+        if (n > 0) {
+            consume(buffer.get(), static_cast<size_t>(n));
+            progressed = static_cast<size_t>(n) == kReadBufferSize;
+        } else if (n == 0 || n == LIBSSH2_ERROR_EAGAIN) {
+            if (libssh2_channel_eof(channel)) {
+                fail("远端 tail 已退出（文件不存在或无权限？）");
+                break;
+            }
+        } else {
+            fail("读取遥测通道失败: " + sessionError(session));
+            break;
+        }
+    }
+}
+
+void TelemetryStream::socketLoop() {
+    std::unique_ptr<char[]> buffer(new char[kReadBufferSize]);
+    while (running.load()) {
+        if (!waitReadable(sock, kIdleWaitMs)) {
+            if (forwards && !forwards->isRunning()) {
+                fail("SSH会话已失效");
+                break;
+            }
+            continue;
+        }
+        int n = recv(sock, buffer.get(), static_cast<int>(kReadBufferSize), 0);
+        if (n > 0) {
+            consume(buffer.get(), static_cast<size_t>(n));
+        } else {
+            fail(n == 0 ? "机器人端关闭了遥测连接" : "读取遥测数据失败: " + std::to_string(WSAGetLastError()));
+            break;
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include "TransportProfile.h"
+#include <cstdlib>
+
+std::mutex TransportProfileRegistry::mutex;
+std::map<std::string, TransportProfile> TransportProfileRegistry::profiles;
+
+namespace {
+
+// 两种方案共用的握手算法：curve25519 / ed25519 计算量最小
+const char* kFastKex = "curve25519-sha256,curve25519-sha256@libssh.org,ecdh-sha2-nistp256,"
+                       "diffie-hellman-group14-sha256,diffie-hellman-group14-sha1";
+const char* kFastHostKey = "ssh-ed25519,ecdsa-sha2-nistp256,rsa-sha2-256,rsa-sha2-512,ssh-rsa";
+
+// AES-GCM 在有 AES-NI 的机器上最快，CTR + ETM MAC 作为不支持 AEAD 时的回退
+const char* kFastCipher = "aes128-gcm@openssh.com,aes256-gcm@openssh.com,aes128-ctr,aes256-ctr";
+const char* kFastMac = "hmac-sha2-256-etm@openssh.com,hmac-sha2-256,hmac-sha1";
+
+} // namespace
+
+TransportProfile TransportProfile::lan() {
+    TransportProfile profile;
+    profile.name = "lan";
+    profile.kex = kFastKex;
+    profile.hostKey = kFastHostKey;
+    profile.cipher = kFastCipher;
+    profile.mac = kFastMac;
+    profile.compress = false;
+    return profile;
+}
+
+TransportProfile TransportProfile::wifi() {
+    TransportProfile profile = lan();
+    profile.name = "wifi";
+    profile.compress = true;
+    return profile;
+}
+
+TransportProfile TransportProfile::libssh2Default() {
+    TransportProfile profile;
+    profile.name = "default";
+    return profile;
+}
+
+TransportProfile TransportProfile::automatic() {
+    TransportProfile profile = lan();
+    profile.name = "auto";
+    return profile;
+}
+
+bool TransportProfile::byName(const std::string& name, TransportProfile& profile) {
+    if (name == "lan") {
+        profile = lan();
+    } else if (name == "wifi") {
+        profile = wifi();
+    } else if (name == "default" || name.empty()) {
+        profile = libssh2Default();
+    } else if (name == "auto") {
+        profile = automatic();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+TransportProfile TransportProfile::forRtt(double rttMs) {
+    return rttMs < autoLanRttMs ? lan() : wifi();
+}
+
+// ===== TransportProfileRegistry =====
+
+void TransportProfileRegistry::setForHost(const std::string& host, const TransportProfile& profile) {
+    std::lock_guard<std::mutex> lock(mutex);
+    profiles[host] = profile;
+}
+
+TransportProfile TransportProfileRegistry::forHost(const std::string& host, const TransportProfile& fallback) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = profiles.find(host);
+        if (it != profiles.end()) {
+            return it->second;
+        }
+    }
+
+    TransportProfile profile = fallback;
+    if (const char* env = std::getenv("ADJUSTBIAS_SSH_PROFILE")) {
+        TransportProfile::byName(env, profile);
+    }
+    return profile;
+}
@@ -0,0 +1,86 @@
+#include "../include/Workspace.h"
+#include "../include/widget.h"
+#include <QMessageBox>
+#include <QTabBar>
+#include <QTabWidget>
+#include <QToolButton>
+#include <QVBoxLayout>
+
+Workspace::Workspace(QWidget* parent) : QWidget(parent) {
+    tabs = new QTabWidget(this);
+    tabs->setTabsClosable(true);
+    tabs->setMovable(true);
+    tabs->setDocumentMode(true);
+
+    QToolButton* addButton = new QToolButton(tabs);
+    addButton->setText("+");
+    addButton->setToolTip("新建机器人标签页（每个标签页独立连接）");
+    addButton->setAutoRaise(true);
+    tabs->setCornerWidget(addButton, Qt::TopRightCorner);
+    connect(addButton, &QToolButton::clicked, this, [this]() { addRobot(); });
+    connect(tabs, &QTabWidget::tabCloseRequested, this, &Workspace::closeRobot);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(tabs);
+
+    addRobot();
+    resize(tabs->currentWidget()->size() + QSize(0, tabs->tabBar()->sizeHint().height()));
+
+    // 只读取各会话的断线标志，每秒一次，断线能在一秒内反映到标签页
+    connect(&linkTimer, &QTimer::timeout, this, &Workspace::onLinkTick);
+    linkTimer.start(1000);
+}
+
+Workspace::~Workspace() {
+    linkTimer.stop();
+}
+
+Widget* Workspace::addRobot() {
+    Widget* robot = new Widget(tabs);
+    connect(robot, &Widget::sessionStateChanged, this, [this, robot]() { refreshTitle(robot); });
+    const int index = tabs->addTab(robot, robot->sessionTitle());
+    tabs->setCurrentIndex(index);
+    return robot;
+}
+
+void Workspace::closeRobot(int index) {
+    Widget* robot = qobject_cast<Widget*>(tabs->widget(index));
+    if (!robot) {
+        return;
+    }
+    if (robot->isBusy()) {
+        QMessageBox::information(this, "信息", "该机器人正在保存配置，请等待保存完成后再关闭。");
+        return;
+    }
+    if (robot->hasSession()) {
+        QMessageBox::StandardButton reply = QMessageBox::question(
+            this, "确认", QString("关闭 %1 的标签页并断开连接？").arg(robot->sessionTitle()),
+            QMessageBox::Yes | QMessageBox::No);
+        if (reply != QMessageBox::Yes) {
+            return;
+        }
+    }
+
+    tabs->removeTab(index);
+    // 析构时停止该会话的实时调节 / 遥测 / 保存线程并断开连接
+    delete robot;
+    if (tabs->count() == 0) {
+        addRobot();
+    }
+}
+
+void Workspace::refreshTitle(Widget* robot) {
+    const int index = tabs->indexOf(robot);
+    if (index >= 0) {
+        tabs->setTabText(index, robot->sessionTitle());
+    }
+}
+
+void Workspace::onLinkTick() {
+    for (int i = 0; i < tabs->count(); ++i) {
+        if (Widget* robot = qobject_cast<Widget*>(tabs->widget(i))) {
+            robot->pollLink();
+        }
+    }
+}
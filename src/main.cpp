@@ -1,4 +1,5 @@
 #include "../include/widget.h"
+#include "../include/Workspace.h"
 
 #include <QApplication>
 #include <QLocale>
@@ -23,7 +24,7 @@ int main(int argc, char *argv[])
             break;
         }
     }
-    Widget w;
+    Workspace w;
     w.setWindowTitle("强化模式偏置调整V0.5.1");
     w.show();
     return a.exec();
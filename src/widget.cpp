@@ -8,6 +8,7 @@
 #include <QDir>
 #include <QTextStream>
 #include <QFile>
+#include <QFileInfo>
 #include <QDialog>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -15,8 +16,12 @@
 #include <QTextEdit>
 #include <QPushButton>
 #include <QStandardPaths>
+#include <QInputDialog>
+#include <QTableWidget>
+#include <QHeaderView>
 #include <iostream>
 #include <cmath>
+#include <cstdlib>
 #include <limits>
 #include <limits>
 
@@ -64,183 +69,211 @@ Widget::Widget(QWidget *parent)
 
     connect(ui->ip_lineEdit, &QLineEdit::returnPressed, this, &Widget::on_loadButton_clicked);
     connect(ui->disconnectButton, &QPushButton::clicked, this, &Widget::on_disconnectButton_clicked);    
+    connect(&streamTimer, &QTimer::timeout, this, &Widget::onStreamTick);
+    connect(&saveTimer, &QTimer::timeout, this, &Widget::onSaveTick);
+    connect(&estimateTimer, &QTimer::timeout, this, &Widget::onEstimateTick);
+    ui->saveProgressBar->setRange(0, SavePipeline::kStageCount);
+    ui->saveProgressBar->setValue(0);
+
+    streamParamNames = {
+        {&q_xsense_data_roll, "xsense_data_roll"},
+        {&q_xsense_data_pitch, "xsense_data_pitch"},
+        {&q_x_vel_offset, "x_vel_offset"},
+        {&q_y_vel_offset, "y_vel_offset"},
+        {&q_yaw_vel_offset, "yaw_vel_offset"},
+        {&q_x_vel_offset_run, "x_vel_offset_run"},
+        {&q_y_vel_offset_run, "y_vel_offset_run"},
+        {&q_yaw_vel_offset_run, "yaw_vel_offset_run"}
+    };
+
+    saveFields = {
+        {"xsense_data_roll", ui->roll_lineEdit, &q_xsense_data_roll},
+        {"xsense_data_pitch", ui->pitch_lineEdit, &q_xsense_data_pitch},
+        {"x_vel_offset", ui->x_lineEdit, &q_x_vel_offset},
+        {"y_vel_offset", ui->y_lineEdit, &q_y_vel_offset},
+        {"yaw_vel_offset", ui->yaw_lineEdit, &q_yaw_vel_offset},
+        {"x_vel_offset_run", ui->x_run_lineEdit, &q_x_vel_offset_run},
+        {"y_vel_offset_run", ui->y_run_lineEdit, &q_y_vel_offset_run},
+        {"yaw_vel_offset_run", ui->yaw_run_lineEdit, &q_yaw_vel_offset_run},
+        {"x_vel_limit_walk", ui->limit_walk_lineEdit, &q_x_vel_limit_walk},
+        {"x_vel_limit_run", ui->limit_run_lineEdit, &q_x_vel_limit_run}
+    };
 }
 
 Widget::~Widget()
 {
+    streamTimer.stop();
+    streamer.reset();
+    stopTelemetry();
+    // 等待进行中的保存结束（工作线程使用 configReader）
+    saveTimer.stop();
+    savePipeline.reset();
+    // 偏置估计工作线程使用 sshManager，先取消并等待其退出
+    estimateTimer.stop();
+    if (estimateJob) {
+        estimateJob->cancel = true;
+    }
+    if (estimateWorker.joinable()) {
+        estimateWorker.join();
+    }
     delete ui;
 }
 
 
 
+// ===== 保存 =====
+// 校验 → 比较 → 写入 → 核对 → 存档 在 SavePipeline 的工作线程中执行，界面只按定时器刷新进度条与状态栏，
+// 保存期间界面保持响应；核对与存档直接使用写入的内容，不再额外读一次远端文件，也不再弹出模态对话框。
 void Widget::on_saveButton_clicked() {
-    try{
-        // 添加前置检查，避免在资源未初始化时执行
-        if (!sshManager || !configReader) {
-            QMessageBox::warning(this, "错误", "系统未初始化，请先点击加载按钮！");
-            return;
-        }
-        
-        // 检查SSH连接状态
-        if (sshManager->isSSHDisconnected()) {
-            QMessageBox::warning(this, "错误", "SSH连接已断开，请重新连接！");
-            return;
-        }
-        
-        // 额外检查：确保SSH会话仍然有效
-        if (!sshManager->getSession()) {
-            QMessageBox::warning(this, "错误", "SSH会话无效，请重新连接！");
-            return;
-        }
-        QProgressDialog progressDialog("正在保存配置...", "", 0, 0, this);
-        progressDialog.setWindowTitle("保存配置");
-        progressDialog.setCancelButton(nullptr); // 移除取消按钮
-        progressDialog.setWindowModality(Qt::WindowModal);
-        
-        // 强制显示对话框
-        progressDialog.setMinimumDuration(0); // 立即显示，不延迟
-        progressDialog.setValue(0); // 初始化进度
+    if (savePipeline && savePipeline->isRunning()) {
+        return;
+    }
+    if (!sshManager || !configReader) {
+        showSaveStatus("保存失败：系统未初始化，请先点击加载按钮！", false);
+        return;
+    }
+    if (sshManager->isSSHDisconnected() || !sshManager->getSession()) {
+        showSaveStatus("保存失败：SSH连接已断开，请重新加载。", false);
+        return;
+    }
 
-        // 模拟耗时操作（可选）
-        QCoreApplication::processEvents();
+    SavePipeline::Inputs inputs;
+    for (const SaveField& field : saveFields) {
+        inputs.emplace_back(field.param, field.lineEdit->text().toStdString());
+    }
 
-        // 执行保存逻辑
-        int result = main_save();
+    if (!savePipeline) {
+        savePipeline = std::make_unique<SavePipeline>(configReader.get());
+    }
+    const QString ipAddr = QString::fromStdString(host);
+    const QString remotePath = QString::fromStdString(configPath);
+    savePipeline->start(inputs, [ipAddr, remotePath](const std::string& content) {
+        return archiveSavedConfig(ipAddr, remotePath, content);
+    });
+
+    ui->saveButton->setEnabled(false);
+    ui->saveProgressBar->setValue(0);
+    showSaveStatus("正在保存...", true);
+    saveTimer.start(50);
+}
 
-        // 关闭对话框
-        progressDialog.close();
+void Widget::onSaveTick() {
+    if (!savePipeline) {
+        saveTimer.stop();
+        return;
+    }
 
+    const SavePipeline::Progress progress = savePipeline->progress();
+    ui->saveProgressBar->setValue(progress.completedStages);
+    ui->saveProgressBar->setFormat(QString("%1 (%2/%3)")
+                                       .arg(QString::fromStdString(progress.message))
+                                       .arg(progress.completedStages)
+                                       .arg(SavePipeline::kStageCount));
+    if (!progress.finished) {
+        return;
+    }
 
-        if (result == 0) {
-            QTimer::singleShot(500, [this]() {
-                try {
-                    // 读取保存后的配置文件内容
-                    QString fileContent;
-                    if (configReader && sshManager && !sshManager->isSSHDisconnected()) {
-                        std::string readCommand = "cat /home/ubuntu/data/param/rl_control_new.txt";
-                        std::string content = configReader->executeRemoteCommand(readCommand);
-                        fileContent = QString::fromStdString(content);
-                        
-                        if (!fileContent.isEmpty()) {
-                            // 创建自定义对话框显示文件内容
-                            QDialog fileDialog(this);
-                            fileDialog.setWindowTitle("配置文件内容");
-                            fileDialog.setModal(true);
-                            fileDialog.resize(600, 400);
-                            
-                            QVBoxLayout* layout = new QVBoxLayout(&fileDialog);
-                            
-                            // 添加标题标签
-                            QLabel* titleLabel = new QLabel("/home/ubuntu/data/param/rl_control_new.txt 完整内容:", &fileDialog);
-                            titleLabel->setStyleSheet("font-weight: bold; color: #2E86AB;");
-                            layout->addWidget(titleLabel);
-                            
-                            // 添加文本编辑框显示文件内容
-                            QTextEdit* textEdit = new QTextEdit(&fileDialog);
-                            textEdit->setPlainText(fileContent);
-                            textEdit->setReadOnly(true);
-                            textEdit->setStyleSheet("font-family: 'Consolas', 'Courier New', monospace; font-size: 12px; background-color: #f8f9fa;");
-                            layout->addWidget(textEdit);
-                            
-                            // 添加按钮布局
-                            QHBoxLayout* buttonLayout = new QHBoxLayout();
-                            
-                            QPushButton* okButton = new QPushButton("确定", &fileDialog);
-                            okButton->setStyleSheet("background-color: #2E86AB; color: white; padding: 8px 16px; border: none; border-radius: 4px;");
-                            okButton->setFixedWidth(80);
-                            
-                            buttonLayout->addStretch();
-                            buttonLayout->addWidget(okButton);
-                            layout->addLayout(buttonLayout);
-                            
-                            // 连接按钮信号
-                            connect(okButton, &QPushButton::clicked, &fileDialog, &QDialog::accept);
-                            
-                            // 保存配置文件到本地桌面"偏置调节记录"文件夹
-                            try {
-                                // 获取桌面路径
-                                QString desktopPath = QStandardPaths::writableLocation(QStandardPaths::DesktopLocation);
-                                QString recordFolder = desktopPath + "/偏置调节记录";
-                                
-                                // 确保文件夹存在
-                                if (!QDir().mkpath(recordFolder)) {
-                                    qDebug() << "无法创建偏置调节记录文件夹";
-                                    logException("FileSaveError", "无法创建偏置调节记录文件夹", "on_saveButton_clicked");
-                                } else {
-                                    // 构造文件名：时间戳-IP.txt
-                                    QDateTime now = QDateTime::currentDateTime();
-                                    QString timestamp = now.toString("yyyyMMdd_HHmmss");
-                                    QString ipAddr = QString::fromStdString(host);
-                                    QString fileName = QString("%1-%2.txt").arg(timestamp, ipAddr);
-                                    QString filePath = recordFolder + "/" + fileName;
-                                    
-                                    // 写入文件
-                                    QFile recordFile(filePath);
-                                    if (recordFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-                                        QTextStream out(&recordFile);
-                                        #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-                                            out.setEncoding(QStringConverter::Utf8);
-                                        #else
-                                            out.setCodec("UTF-8");
-                                        #endif
-                                        
-                                        // 写入头信息
-                                        out << "========================================" << "\n";
-                                        out << "偏置调节记录" << "\n";
-                                        out << "========================================" << "\n";
-                                        out << "保存时间: " << now.toString("yyyy-MM-dd hh:mm:ss") << "\n";
-                                        out << "IP地址: " << ipAddr << "\n";
-                                        out << "远程文件路径: /home/ubuntu/data/param/rl_control_new.txt" << "\n";
-                                        out << "========================================" << "\n\n";
-                                        
-                                        // 写入配置内容
-                                        out << fileContent;
-                                        
-                                        recordFile.close();
-                                        qDebug() << "配置文件已保存到: " << filePath;
-                                    } else {
-                                        qDebug() << "无法打开文件进行写入: " << filePath;
-                                        logException("FileSaveError", 
-                                                   QString("无法打开文件: %1").arg(filePath),
-                                                   "on_saveButton_clicked");
-                                    }
-                                }
-                            } catch (const std::exception& e) {
-                                qDebug() << "保存配置文件到本地时发生异常:" << e.what();
-                                logException("std::exception",
-                                           QString("保存配置文件到本地时发生异常: %1").arg(e.what()),
-                                           "on_saveButton_clicked");
-                            }
-                            
-                            // 显示对话框
-                            fileDialog.exec();
-                            
-                            // 显示保存成功提示
-                            QMessageBox::information(this, "信息", "保存成功！\n请拍下急停按钮重新启动以使配置生效。\n\n已将配置内容保存在本地桌面「偏置调节记录」文件夹。");
-                        } else {
-                            QMessageBox::information(this, "信息", "保存成功！\n请拍下急停按钮重新启动以使配置生效。\n\n注意：无法读取配置文件内容显示。");
-                        }
-                    } else {
-                        QMessageBox::information(this, "信息", "保存成功！\n请拍下急停按钮重新启动以使配置生效。\n\n注意：连接状态异常，无法读取配置文件内容。");
-                    }
-                } catch (const std::exception& e) {
-                    QMessageBox::information(this, "信息", "保存成功！\n请拍下急停按钮重新启动以使配置生效。\n\n注意：读取配置文件时发生异常：" + QString(e.what()));
-                }
-            });
-        } else if (result == 1) {
-            QTimer::singleShot(500, [this]() {
-                QMessageBox::warning(this, "信息", "保存失败！\n请先加载。");
-            });
-        } else if (result == 2) {
-            QTimer::singleShot(500, [this]() {
-                QMessageBox::warning(this, "信息", "保存失败！\nSSH连接已断开，请重新加载。");
-            });
+    saveTimer.stop();
+    savePipeline->wait();
+    ui->saveButton->setEnabled(true);
+
+    const SavePipeline::Result result = savePipeline->result();
+    if (!result.ok) {
+        QString message = QString("保存失败（%1）：%2")
+                              .arg(SavePipeline::stageName(result.failedStage))
+                              .arg(QString::fromStdString(result.error));
+        if (sshManager && sshManager->isSSHDisconnected()) {
+            message += " SSH连接已断开，请重新加载。";
         }
- 
+        logException("ConfigError", message, "on_saveButton_clicked");
+        showSaveStatus(message, false);
         return;
-    }catch (const std::exception& e) {
-        QMessageBox::warning(this, "错误", QString("保存过程中出现异常:\n %1").arg(e.what()));
     }
+
+    // 校验阶段解析出的数值即为已写入的值
+    for (const auto& value : result.values) {
+        for (const SaveField& field : saveFields) {
+            if (field.param == value.first) {
+                *field.member = value.second;
+            }
+        }
+    }
+
+    double totalMs = 0.0;
+    for (double ms : result.stageMs) {
+        totalMs += ms;
+    }
+    // 已通知控制器热更新时不需要急停重启
+    QString message = QString("保存成功：%1 处改动，%2 ms。%3")
+                          .arg(result.changes.size())
+                          .arg(totalMs, 0, 'f', 0)
+                          .arg(result.liveUpdated ? "配置已实时推送到控制器，无需重启即可生效。"
+                                                  : "请拍下急停按钮重新启动以使配置生效。");
+    if (!result.archivePath.empty()) {
+        message += "\n已存档到桌面「偏置调节记录」：" + QFileInfo(QString::fromStdString(result.archivePath)).fileName();
+    } else if (!result.archiveError.empty()) {
+        message += "\n本地存档失败：" + QString::fromStdString(result.archiveError);
+        logException("FileSaveError", QString::fromStdString(result.archiveError), "on_saveButton_clicked");
+    }
+    showSaveStatus(message, true);
+    ui->saveStatusLabel->setToolTip(QString::fromStdString(result.content));
+}
+
+void Widget::showSaveStatus(const QString& message, bool ok) {
+    ui->saveStatusLabel->setStyleSheet(ok ? "" : "color: #C0392B;");
+    ui->saveStatusLabel->setText(message);
+    ui->saveStatusLabel->setToolTip(QString());
+}
+
+bool Widget::backgroundWorkInProgress() {
+    if (savePipeline && savePipeline->isRunning()) {
+        showSaveStatus("正在保存，请等待保存完成后再操作。", true);
+        return true;
+    }
+    if (estimateWorker.joinable()) {
+        showSaveStatus("正在进行偏置估计，请等待完成或取消后再操作。", true);
+        return true;
+    }
+    return false;
+}
+
+std::string Widget::sshPasswordFromEnv() {
+    const char* env = std::getenv("ADJUSTBIAS_SSH_PASSWORD");
+    return env ? std::string(env) : std::string();
+}
+
+// 在工作线程中调用：保存到本地桌面“偏置调节记录”文件夹（时间戳-IP.txt），返回文件路径
+std::string Widget::archiveSavedConfig(const QString& ipAddr, const QString& remotePath, const std::string& content) {
+    const QString desktopPath = QStandardPaths::writableLocation(QStandardPaths::DesktopLocation);
+    const QString recordFolder = desktopPath + "/偏置调节记录";
+    if (!QDir().mkpath(recordFolder)) {
+        throw std::runtime_error("无法创建偏置调节记录文件夹");
+    }
+
+    const QDateTime now = QDateTime::currentDateTime();
+    const QString filePath = recordFolder + "/" + QString("%1-%2.txt").arg(now.toString("yyyyMMdd_HHmmss"), ipAddr);
+    QFile recordFile(filePath);
+    if (!recordFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        throw std::runtime_error(QString("无法打开文件: %1").arg(filePath).toStdString());
+    }
+
+    QTextStream out(&recordFile);
+    #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        out.setEncoding(QStringConverter::Utf8);
+    #else
+        out.setCodec("UTF-8");
+    #endif
+    out << "========================================" << "\n";
+    out << "偏置调节记录" << "\n";
+    out << "========================================" << "\n";
+    out << "保存时间: " << now.toString("yyyy-MM-dd hh:mm:ss") << "\n";
+    out << "IP地址: " << ipAddr << "\n";
+    out << "远程文件路径: " << remotePath << "\n";
+    out << "========================================" << "\n\n";
+    out << QString::fromStdString(content);
+    recordFile.close();
+    qDebug() << "配置文件已保存到: " << filePath;
+    return filePath.toStdString();
 }
 
 
@@ -248,6 +281,9 @@ void Widget::on_saveButton_clicked() {
 
 void Widget::on_loadButton_clicked()
 {
+    if (backgroundWorkInProgress()) {
+        return;
+    }
     try{
 
 
@@ -264,6 +300,7 @@ void Widget::on_loadButton_clicked()
         // 使用新的断连检测函数替代原来的 session 标志判断
         if (sshManager && configReader && !sshManager->isSSHDisconnected() && sshManager->getHost() == string(host)) {
             QMessageBox::information(this, "SSH有效，无需重连！", QString("当前IP: %1\n参数信息已重新加载！").arg(sshManager->getHost()));
+            setLink(Link::Connected);
             loadConfigToUI();
             return;
         }
@@ -287,6 +324,7 @@ void Widget::on_loadButton_clicked()
             QApplication::processEvents();
             int result = main_load();
             loadingBox.close();
+            setLink(result == 0 ? Link::Connected : Link::None);
             if(result == 0) {
                 QMessageBox::information(this, "信息已加载！", QString("连接到IP: %1").arg(host));
             }
@@ -317,8 +355,21 @@ int Widget::main_load() {
          << "Port:" << port << "User:" << QString::fromStdString(username);
 
     try {
-        sshManager = std::make_unique<SSHManager>(host, username, password, port);
+        // 旧会话即将被替换，实时调节通道随之关闭
+        ui->streamCheckBox->setChecked(false);
+        stopStreaming("");
+        stopTelemetry();
+        savePipeline.reset();
+
+        // 先尝试 ssh-agent / 私钥（ADJUSTBIAS_SSH_KEY 或 ~/.ssh/id_ed25519 等），均失败且设置了 ADJUSTBIAS_SSH_PASSWORD 时再用密码
+        sshManager = std::make_unique<SSHManager>(host, username, SSHAuthOptions::preferKeys(password), port);
+        qDebug() << "SSH认证方式:" << QString::fromStdString(sshManager->getAuthMethod());
+        // 常驻远端代理（可选）：设置环境变量 ADJUSTBIAS_REMOTE_AGENT=1 后每条命令只需一次帧往返
+        const char* agentEnv = std::getenv("ADJUSTBIAS_REMOTE_AGENT");
+        sshManager->enableRemoteAgent(agentEnv && std::string(agentEnv) == "1");
         configReader = std::make_unique<ConfigReader>(sshManager.get(), configPath);        
+        // 热更新（可选）：ADJUSTBIAS_CONFIG_NOTIFY=signal:<pid文件> / fifo:<路径> / udp:<端口>，加 ",ack=<文件>"
+        configReader->setNotifier(IConfigNotifier::fromEnvironment());
         if (configReader->loadConfig()) {
             // 设置编辑框的值
             loadConfigToUI();
@@ -352,127 +403,6 @@ int Widget::main_load() {
 
 
 
-int Widget::main_save(){
-    // 检查资源是否初始化
-    if (sshManager == nullptr || configReader == nullptr) {
-        qDebug() << "错误: SSHManager 或 ConfigReader 未初始化";
-        return 1; // SSHManager 或 ConfigReader 未初始化
-    }
-    
-    // 检查SSH连接状态
-    if(sshManager->isSSHDisconnected()) {
-        qDebug() << "错误: SSH连接已断开";
-        return 2; // SSH 连接无效
-    }
-    
-    // 额外检查：确保SSH会话仍然有效
-    if (!sshManager->getSession()) {
-        qDebug() << "错误: 无法获取有效的SSH会话";
-        return 2; // SSH 连接无效
-    }
-
-    try {
-        // 获取当前 UI 上的值并更新到成员变量，添加异常处理
-        bool ok;
-        double rollValue = ui->roll_lineEdit->text().toDouble(&ok);
-        if (ok && q_xsense_data_roll != rollValue) 
-            q_xsense_data_roll = rollValue;
-            
-        double pitchValue = ui->pitch_lineEdit->text().toDouble(&ok);
-        if (ok && q_xsense_data_pitch != pitchValue) 
-            q_xsense_data_pitch = pitchValue;
-            
-        double xValue = ui->x_lineEdit->text().toDouble(&ok);
-        if (ok && q_x_vel_offset != xValue) 
-            q_x_vel_offset = xValue;
-            
-        double yValue = ui->y_lineEdit->text().toDouble(&ok);
-        if (ok && q_y_vel_offset != yValue) 
-            q_y_vel_offset = yValue;
-            
-        double yawValue = ui->yaw_lineEdit->text().toDouble(&ok);
-        if (ok && q_yaw_vel_offset != yawValue) 
-            q_yaw_vel_offset = yawValue;
-            
-        double xRunValue = ui->x_run_lineEdit->text().toDouble(&ok);
-        if (ok && q_x_vel_offset_run != xRunValue) 
-            q_x_vel_offset_run = xRunValue;
-            
-        double yRunValue = ui->y_run_lineEdit->text().toDouble(&ok);
-        if (ok && q_y_vel_offset_run != yRunValue) 
-            q_y_vel_offset_run = yRunValue;
-            
-        double yawRunValue = ui->yaw_run_lineEdit->text().toDouble(&ok);
-        if (ok && q_yaw_vel_offset_run != yawRunValue) 
-            q_yaw_vel_offset_run = yawRunValue;
-            
-        // 处理限速值：如果输入不是数字，则不写入
-        // ===== Optimization #6: 识别"未设置"文本并按NaN处理 =====
-        if(ui->limit_walk_lineEdit->text() == QString("nan") || 
-           ui->limit_walk_lineEdit->text() == QString("未设置")) {
-            // 如果UI中限速值为nan或"未设置"，设置成员变量为NaN，触发删除逻辑
-            q_x_vel_limit_walk = std::numeric_limits<double>::quiet_NaN();
-            qDebug() << "检测到x_vel_limit_walk为nan或未设置，将触发删除逻辑";
-        } else {
-            double limitWalkValue = ui->limit_walk_lineEdit->text().toDouble(&ok);
-            if (ok) {
-                if (q_x_vel_limit_walk != limitWalkValue) 
-                    q_x_vel_limit_walk = limitWalkValue;
-            } else {
-                // 如果输入不是有效数字，显示警告但不更新成员变量
-                qDebug() << "警告: x_vel_limit_walk输入不是有效数字，将跳过写入";
-                QMessageBox::warning(nullptr, "输入错误", "行走速度限制值不是有效数字，将跳过保存！");
-            }
-        }
-        
-        if(ui->limit_run_lineEdit->text() == QString("nan") || 
-           ui->limit_run_lineEdit->text() == QString("未设置")) {
-            // 如果UI中限速值为nan或"未设置"，设置成员变量为NaN，触发删除逻辑
-            q_x_vel_limit_run = std::numeric_limits<double>::quiet_NaN();
-            qDebug() << "检测到x_vel_limit_run为nan或未设置，将触发删除逻辑";
-        } else {
-            double limitRunValue = ui->limit_run_lineEdit->text().toDouble(&ok);
-            if (ok) {
-                if (q_x_vel_limit_run != limitRunValue) 
-                    q_x_vel_limit_run = limitRunValue;
-            } else {
-                // 如果输入不是有效数字，显示警告但不更新成员变量
-                qDebug() << "警告: x_vel_limit_run输入不是有效数字，将跳过写入";
-                QMessageBox::warning(nullptr, "输入错误", "跑步速度限制值不是有效数字，将跳过保存！");
-            }
-        }
-    } catch (const std::exception& e) {
-        QString msg = QString("解析UI数值时发生异常: %1").arg(e.what());
-        logException("std::exception", msg, "main_save");
-        qDebug() << "解析UI数值时发生异常:" << e.what();
-        return 3; // 数值解析错误
-    }
-
-    // 使用批量更新方法一次性写入所有参数到配置文件
-    bool success = configReader->updateMultipleParameters(
-        q_xsense_data_roll,
-        q_xsense_data_pitch,
-        q_x_vel_offset,
-        q_y_vel_offset,
-        q_yaw_vel_offset,
-        q_x_vel_offset_run,
-        q_y_vel_offset_run,
-        q_yaw_vel_offset_run,
-        q_x_vel_limit_walk,
-        q_x_vel_limit_run
-    );
-
-    if (!success) {
-        QString msg = "批量更新参数到配置文件失败";
-        logException("ConfigError", msg, "main_save");
-        qDebug() << msg;
-        return 4; // 配置文件写入失败
-    }
-
-    return 0;
-
-    
-}
 
 
 
@@ -518,6 +448,42 @@ void Widget::loadConfigToUI() {
 
 
 
+// ===== 多机器人工作区 =====
+
+QString Widget::sessionTitle() const {
+    switch (link) {
+    case Link::Connected: return QString::fromStdString(host);
+    case Link::Lost: return QString::fromStdString(host) + "（已断开）";
+    default: return "未连接";
+    }
+}
+
+bool Widget::isBusy() const {
+    return savePipeline && savePipeline->isRunning();
+}
+
+// 保活与断线检测在 SessionReactor 中进行，这里只读取标志，不做网络操作
+void Widget::pollLink() {
+    if (link == Link::None || !sshManager) {
+        return;
+    }
+    const bool lost = sshManager->isLinkLost();
+    if (link == Link::Connected && lost) {
+        ui->streamStatusLabel->setText("SSH连接已断开，请重新加载。");
+        setLink(Link::Lost);
+    } else if (link == Link::Lost && !lost && sshManager->isSessionValid()) {
+        // 开启了自动重连（ADJUSTBIAS_AUTO_RECONNECT）时由事件循环的工作线程恢复
+        ui->streamStatusLabel->setText("SSH连接已自动恢复。");
+        setLink(Link::Connected);
+    }
+}
+
+// 同一标签页换了 IP 时状态不变但标题要更新，因此总是通知
+void Widget::setLink(Link state) {
+    link = state;
+    emit sessionStateChanged();
+}
+
 // 通用的按钮点击处理函数模板
 void Widget::adjustParameter(QLineEdit* lineEdit, double& memberVar, double delta, int precision) {
     try {
@@ -533,6 +499,13 @@ void Widget::adjustParameter(QLineEdit* lineEdit, double& memberVar, double delt
         memberVar = currentValue;
         // 更新回控件
         lineEdit->setText(QString::number(currentValue, 'f', precision));
+        // 实时调节：只记录最新值，由定时器合并发送
+        if (streamer && streamer->isRunning()) {
+            auto it = streamParamNames.find(&memberVar);
+            if (it != streamParamNames.end()) {
+                streamer->push(it->second, currentValue);
+            }
+        }
     } catch (const std::exception& e) {
         QString msg = QString("操作失败: %1").arg(e.what());
         logException("std::exception", msg, "adjustParameter");
@@ -540,6 +513,344 @@ void Widget::adjustParameter(QLineEdit* lineEdit, double& memberVar, double delt
     }
 }
 
+// ===== 实时调节 =====
+// 通过 direct-tcpip 通道把 +/- 调整实时推送到机器人控制端口（ADJUSTBIAS_STREAM_PORT，默认 9877）。
+// 定时器在 GUI 线程中驱动 tick()。保存、遥测在其他线程上使用同一会话，tick() 只在会话锁空闲时发送，
+// 会话忙（例如保存正在写入或等待控制器确认）时跳过本轮，界面不会被阻塞。
+void Widget::on_streamCheckBox_toggled(bool checked) {
+    if (!checked) {
+        stopStreaming("实时调节已关闭");
+        return;
+    }
+    if (!sshManager || sshManager->isSSHDisconnected()) {
+        QMessageBox::warning(this, "错误", "请先加载配置文件再开启实时调节！");
+        ui->streamCheckBox->setChecked(false);
+        return;
+    }
+
+    try {
+        ParameterStreamer::Options options;
+        if (const char* portEnv = std::getenv("ADJUSTBIAS_STREAM_PORT")) {
+            options.remotePort = std::atoi(portEnv);
+        }
+        streamer = std::make_unique<ParameterStreamer>(sshManager.get());
+        streamer->start(options);
+        streamTicks = 0;
+        streamTimer.start(streamer->intervalMs());
+        ui->streamStatusLabel->setText(QString("实时调节已开启（端口 %1，%2Hz）").arg(options.remotePort).arg(options.rateHz));
+    } catch (const std::exception& e) {
+        streamer.reset();
+        ui->streamCheckBox->setChecked(false);
+        logException("ApplicationException", QString("开启实时调节失败: %1").arg(e.what()), "on_streamCheckBox_toggled");
+        QMessageBox::warning(this, "错误", QString("开启实时调节失败:\n%1").arg(e.what()));
+    }
+}
+
+void Widget::onStreamTick() {
+    if (!streamer || !streamer->tick()) {
+        stopStreaming("实时调节通道已断开");
+        ui->streamCheckBox->setChecked(false);
+        return;
+    }
+
+    // 每 0.5 秒刷新一次延迟统计
+    if (++streamTicks % 25 == 0) {
+        ParameterStreamer::Stats stats = streamer->stats();
+        ui->streamStatusLabel->setText(
+            QString("实时: 按键 %1 次 / 发送 %2 条 / 确认 %3 条  延迟 %4 ms（平均 %5，最大 %6）")
+                .arg(stats.updates).arg(stats.messagesSent).arg(stats.acked)
+                .arg(stats.lastLatencyMs, 0, 'f', 1)
+                .arg(stats.meanLatencyMs, 0, 'f', 1)
+                .arg(stats.maxLatencyMs, 0, 'f', 1));
+    }
+}
+
+void Widget::stopStreaming(const QString& reason) {
+    streamTimer.stop();
+    if (streamer) {
+        streamer.reset();
+        ui->streamStatusLabel->setText(reason);
+    }
+}
+
+// ===== 遥测曲线 =====
+// 数据源由 ADJUSTBIAS_TELEMETRY 指定（tail:<远端文件> 或 tcp:<端口>[:<主机>]），
+// 读取与解析在 TelemetryStream 的线程中进行，界面只按帧从环形缓冲区取数据绘制。
+void Widget::on_telemetryButton_clicked() {
+    if (telemetryPlot && telemetryStream && telemetryStream->isRunning()) {
+        telemetryPlot->show();
+        telemetryPlot->raise();
+        telemetryPlot->activateWindow();
+        return;
+    }
+    if (!sshManager || sshManager->isSSHDisconnected()) {
+        QMessageBox::warning(this, "错误", "请先加载配置文件再打开遥测！");
+        return;
+    }
+
+    TelemetryStream::Source source;
+    if (!TelemetryStream::Source::fromEnvironment(source)) {
+        QMessageBox::information(this, "遥测",
+            "未配置遥测数据源。请设置环境变量 ADJUSTBIAS_TELEMETRY，例如：\n"
+            "  tail:/home/ubuntu/data/log/imu.csv   跟随远端 CSV 日志\n"
+            "  tcp:9878                              读取机器人本机 9878 端口（经 SSH 转发）\n\n"
+            "数据格式：t,roll,pitch,vx,vy,wz（可带表头）");
+        return;
+    }
+
+    try {
+        stopTelemetry();
+        telemetryStream = std::make_unique<TelemetryStream>(sshManager.get());
+        telemetryStream->start(source);
+
+        telemetryPlot = std::make_unique<TelemetryPlotWidget>();
+        telemetryPlot->setWindowTitle(QString("遥测曲线 - %1 (%2)")
+                                          .arg(QString::fromStdString(host))
+                                          .arg(QString::fromStdString(source.describe())));
+        telemetryPlot->attach(telemetryStream.get());
+        // 关闭窗口即停止读取；延迟到事件循环中释放，避免在窗口自身的事件处理中析构
+        connect(telemetryPlot.get(), &TelemetryPlotWidget::closed, this, [this]() {
+            QTimer::singleShot(0, this, [this]() { stopTelemetry(); });
+        });
+        telemetryPlot->show();
+    } catch (const std::exception& e) {
+        stopTelemetry();
+        logException("ApplicationException", QString("打开遥测失败: %1").arg(e.what()), "on_telemetryButton_clicked");
+        QMessageBox::warning(this, "错误", QString("打开遥测失败:\n%1").arg(e.what()));
+    }
+}
+
+void Widget::stopTelemetry() {
+    if (telemetryPlot) {
+        telemetryPlot->attach(nullptr);
+    }
+    telemetryStream.reset();
+    if (telemetryPlot) {
+        telemetryPlot->hide();
+        telemetryPlot.reset();
+    }
+}
+
+// ===== 偏置估计 =====
+// 从机器人下载漂移日志（ADJUSTBIAS_DRIFT_LOG，可在对话框中修改），对各轴走 / 跑步态分别做最小二乘估计，
+// 建议值经人工审阅勾选后写入输入框，再走与“保存”按钮相同的流程。
+void Widget::on_estimateButton_clicked() {
+    if (estimateWorker.joinable()) {
+        return;
+    }
+    if (!sshManager || !configReader || sshManager->isSSHDisconnected()) {
+        QMessageBox::warning(this, "错误", "请先加载配置文件再估计偏置！");
+        return;
+    }
+
+    const char* logEnv = std::getenv("ADJUSTBIAS_DRIFT_LOG");
+    bool ok = false;
+    const QString remotePath = QInputDialog::getText(
+        this, "偏置估计", "机器人上的漂移日志（CSV，需包含 vx,vy,wz 列）:", QLineEdit::Normal,
+        (logEnv && *logEnv) ? QString::fromUtf8(logEnv) : QString("/home/ubuntu/data/log/drift.csv"), &ok).trimmed();
+    if (!ok || remotePath.isEmpty()) {
+        return;
+    }
+
+    // 当前输入框中的值在 GUI 线程取出，工作线程只用副本
+    const std::map<std::string, double> current = {
+        {"x_vel_offset", ui->x_lineEdit->text().toDouble()},
+        {"y_vel_offset", ui->y_lineEdit->text().toDouble()},
+        {"yaw_vel_offset", ui->yaw_lineEdit->text().toDouble()},
+        {"x_vel_offset_run", ui->x_run_lineEdit->text().toDouble()},
+        {"y_vel_offset_run", ui->y_run_lineEdit->text().toDouble()},
+        {"yaw_vel_offset_run", ui->yaw_run_lineEdit->text().toDouble()},
+    };
+    const std::string localPath = (QStandardPaths::writableLocation(QStandardPaths::TempLocation) +
+                                   QString("/adjustBias_drift_%1.csv").arg(QString::fromStdString(host))).toStdString();
+
+    auto job = std::make_shared<EstimateJob>();
+    job->remotePath = remotePath;
+    estimateJob = job;
+
+    estimateDialog.reset(new QProgressDialog("正在下载漂移日志...", "取消", 0, 0, this));
+    estimateDialog->setWindowTitle("偏置估计");
+    estimateDialog->setWindowModality(Qt::WindowModal);
+    estimateDialog->setMinimumDuration(0);
+    estimateDialog->setAutoReset(false);
+    estimateDialog->setAutoClose(false);
+    connect(estimateDialog.get(), &QProgressDialog::canceled, this, [this]() { cancelEstimate(); });
+    estimateDialog->setValue(0);
+
+    // FileHandler 的每个 SFTP 调用各自持有会话锁，下载期间遥测 / 实时调参仍可穿插使用同一会话
+    SSHManager* manager = sshManager.get();
+    const std::string remote = remotePath.toStdString();
+    estimateWorker = std::thread([job, manager, remote, localPath, current]() {
+        try {
+            FileHandler fileHandler(manager);
+            FileHandler::DownloadOptions options;
+            options.progress = [job](uint64_t got, uint64_t total) {
+                job->received = got;
+                job->total = total;
+                return !job->cancel.load();
+            };
+            fileHandler.downloadFile(remote, localPath, options);
+            job->analyzing = true;
+
+            // 转换为列式分析文件后再取通道，重复估计同一份日志时直接映射缓存
+            DriftLog log = DriftLog::fromStore(DriftLogStore::openOrConvert(localPath));
+            if (job->cancel) {
+                throw OperationCancelledException("偏置估计已取消");
+            }
+            job->result = BiasEstimator::estimate(log, current);
+            job->malformedLines = log.malformedLines;
+        } catch (const OperationCancelledException&) {
+            job->cancel = true;
+        } catch (const std::exception& e) {
+            job->error = e.what();
+            if (job->error.empty()) {
+                job->error = "未知错误";
+            }
+        }
+        job->finished = true;
+    });
+    estimateTimer.start(100);
+}
+
+void Widget::cancelEstimate() {
+    if (estimateJob) {
+        estimateJob->cancel = true;
+    }
+    if (estimateDialog) {
+        estimateDialog->setLabelText("正在取消...");
+    }
+}
+
+void Widget::onEstimateTick() {
+    std::shared_ptr<EstimateJob> job = estimateJob;
+    if (!job) {
+        estimateTimer.stop();
+        return;
+    }
+
+    if (!job->finished) {
+        if (estimateDialog && !job->cancel) {
+            const uint64_t total = job->total;
+            if (job->analyzing) {
+                estimateDialog->setLabelText("正在分析漂移日志...");
+                estimateDialog->setRange(0, 0);
+            } else if (total > 0) {
+                estimateDialog->setLabelText(QString("正在下载漂移日志... %1 / %2 KB")
+                                                 .arg(job->received.load() / 1024)
+                                                 .arg(total / 1024));
+                estimateDialog->setRange(0, 100);
+                estimateDialog->setValue(static_cast<int>(job->received * 100 / total));
+            }
+        }
+        return;
+    }
+
+    estimateTimer.stop();
+    if (estimateWorker.joinable()) {
+        estimateWorker.join();
+    }
+    estimateJob.reset();
+    estimateDialog.reset();  // 直接销毁而非 close()，close 会发出 canceled
+
+    if (job->cancel) {
+        qDebug() << "偏置估计已取消";
+        return;
+    }
+    if (!job->error.empty()) {
+        const QString message = QString::fromStdString(job->error);
+        logException("ApplicationException", QString("偏置估计失败: %1").arg(message), "on_estimateButton_clicked");
+        QMessageBox::warning(this, "错误", QString("偏置估计失败:\n%1").arg(message));
+        return;
+    }
+
+    qDebug() << "偏置估计: 样本" << job->result.samples << "求解" << job->result.solveMs << "ms";
+    if (reviewBiasEstimates(job->result, job->remotePath, job->malformedLines)) {
+        on_saveButton_clicked();
+    }
+}
+
+bool Widget::reviewBiasEstimates(const BiasEstimator::Result& result, const QString& source, size_t malformedLines) {
+    const std::map<std::string, std::pair<QLineEdit*, int>> targets = {
+        {"x_vel_offset", {ui->x_lineEdit, 3}},
+        {"y_vel_offset", {ui->y_lineEdit, 3}},
+        {"yaw_vel_offset", {ui->yaw_lineEdit, 4}},
+        {"x_vel_offset_run", {ui->x_run_lineEdit, 3}},
+        {"y_vel_offset_run", {ui->y_run_lineEdit, 3}},
+        {"yaw_vel_offset_run", {ui->yaw_run_lineEdit, 4}},
+    };
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("偏置估计结果");
+    dialog.setModal(true);
+    dialog.resize(720, 360);
+    QVBoxLayout* layout = new QVBoxLayout(&dialog);
+
+    QLabel* titleLabel = new QLabel(
+        QString("%1\n样本 %2 条（无效行 %3），求解 %4 ms。建议值 = 当前值 - 漂移；默认只勾选漂移显著（超出置信区间）的参数。")
+            .arg(source).arg(result.samples).arg(malformedLines).arg(result.solveMs, 0, 'f', 1),
+        &dialog);
+    titleLabel->setWordWrap(true);
+    titleLabel->setStyleSheet("font-weight: bold; color: #2E86AB;");
+    layout->addWidget(titleLabel);
+
+    QTableWidget* table = new QTableWidget(static_cast<int>(result.estimates.size()), 6, &dialog);
+    table->setHorizontalHeaderLabels({"参数", "当前值", "漂移", "建议值", "±95%", "样本数"});
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    table->verticalHeader()->setVisible(false);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    for (int row = 0; row < static_cast<int>(result.estimates.size()); ++row) {
+        const BiasEstimator::Estimate& est = result.estimates[row];
+        const int precision = targets.at(est.param).second + 2;
+
+        QTableWidgetItem* nameItem = new QTableWidgetItem(QString::fromStdString(est.param));
+        if (est.valid) {
+            nameItem->setFlags(nameItem->flags() | Qt::ItemIsUserCheckable);
+            nameItem->setCheckState(std::fabs(est.drift) > est.ci95 ? Qt::Checked : Qt::Unchecked);
+        } else {
+            nameItem->setFlags(nameItem->flags() & ~Qt::ItemIsEnabled);
+            nameItem->setToolTip(QString::fromStdString(est.note));
+        }
+        table->setItem(row, 0, nameItem);
+        table->setItem(row, 1, new QTableWidgetItem(QString::number(est.current, 'f', precision)));
+        table->setItem(row, 2, new QTableWidgetItem(est.valid ? QString::number(est.drift, 'f', precision) : QString::fromStdString(est.note)));
+        table->setItem(row, 3, new QTableWidgetItem(est.valid ? QString::number(est.proposed, 'f', precision) : "-"));
+        table->setItem(row, 4, new QTableWidgetItem(est.valid ? QString::number(est.ci95, 'f', precision) : "-"));
+        table->setItem(row, 5, new QTableWidgetItem(QString::number(est.samples)));
+    }
+    layout->addWidget(table);
+
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    QPushButton* applyButton = new QPushButton("应用并保存", &dialog);
+    applyButton->setStyleSheet("background-color: #2E86AB; color: white; padding: 8px 16px; border: none; border-radius: 4px;");
+    QPushButton* cancelButton = new QPushButton("取消", &dialog);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(cancelButton);
+    buttonLayout->addWidget(applyButton);
+    layout->addLayout(buttonLayout);
+    connect(applyButton, &QPushButton::clicked, &dialog, &QDialog::accept);
+    connect(cancelButton, &QPushButton::clicked, &dialog, &QDialog::reject);
+
+    if (dialog.exec() != QDialog::Accepted) {
+        return false;
+    }
+
+    int applied = 0;
+    for (int row = 0; row < static_cast<int>(result.estimates.size()); ++row) {
+        const BiasEstimator::Estimate& est = result.estimates[row];
+        if (!est.valid || table->item(row, 0)->checkState() != Qt::Checked) {
+            continue;
+        }
+        const auto& target = targets.at(est.param);
+        target.first->setText(QString::number(est.proposed, 'f', target.second));
+        ++applied;
+    }
+    if (applied == 0) {
+        QMessageBox::information(this, "偏置估计", "没有勾选任何参数，配置未修改。");
+        return false;
+    }
+    return true;
+}
+
 void Widget::on_roll_plus_pushButton_clicked() {
     adjustParameter(ui->roll_lineEdit, q_xsense_data_roll, 0.001, 3);
 }
@@ -605,6 +916,9 @@ void Widget::on_yaw_run_minus_pushButton_clicked() {
 }
 
 void Widget::on_disconnectButton_clicked() {
+    if (backgroundWorkInProgress()) {
+        return;
+    }
     try {
         // 快速检查是否有SSH连接需要断开
         if (!sshManager) {
@@ -625,8 +939,13 @@ void Widget::on_disconnectButton_clicked() {
         // 模拟耗时操作（可选）
         QCoreApplication::processEvents();
         
+        // 实时调节通道与遥测读取属于当前会话，先关闭
+        ui->streamCheckBox->setChecked(false);
+        stopTelemetry();
+
         // 执行断开连接逻辑
         sshManager->invalidateSession();
+        setLink(Link::None);
         
         // 快速清除UI界面上所有lineEdit的内容
         ui->roll_lineEdit->clear();
@@ -0,0 +1,72 @@
+// ===== FleetDrift 标准模板测试 =====
+// 用法: adjustBias_tests <tests/data 目录>；全部通过时退出码为 0
+#include "FleetDrift.h"
+#include "Sha256.h"
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAIL: " << what << std::endl;
+        ++failures;
+    }
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+// Windows 上编辑的 CRLF 模板：摘要与解析结果必须与同内容的 LF 文件一致
+void testCrlfGolden(const std::string& dataDir) {
+    const std::string path = dataDir + "/rl_control_golden_crlf.txt";
+    const std::string raw = readFile(path);
+    check(raw.find("\r\n") != std::string::npos, "golden file is checked out with CRLF line endings");
+
+    std::string lf;
+    for (char c : raw) {
+        if (c != '\r') {
+            lf += c;
+        }
+    }
+
+    const FleetDrift::Golden crlf = FleetDrift::Golden::loadFile(path);
+    const FleetDrift::Golden lfGolden = FleetDrift::Golden::fromContent(lf);
+
+    // 远端 sha256sum 计算的是机器人上的 LF 文件
+    check(crlf.sha256 == Sha256::hashString(lf), "CRLF golden sha256 equals the LF file sha256");
+    check(crlf.sha256 == lfGolden.sha256, "CRLF and LF golden sha256 match");
+    check(crlf.values.size() == 6, "CRLF golden parses all 6 parameters");
+    check(crlf.values == lfGolden.values, "CRLF and LF golden values match");
+    for (const auto& kv : crlf.values) {
+        check(kv.first.find('\r') == std::string::npos, "parameter name without \\r: " + kv.first);
+    }
+    const auto offset = crlf.values.find("y_vel_offset");
+    check(offset != crlf.values.end() && std::fabs(offset->second + 0.02) < 1e-12, "y_vel_offset == -0.02");
+    check(FleetDrift::diff(crlf.values, lfGolden.values).empty(), "no diff between CRLF and LF golden");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string dataDir = argc > 1 ? argv[1] : "tests/data";
+    try {
+        testCrlfGolden(dataDir);
+    } catch (const std::exception& e) {
+        std::cerr << "FAIL: " << e.what() << std::endl;
+        ++failures;
+    }
+    if (failures == 0) {
+        std::cout << "all tests passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,386 @@
+#include "NetworkProxy.h"
+#include <algorithm>
+#include <random>
+
+namespace {
+
+void setNoDelay(SOCKET s) {
+    // 关闭 Nagle，避免代理自身引入额外的合并延迟而污染测量结果
+    int flag = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&flag), sizeof(flag));
+}
+
+// 每个转发线程独立的随机数发生器，避免共享锁
+std::mt19937& rng() {
+    thread_local std::mt19937 engine{std::random_device{}()};
+    return engine;
+}
+
+bool rollPercent(double percent) {
+    if (percent <= 0.0) {
+        return false;
+    }
+    std::uniform_real_distribution<double> dist(0.0, 100.0);
+    return dist(rng()) < percent;
+}
+
+} // namespace
+
+NetworkProxy::NetworkProxy(const std::string& upstreamHost, int upstreamPort, const Profile& profile)
+    : upstreamHost(upstreamHost), upstreamPort(upstreamPort), profile(profile) {}
+
+NetworkProxy::~NetworkProxy() {
+    try {
+        stop();
+    } catch (...) {
+        // 析构函数不应抛出异常
+    }
+}
+
+void NetworkProxy::start(int port, const std::string& bindAddress) {
+    if (running.load()) {
+        return;
+    }
+
+    WSADATA wsadata;
+    if (WSAStartup(MAKEWORD(2, 2), &wsadata)) {
+        throw NetworkException("WSAStartup failed: " + std::to_string(WSAGetLastError()));
+    }
+
+    listenSock = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenSock == INVALID_SOCKET) {
+        WSACleanup();
+        throw NetworkException("Proxy socket creation failed: " + std::to_string(WSAGetLastError()));
+    }
+
+    int reuse = 1;
+    setsockopt(listenSock, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in sin{};
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(static_cast<u_short>(port));
+    if (inet_pton(AF_INET, bindAddress.c_str(), &sin.sin_addr) != 1) {
+        closesocket(listenSock);
+        listenSock = INVALID_SOCKET;
+        WSACleanup();
+        throw NetworkException("Invalid proxy bind address: " + bindAddress);
+    }
+
+    if (bind(listenSock, reinterpret_cast<sockaddr*>(&sin), sizeof(sin)) || listen(listenSock, 64)) {
+        std::string errorMsg = "Proxy bind/listen failed: " + std::to_string(WSAGetLastError());
+        closesocket(listenSock);
+        listenSock = INVALID_SOCKET;
+        WSACleanup();
+        throw NetworkException(errorMsg);
+    }
+
+    socklen_t len = sizeof(sin);
+    getsockname(listenSock, reinterpret_cast<sockaddr*>(&sin), &len);
+    listenPort = ntohs(sin.sin_port);
+
+    running.store(true);
+    acceptThread = std::thread(&NetworkProxy::acceptLoop, this);
+}
+
+void NetworkProxy::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    if (acceptThread.joinable()) {
+        acceptThread.join();
+    }
+    closesocket(listenSock);
+    listenSock = INVALID_SOCKET;
+
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    for (auto& conn : connections) {
+        // 先 shutdown 唤醒阻塞在 recv/send 上的线程，再 join，最后关闭句柄
+        shutdown(conn->client, SD_BOTH);
+        shutdown(conn->upstream, SD_BOTH);
+        closePipe(&conn->toUpstream);
+        closePipe(&conn->toClient);
+        for (auto& t : conn->threads) {
+            if (t.joinable()) {
+                t.join();
+            }
+        }
+        closesocket(conn->client);
+        closesocket(conn->upstream);
+    }
+    connections.clear();
+
+    WSACleanup();
+}
+
+void NetworkProxy::setProfile(const Profile& newProfile) {
+    std::lock_guard<std::mutex> lock(profileMutex);
+    profile = newProfile;
+}
+
+NetworkProxy::Profile NetworkProxy::getProfile() const {
+    std::lock_guard<std::mutex> lock(profileMutex);
+    return profile;
+}
+
+bool NetworkProxy::namedProfile(const std::string& name, Profile& out) {
+    Profile p;
+    if (name == "lan") {
+        p.rttMs = 1;
+    } else if (name == "wifi-good") {
+        p.rttMs = 20;
+        p.jitterMs = 5;
+        p.bandwidthKbps = 50000;
+    } else if (name == "wifi-lossy") {
+        p.rttMs = 40;
+        p.jitterMs = 30;
+        p.bandwidthKbps = 20000;
+        p.lossPercent = 2.0;
+    } else if (name == "wifi-congested") {
+        p.rttMs = 150;
+        p.jitterMs = 100;
+        p.bandwidthKbps = 2000;
+        p.lossPercent = 5.0;
+    } else if (name == "flaky-half-open") {
+        // 部分连接在 3 秒后变成黑洞：用于观察 30 秒空闲超时与重连风暴
+        p.rttMs = 40;
+        p.jitterMs = 20;
+        p.bandwidthKbps = 20000;
+        p.lossPercent = 1.0;
+        p.halfOpenPercent = 30.0;
+        p.halfOpenAfterMs = 3000;
+    } else if (name == "dead-link") {
+        // TCP 能建立，但没有任何数据能通过（机器人 Wi-Fi 掉线时的典型表现）
+        p.rttMs = 40;
+        p.halfOpenPercent = 100.0;
+        p.halfOpenAfterMs = 0;
+    } else {
+        return false;
+    }
+    out = p;
+    return true;
+}
+
+std::vector<std::string> NetworkProxy::namedProfiles() {
+    return {"lan", "wifi-good", "wifi-lossy", "wifi-congested", "flaky-half-open", "dead-link"};
+}
+
+int NetworkProxy::getListenPort() const { return listenPort; }
+
+bool NetworkProxy::isRunning() const { return running.load(); }
+
+uint64_t NetworkProxy::getForwardedBytes() const { return forwardedBytes.load(); }
+
+NetworkProxy::Stats NetworkProxy::getStats() const {
+    Stats stats;
+    stats.forwardedBytes = forwardedBytes.load();
+    stats.connections = connectionCount.load();
+    stats.lossEvents = lossEvents.load();
+    stats.halfOpenConnections = halfOpenCount.load();
+    stats.blackholedBytes = blackholedBytes.load();
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    for (const auto& conn : connections) {
+        if (conn->activeThreads.load() > 0) {
+            ++stats.activeConnections;
+        }
+    }
+    return stats;
+}
+
+SOCKET NetworkProxy::connectUpstream() {
+    SOCKET s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s == INVALID_SOCKET) {
+        return INVALID_SOCKET;
+    }
+
+    sockaddr_in sin{};
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(static_cast<u_short>(upstreamPort));
+    if (inet_pton(AF_INET, upstreamHost.c_str(), &sin.sin_addr) != 1 ||
+        connect(s, reinterpret_cast<sockaddr*>(&sin), sizeof(sin))) {
+        closesocket(s);
+        return INVALID_SOCKET;
+    }
+    setNoDelay(s);
+    return s;
+}
+
+void NetworkProxy::reapFinishedConnections() {
+    // 回收四个转发线程都已退出的连接，避免重连风暴场景下线程和句柄无限增长
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    auto it = connections.begin();
+    while (it != connections.end()) {
+        Connection* conn = it->get();
+        if (conn->activeThreads.load() == 0) {
+            for (auto& t : conn->threads) {
+                if (t.joinable()) {
+                    t.join();
+                }
+            }
+            closesocket(conn->client);
+            closesocket(conn->upstream);
+            it = connections.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void NetworkProxy::acceptLoop() {
+    while (running.load()) {
+        reapFinishedConnections();
+
+        // 使用带超时的 select，使 stop() 能在 200ms 内让本线程退出
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        FD_SET(listenSock, &readfds);
+        timeval tv;
+        tv.tv_sec = 0;
+        tv.tv_usec = 200 * 1000;
+
+        int sel = select(static_cast<int>(listenSock) + 1, &readfds, nullptr, nullptr, &tv);
+        if (sel <= 0) {
+            continue;
+        }
+
+        SOCKET client = accept(listenSock, nullptr, nullptr);
+        if (client == INVALID_SOCKET) {
+            continue;
+        }
+        setNoDelay(client);
+
+        SOCKET upstream = connectUpstream();
+        if (upstream == INVALID_SOCKET) {
+            closesocket(client);
+            continue;
+        }
+
+        Profile current = getProfile();
+        auto conn = std::make_unique<Connection>();
+        conn->client = client;
+        conn->upstream = upstream;
+        if (rollPercent(current.halfOpenPercent)) {
+            conn->halfOpen = true;
+            conn->blackholeAt = Clock::now() + std::chrono::milliseconds(current.halfOpenAfterMs);
+            halfOpenCount.fetch_add(1);
+        }
+        connectionCount.fetch_add(1);
+
+        Connection* raw = conn.get();
+        raw->activeThreads.store(4);
+        raw->threads.emplace_back(&NetworkProxy::readLoop, this, raw, client, &raw->toUpstream);
+        raw->threads.emplace_back(&NetworkProxy::writeLoop, this, raw, upstream, &raw->toUpstream);
+        raw->threads.emplace_back(&NetworkProxy::readLoop, this, raw, upstream, &raw->toClient);
+        raw->threads.emplace_back(&NetworkProxy::writeLoop, this, raw, client, &raw->toClient);
+
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        connections.push_back(std::move(conn));
+    }
+}
+
+bool NetworkProxy::isBlackholed(const Connection* conn) {
+    return conn->halfOpen && Clock::now() >= conn->blackholeAt;
+}
+
+void NetworkProxy::closePipe(Pipe* pipe) {
+    {
+        std::lock_guard<std::mutex> lock(pipe->mutex);
+        pipe->closed = true;
+    }
+    pipe->cv.notify_all();
+}
+
+void NetworkProxy::readLoop(Connection* conn, SOCKET from, Pipe* pipe) {
+    std::vector<char> buffer(16 * 1024);
+
+    while (running.load()) {
+        int n = recv(from, buffer.data(), static_cast<int>(buffer.size()), 0);
+        if (n <= 0) {
+            break; // 对端关闭或出错
+        }
+
+        if (isBlackholed(conn)) {
+            // 半开：吞掉数据但保持连接，对端只能依靠自身超时发现问题
+            blackholedBytes.fetch_add(static_cast<uint64_t>(n));
+            continue;
+        }
+
+        Profile current = getProfile();
+        auto delay = std::chrono::microseconds(static_cast<int64_t>(current.rttMs) * 500);
+        if (current.jitterMs > 0) {
+            std::uniform_int_distribution<int> dist(0, current.jitterMs * 1000);
+            delay += std::chrono::microseconds(dist(rng()));
+        }
+        if (rollPercent(current.lossPercent)) {
+            delay += std::chrono::milliseconds(current.retransmitTimeoutMs);
+            lossEvents.fetch_add(1);
+        }
+
+        Chunk chunk;
+        chunk.data.assign(buffer.data(), buffer.data() + n);
+        {
+            std::lock_guard<std::mutex> lock(pipe->mutex);
+            // TCP 保证有序：后到的数据块不得早于前一个数据块送达（队头阻塞）
+            chunk.deliverAt = std::max(Clock::now() + delay, pipe->lastDeliverAt);
+            pipe->lastDeliverAt = chunk.deliverAt;
+            pipe->queue.push_back(std::move(chunk));
+        }
+        pipe->cv.notify_one();
+    }
+
+    closePipe(pipe);
+    conn->activeThreads.fetch_sub(1);
+}
+
+void NetworkProxy::writeLoop(Connection* conn, SOCKET to, Pipe* pipe) {
+    // 链路空闲时刻：用于按带宽计算串行化时延（token bucket 的等价形式）
+    Clock::time_point linkFreeAt = Clock::now();
+
+    while (true) {
+        Chunk chunk;
+        {
+            std::unique_lock<std::mutex> lock(pipe->mutex);
+            pipe->cv.wait(lock, [pipe]() { return !pipe->queue.empty() || pipe->closed; });
+            if (pipe->queue.empty()) {
+                break; // 已关闭且数据已全部送出
+            }
+            chunk = std::move(pipe->queue.front());
+            pipe->queue.pop_front();
+        }
+
+        Clock::time_point sendAt = std::max(chunk.deliverAt, linkFreeAt);
+        std::this_thread::sleep_until(sendAt);
+
+        if (isBlackholed(conn)) {
+            blackholedBytes.fetch_add(chunk.data.size());
+            continue;
+        }
+
+        size_t offset = 0;
+        while (offset < chunk.data.size()) {
+            int sent = send(to, chunk.data.data() + offset, static_cast<int>(chunk.data.size() - offset), 0);
+            if (sent <= 0) {
+                closePipe(pipe);
+                shutdown(to, SD_BOTH);
+                conn->activeThreads.fetch_sub(1);
+                return;
+            }
+            offset += static_cast<size_t>(sent);
+        }
+        forwardedBytes.fetch_add(chunk.data.size());
+
+        int64_t bandwidthKbps = getProfile().bandwidthKbps;
+        if (bandwidthKbps > 0) {
+            // bytes * 8 / (kbit/s * 1000) 秒
+            auto serialization = std::chrono::microseconds(
+                static_cast<int64_t>(chunk.data.size()) * 8 * 1000 / bandwidthKbps);
+            linkFreeAt = std::max(sendAt, Clock::now()) + serialization;
+        }
+    }
+
+    // 半关闭：把 EOF 传递给另一端，保持 ssh 会话的正常关闭语义（黑洞连接不传递）
+    if (!isBlackholed(conn)) {
+        shutdown(to, SD_SEND);
+    }
+    conn->activeThreads.fetch_sub(1);
+}
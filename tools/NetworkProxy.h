@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ws2tcpip.h>
+#include <winsock2.h>
+#include <Windows.h>
+#include "Exceptions.h"
+
+#pragma comment(lib, "ws2_32.lib")
+
+// ===== 用户态网络损伤代理 =====
+// 在本机监听一个端口，把每个入站连接转发到 upstream（通常是 sshd:22），
+// 并在两个方向上注入时延、抖动、带宽上限、丢包和半开连接。
+// 用于在没有机器人的普通开发机上复现 Wi-Fi 链路的特性，
+// 使 SSHManager / ConfigReader 在弱网下的行为（超时、重试、重连）可以被复现和量化。
+//
+// 说明：代理工作在 TCP 之上，无法真正丢弃 IP 包。“丢包”以 TCP 重传的可观测效果来模拟：
+// 命中丢包的数据块及其后所有数据（队头阻塞）推迟 retransmitTimeoutMs 才送出。
+class NetworkProxy {
+public:
+    struct Profile {
+        int rttMs = 0;                 // 往返时延（毫秒），每个方向注入 rttMs / 2
+        int jitterMs = 0;              // 每个数据块额外的随机时延 [0, jitterMs]，保持 TCP 有序
+        int64_t bandwidthKbps = 0;     // 每个方向的带宽上限（kbit/s），0 表示不限速
+        double lossPercent = 0.0;      // 每个数据块触发“丢包重传”的概率（%）
+        int retransmitTimeoutMs = 200; // 丢包后的重传惩罚（Linux 最小 RTO 为 200ms）
+        double halfOpenPercent = 0.0;  // 新连接变为半开（黑洞）连接的概率（%）
+        int halfOpenAfterMs = 0;       // 半开连接在建立多久后开始吞掉所有数据（不发 FIN/RST）
+    };
+
+    struct Stats {
+        uint64_t forwardedBytes = 0;
+        uint64_t connections = 0;        // 累计接受的连接数
+        uint64_t activeConnections = 0;  // 当前仍在转发的连接数
+        uint64_t lossEvents = 0;         // 模拟丢包重传的次数
+        uint64_t halfOpenConnections = 0;
+        uint64_t blackholedBytes = 0;    // 被半开连接吞掉的字节数
+    };
+
+    NetworkProxy(const std::string& upstreamHost, int upstreamPort, const Profile& profile);
+
+    NetworkProxy(const NetworkProxy&) = delete;
+    NetworkProxy& operator=(const NetworkProxy&) = delete;
+
+    ~NetworkProxy();
+
+    // 开始监听；listenPort 为 0 时由系统分配端口，可通过 getListenPort() 查询。
+    // bindAddress 可设为 127.0.0.2 等回环地址，使 GUI 以“IP:22”的形式连接代理。
+    void start(int listenPort = 0, const std::string& bindAddress = "127.0.0.1");
+
+    // 停止监听并断开所有转发中的连接
+    void stop();
+
+    // 运行中切换损伤参数（例如模拟链路突然变差），对已有连接的后续数据立即生效
+    void setProfile(const Profile& newProfile);
+    Profile getProfile() const;
+
+    // 按名称获取预置的场景配置，未知名称返回 false
+    // 预置: lan, wifi-good, wifi-lossy, wifi-congested, flaky-half-open, dead-link
+    static bool namedProfile(const std::string& name, Profile& out);
+    static std::vector<std::string> namedProfiles();
+
+    int getListenPort() const;
+    bool isRunning() const;
+
+    // 累计转发字节数（两个方向之和）
+    uint64_t getForwardedBytes() const;
+    Stats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // 一个方向上待转发的数据块，deliverAt 为最早允许写出的时间
+    struct Chunk {
+        std::vector<char> data;
+        Clock::time_point deliverAt;
+    };
+
+    // 单方向管道：reader 线程 recv 后入队，writer 线程按延迟/带宽出队 send
+    struct Pipe {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<Chunk> queue;
+        Clock::time_point lastDeliverAt; // 保证抖动不会打乱 TCP 字节序
+        bool closed = false;
+    };
+
+    struct Connection {
+        SOCKET client = INVALID_SOCKET;
+        SOCKET upstream = INVALID_SOCKET;
+        Pipe toUpstream;
+        Pipe toClient;
+        std::vector<std::thread> threads;
+        std::atomic<int> activeThreads{0};
+        bool halfOpen = false;
+        Clock::time_point blackholeAt;
+    };
+
+    void acceptLoop();
+    void readLoop(Connection* conn, SOCKET from, Pipe* pipe);
+    void writeLoop(Connection* conn, SOCKET to, Pipe* pipe);
+    SOCKET connectUpstream();
+    void reapFinishedConnections();
+    static bool isBlackholed(const Connection* conn);
+    static void closePipe(Pipe* pipe);
+
+    std::string upstreamHost;
+    int upstreamPort;
+
+    mutable std::mutex profileMutex;
+    Profile profile;
+
+    SOCKET listenSock = INVALID_SOCKET;
+    int listenPort = 0;
+    std::atomic<bool> running{false};
+    std::thread acceptThread;
+
+    std::atomic<uint64_t> forwardedBytes{0};
+    std::atomic<uint64_t> connectionCount{0};
+    std::atomic<uint64_t> lossEvents{0};
+    std::atomic<uint64_t> halfOpenCount{0};
+    std::atomic<uint64_t> blackholedBytes{0};
+
+    mutable std::mutex connectionsMutex;
+    std::vector<std::unique_ptr<Connection>> connections;
+};
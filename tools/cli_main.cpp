@@ -0,0 +1,515 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+#include "BiasEstimator.h"
+#include "ConfigNotifier.h"
+#include "DriftLogStore.h"
+#include "FleetAudit.h"
+#include "FleetDrift.h"
+#include "FleetRollout.h"
+#include "TelemetryParser.h"
+
+// ===== adjustBias_cli =====
+// 离线分析机器人日志、批量审计机器人参数的命令行工具，与 GUI 共用 DriftLogStore / BiasEstimator / SSHManager。
+//
+// 用法:
+//   adjustBias_cli convert <日志.csv> [输出.abcol]
+//   adjustBias_cli info <日志>
+//   adjustBias_cli analyze <日志> [--channel NAME]... [--where COND]... [--from T] [--to T] [--impl scalar|avx2|auto]
+//   adjustBias_cli estimate <日志>
+//   adjustBias_cli audit <清单> [--param NAME]... [--format csv|json] [--out FILE] [--jobs N]
+//                        [--connect-timeout MS] [--config PATH] [--password PW] [--engine threads|coroutines]
+//   adjustBias_cli drift <清单> --golden FILE [--tolerance X] [--format csv|json] [--out FILE] [--jobs N] ...
+//   adjustBias_cli rollout <清单> --set NAME=VALUE... [--stages SPEC] [--probe CMD] [--probe-timeout MS]
+//                          [--settle MS] [--notify SPEC] [--format csv|json] [--out FILE] [--jobs N] ...
+//
+// <日志> 可以是 .abcol 分析文件，也可以是文本日志（自动使用 / 生成旁边的 <日志>.abcol 缓存）。
+// 例：静止指令下的平均偏航角速度
+//   adjustBias_cli analyze drift.csv --channel wz --where "|cmd_wz|<=0" --where "|cmd_vx|<=0" --where gait=walk
+// 例：所有机器人当前的 x_vel_limit_run（密码缺省取 ADJUSTBIAS_SSH_PASSWORD，未设置时只用 agent / 私钥）
+//   adjustBias_cli audit fleet.txt --param x_vel_limit_run --format json
+// 例：每日合规巡检，只列出与标准模板不一致的机器人及参数
+//   adjustBias_cli drift fleet.txt --golden rl_control_golden.txt
+// 例：先改 1 台，健康检查通过后扩大到 10%，再到全部；任何一台失败则全部恢复原值
+//   adjustBias_cli rollout fleet.txt --set x_vel_limit_run=1.8 --stages 1,10%,100% --probe "systemctl is-active rl_control"
+
+namespace {
+
+void printUsage() {
+    std::cout << "usage: adjustBias_cli convert LOG [OUT.abcol]\n"
+                 "       adjustBias_cli info LOG\n"
+                 "       adjustBias_cli analyze LOG [--channel NAME]... [--where COND]... [--from T] [--to T]\n"
+                 "                              [--impl scalar|avx2|auto]\n"
+                 "       adjustBias_cli estimate LOG\n"
+                 "       adjustBias_cli audit INVENTORY [--param NAME]... [--format csv|json] [--out FILE] [--jobs N]\n"
+                 "                            [--connect-timeout MS] [--config PATH] [--password PW]\n"
+                 "                            [--engine threads|coroutines]\n"
+                 "       adjustBias_cli drift INVENTORY --golden FILE [--tolerance X] [--format csv|json] [--out FILE]\n"
+                 "                            [--jobs N] [--connect-timeout MS] [--config PATH] [--password PW]\n"
+                 "       adjustBias_cli rollout INVENTORY --set NAME=VALUE... [--stages 1,10%,100%] [--probe CMD]\n"
+                 "                              [--probe-timeout MS] [--settle MS] [--notify SPEC] [--format csv|json]\n"
+                 "                              [--out FILE] [--jobs N] [--connect-timeout MS] [--config PATH] [--password PW]\n"
+                 "VALUE: a number, or 'delete' to remove x_vel_limit_walk / x_vel_limit_run\n"
+                 "COND: name=v name!=v name<v name<=v name>v name>=v |name|<v |name|<=v (v may be walk/run)"
+              << std::endl;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point started) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+}
+
+int runConvert(const std::vector<std::string>& args) {
+    if (args.empty() || args.size() > 2) {
+        printUsage();
+        return 2;
+    }
+    const std::string out = args.size() == 2 ? args[1] : args[0] + DriftLogStore::kExtension;
+    DriftLogStore::ConvertStats stats = DriftLogStore::convert(args[0], out);
+    std::printf("%s: %zu rows, %zu channels, %zu malformed lines, %.2f s\n", out.c_str(), stats.rows, stats.channels,
+                stats.malformedLines, stats.seconds);
+    return 0;
+}
+
+int runInfo(const std::vector<std::string>& args) {
+    if (args.size() != 1) {
+        printUsage();
+        return 2;
+    }
+    DriftLogStore store = DriftLogStore::openOrConvert(args[0]);
+    std::printf("rows: %zu\nmalformed lines: %zu\ntime: %s\n", store.rows(), store.malformedLines(),
+                !store.hasTime() ? "row index" : store.timeSorted() ? "sorted" : "unsorted");
+    if (store.rows() > 0) {
+        std::printf("range: %.6f .. %.6f\n", store.time()[0], store.time()[store.rows() - 1]);
+    }
+    std::printf("channels:");
+    for (const std::string& name : store.channels()) {
+        std::printf(" %s", name.c_str());
+    }
+    std::printf("\n");
+    return 0;
+}
+
+int runAnalyze(const std::vector<std::string>& args) {
+    std::string path;
+    std::vector<std::string> channels;
+    std::vector<DriftLogStore::Condition> where;
+    double tFrom = -std::numeric_limits<double>::infinity();
+    double tTo = std::numeric_limits<double>::infinity();
+    DriftLogStore::Impl impl = DriftLogStore::activeImpl();
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= args.size()) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return args[++i];
+        };
+        if (arg == "--channel") {
+            channels.push_back(next());
+        } else if (arg == "--where") {
+            const std::string text = next();
+            DriftLogStore::Condition condition;
+            if (!DriftLogStore::parseCondition(text, condition)) {
+                throw std::invalid_argument("invalid condition: " + text);
+            }
+            where.push_back(condition);
+        } else if (arg == "--from") {
+            tFrom = std::stod(next());
+        } else if (arg == "--to") {
+            tTo = std::stod(next());
+        } else if (arg == "--impl") {
+            const std::string name = next();
+            if (name == "auto") {
+                impl = DriftLogStore::activeImpl();
+                continue;
+            }
+            if (name != "scalar" && name != "avx2") {
+                std::cerr << "unknown impl: " << name << std::endl;
+                printUsage();
+                return 2;
+            }
+            impl = name == "scalar" ? DriftLogStore::Impl::Scalar : DriftLogStore::Impl::AVX2;
+            if (!DriftLogStore::isSupported(impl)) {
+                throw std::invalid_argument("unsupported impl on this CPU: " + name);
+            }
+        } else if (path.empty()) {
+            path = arg;
+        } else {
+            throw std::invalid_argument("unknown argument: " + arg);
+        }
+    }
+    if (path.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    DriftLogStore store = DriftLogStore::openOrConvert(path);
+    const double openMs = elapsedMs(started);
+    if (channels.empty()) {
+        channels = store.channels();
+    }
+
+    std::printf("%-16s %12s %14s %14s %14s %14s\n", "channel", "count", "mean", "stddev", "min", "max");
+    started = std::chrono::steady_clock::now();
+    for (const std::string& name : channels) {
+        DriftLogStore::Stats s = store.statsWith(impl, name, where, tFrom, tTo);
+        std::printf("%-16s %12zu %14.6g %14.6g %14.6g %14.6g\n", name.c_str(), s.count, s.mean, s.stddev, s.min, s.max);
+    }
+    std::printf("rows %zu, open %.1f ms, scan %.1f ms (%s)\n", store.rows(), openMs, elapsedMs(started),
+                DriftLogStore::implName(impl));
+    return 0;
+}
+
+int runEstimate(const std::vector<std::string>& args) {
+    if (args.size() != 1) {
+        printUsage();
+        return 2;
+    }
+    DriftLog log = DriftLog::fromStore(DriftLogStore::openOrConvert(args[0]));
+    BiasEstimator::Result result = BiasEstimator::estimate(log, {});
+    std::printf("%-20s %12s %10s %12s %10s\n", "param", "drift", "gain", "ci95", "samples");
+    for (const BiasEstimator::Estimate& est : result.estimates) {
+        if (est.valid) {
+            std::printf("%-20s %12.6f %10.4f %12.6f %10zu\n", est.param.c_str(), est.drift, est.gain, est.ci95, est.samples);
+        } else {
+            std::printf("%-20s %s\n", est.param.c_str(), est.note.c_str());
+        }
+    }
+    std::printf("samples %zu, malformed %zu, solve %.1f ms\n", result.samples, log.malformedLines, result.solveMs);
+    return 0;
+}
+
+// audit / drift 共用的连接参数；不是这些参数时返回 false
+template <typename Next>
+bool parseFleetOption(const std::string& arg, Next&& next, FleetAudit::Options& options) {
+    if (arg == "--jobs") {
+        options.jobs = std::stoi(next());
+    } else if (arg == "--connect-timeout") {
+        options.connectTimeoutMs = std::stoi(next());
+    } else if (arg == "--config") {
+        options.configPath = next();
+    } else if (arg == "--password") {
+        options.password = next();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+FleetAudit::Options defaultFleetOptions() {
+    FleetAudit::Options options;
+    if (const char* password = std::getenv("ADJUSTBIAS_SSH_PASSWORD")) {
+        options.password = password;
+    }
+    return options;
+}
+
+// --out 指定时写入文件，否则写到标准输出
+class OutputTarget {
+public:
+    explicit OutputTarget(const std::string& path) {
+        if (!path.empty()) {
+            file.open(path, std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("cannot write " + path);
+            }
+        }
+    }
+    std::ostream& stream() { return file.is_open() ? static_cast<std::ostream&>(file) : std::cout; }
+
+private:
+    std::ofstream file;
+};
+
+int runAudit(const std::vector<std::string>& args) {
+    std::string inventory;
+    std::vector<std::string> params;
+    std::string format = "csv";
+    std::string outPath;
+    FleetAudit::Options options = defaultFleetOptions();
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= args.size()) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return args[++i];
+        };
+        if (arg == "--param") {
+            params.push_back(next());
+        } else if (arg == "--format") {
+            format = next();
+            if (format != "csv" && format != "json") {
+                throw std::invalid_argument("unknown format: " + format);
+            }
+        } else if (arg == "--out") {
+            outPath = next();
+        } else if (arg == "--engine") {
+            const std::string engine = next();
+            if (engine == "threads") {
+                options.engine = FleetAudit::Engine::Threads;
+            } else if (engine == "coroutines") {
+                options.engine = FleetAudit::Engine::Coroutines;
+            } else {
+                throw std::invalid_argument("unknown engine: " + engine);
+            }
+        } else if (parseFleetOption(arg, next, options)) {
+        } else if (inventory.empty()) {
+            inventory = arg;
+        } else {
+            throw std::invalid_argument("unknown argument: " + arg);
+        }
+    }
+    if (inventory.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    const std::vector<FleetHost> hosts = FleetInventory::loadFile(inventory);
+    const auto started = std::chrono::steady_clock::now();
+    std::vector<FleetAudit::HostResult> results = FleetAudit::run(
+        hosts, options, [](const FleetAudit::HostResult& r, size_t done, size_t total) {
+            std::fprintf(stderr, "[%zu/%zu] %-16s %-6s %6.0f ms %s\n", done, total, r.host.name.c_str(),
+                         r.ok ? "ok" : "failed", r.elapsedMs, r.error.c_str());
+        });
+
+    OutputTarget out(outPath);
+    if (format == "json") {
+        FleetAudit::writeJson(out.stream(), results, params);
+    } else {
+        FleetAudit::writeCsv(out.stream(), results, params);
+    }
+
+    const size_t failed = static_cast<size_t>(
+        std::count_if(results.begin(), results.end(), [](const FleetAudit::HostResult& r) { return !r.ok; }));
+    std::fprintf(stderr, "%zu hosts, %zu failed, %.1f s (%d jobs, %s)\n", results.size(), failed,
+                 elapsedMs(started) / 1000.0, options.jobs,
+                 options.engine == FleetAudit::Engine::Coroutines ? "coroutines" : "threads");
+    return failed == 0 ? 0 : 3;
+}
+
+int runDrift(const std::vector<std::string>& args) {
+    std::string inventory;
+    std::string goldenPath;
+    double tolerance = 0.0;
+    std::string format = "csv";
+    std::string outPath;
+    FleetAudit::Options options = defaultFleetOptions();
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= args.size()) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return args[++i];
+        };
+        if (arg == "--golden") {
+            goldenPath = next();
+        } else if (arg == "--tolerance") {
+            tolerance = std::stod(next());
+        } else if (arg == "--format") {
+            format = next();
+            if (format != "csv" && format != "json") {
+                throw std::invalid_argument("unknown format: " + format);
+            }
+        } else if (arg == "--out") {
+            outPath = next();
+        } else if (parseFleetOption(arg, next, options)) {
+        } else if (inventory.empty()) {
+            inventory = arg;
+        } else {
+            throw std::invalid_argument("unknown argument: " + arg);
+        }
+    }
+    if (inventory.empty() || goldenPath.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    const FleetDrift::Golden golden = FleetDrift::Golden::loadFile(goldenPath);
+    const std::vector<FleetHost> hosts = FleetInventory::loadFile(inventory);
+    const auto started = std::chrono::steady_clock::now();
+    std::vector<FleetDrift::HostResult> results = FleetDrift::run(
+        hosts, golden, options, tolerance, [](const FleetDrift::HostResult& r, size_t done, size_t total) {
+            std::fprintf(stderr, "[%zu/%zu] %-16s %-11s %6.0f ms %zu diffs %s\n", done, total, r.host.name.c_str(),
+                         FleetDrift::statusName(r.status), r.elapsedMs, r.diffs.size(), r.error.c_str());
+        });
+
+    OutputTarget out(outPath);
+    if (format == "json") {
+        FleetDrift::writeJson(out.stream(), results);
+    } else {
+        FleetDrift::writeCsv(out.stream(), results);
+    }
+
+    size_t matched = 0;
+    size_t bytes = 0;
+    for (const FleetDrift::HostResult& r : results) {
+        matched += r.status == FleetDrift::Status::Match || r.status == FleetDrift::Status::FormatOnly;
+        bytes += r.bytesReceived;
+    }
+    std::fprintf(stderr, "%zu hosts, %zu compliant, %zu drifted or failed, %zu bytes received, %.1f s\n",
+                 results.size(), matched, results.size() - matched, bytes, elapsedMs(started) / 1000.0);
+    return matched == results.size() ? 0 : 3;
+}
+
+// NAME=VALUE；VALUE 为 delete 时传 NaN（与界面上清空 x_vel_limit_* 的语义相同）
+std::pair<std::string, double> parseAssignment(const std::string& text) {
+    const size_t eq = text.find('=');
+    if (eq == std::string::npos || eq == 0) {
+        throw std::invalid_argument("expected NAME=VALUE: " + text);
+    }
+    const std::string name = text.substr(0, eq);
+    const std::string value = text.substr(eq + 1);
+    if (value == "delete") {
+        if (name != "x_vel_limit_walk" && name != "x_vel_limit_run") {
+            throw std::invalid_argument("only x_vel_limit_walk / x_vel_limit_run can be deleted");
+        }
+        return {name, std::numeric_limits<double>::quiet_NaN()};
+    }
+    double number = 0.0;
+    if (!TelemetryLineParser::parseNumber(value, number) || !std::isfinite(number)) {
+        throw std::invalid_argument("invalid value: " + text);
+    }
+    return {name, number};
+}
+
+int runRollout(const std::vector<std::string>& args) {
+    std::string inventory;
+    std::vector<std::pair<std::string, double>> params;
+    std::string format = "csv";
+    std::string outPath;
+    FleetRollout::Options options;
+    options.fleet = defaultFleetOptions();
+    options.notifier = IConfigNotifier::fromEnvironment();
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= args.size()) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return args[++i];
+        };
+        if (arg == "--set") {
+            params.push_back(parseAssignment(next()));
+        } else if (arg == "--stages") {
+            options.stages = next();
+        } else if (arg == "--probe") {
+            options.probeCommand = next();
+        } else if (arg == "--probe-timeout") {
+            options.probeTimeoutMs = std::stoi(next());
+        } else if (arg == "--settle") {
+            options.settleMs = std::stoi(next());
+        } else if (arg == "--notify") {
+            const std::string spec = next();
+            options.notifier = IConfigNotifier::fromSpec(spec);
+            if (!options.notifier) {
+                throw std::invalid_argument("invalid notify spec: " + spec);
+            }
+        } else if (arg == "--format") {
+            format = next();
+            if (format != "csv" && format != "json") {
+                throw std::invalid_argument("unknown format: " + format);
+            }
+        } else if (arg == "--out") {
+            outPath = next();
+        } else if (parseFleetOption(arg, next, options.fleet)) {
+        } else if (inventory.empty()) {
+            inventory = arg;
+        } else {
+            throw std::invalid_argument("unknown argument: " + arg);
+        }
+    }
+    if (inventory.empty() || params.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    const std::vector<FleetHost> hosts = FleetInventory::loadFile(inventory);
+    const std::vector<size_t> plan = FleetRollout::planStages(options.stages, hosts.size());
+    std::fprintf(stderr, "%zu hosts in %zu stages:", hosts.size(), plan.size());
+    for (size_t end : plan) {
+        std::fprintf(stderr, " %zu", end);
+    }
+    std::fprintf(stderr, "%s\n", options.probeCommand.empty() ? " (no health probe)" : "");
+
+    FleetRollout::Report report = FleetRollout::run(
+        hosts, params, options,
+        [](const FleetRollout::HostResult& r, size_t done, size_t total) {
+            std::fprintf(stderr, "[%zu/%zu] stage %d %-16s %-11s apply %5.0f ms probe %5.0f ms %s\n", done, total,
+                         r.stage, r.host.name.c_str(), FleetRollout::stateName(r.state), r.applyMs, r.probeMs,
+                         r.error.c_str());
+        },
+        [](const FleetRollout::StageReport& s) {
+            std::fprintf(stderr, "stage %d: %zu hosts, %zu ok, %zu failed, p50 %.0f ms, max %.0f ms, %.1f s\n",
+                         s.index, s.hosts, s.succeeded, s.failed, s.p50Ms, s.maxMs, s.durationMs / 1000.0);
+        });
+
+    OutputTarget out(outPath);
+    if (format == "json") {
+        FleetRollout::writeJson(out.stream(), report);
+    } else {
+        FleetRollout::writeCsv(out.stream(), report);
+    }
+
+    if (report.completed) {
+        std::fprintf(stderr, "rollout completed on %zu hosts\n", hosts.size());
+        return 0;
+    }
+    std::fprintf(stderr, "rollout aborted: %zu hosts rolled back, %zu rollback failures, %.1f s\n", report.rolledBack,
+                 report.rollbackFailed, report.rollbackMs / 1000.0);
+    return report.rollbackFailed == 0 ? 3 : 4;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 2;
+    }
+    const std::string command = argv[1];
+    const std::vector<std::string> args(argv + 2, argv + argc);
+
+    try {
+        if (command == "convert") {
+            return runConvert(args);
+        }
+        if (command == "info") {
+            return runInfo(args);
+        }
+        if (command == "analyze") {
+            return runAnalyze(args);
+        }
+        if (command == "estimate") {
+            return runEstimate(args);
+        }
+        if (command == "audit") {
+            return runAudit(args);
+        }
+        if (command == "drift") {
+            return runDrift(args);
+        }
+        if (command == "rollout") {
+            return runRollout(args);
+        }
+        printUsage();
+        return 2;
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+}
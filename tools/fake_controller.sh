@@ -0,0 +1,135 @@
+#!/usr/bin/env bash
+# ===== 本地替身控制器 =====
+# 在开发机或测试用 sshd 上模拟机器人控制器的热更新入口，用于验证 ConfigNotifier：
+#   ./fake_controller.sh <配置文件> [--pid <pid文件>] [--fifo <FIFO路径>] [--udp <端口>] [--ack <文件>] [--stream <端口>]
+# 每次收到重新加载请求（SIGHUP / FIFO 一行 / UDP 一行）都会重新读取配置并打印参数，
+# 指定 --ack 时把 "<次数> <sha256>" 原子写入该文件，ConfigNotifier 据此确认热更新已生效。
+# 指定 --stream 时在 127.0.0.1:<端口> 接受实时调节连接（ParameterStreamer），打印每条 SET 并回复 ACK。
+# 对应的客户端设置：
+#   ADJUSTBIAS_CONFIG_NOTIFY=signal:<pid文件>,ack=<ack文件>   或 fifo:<FIFO路径>,ack=...   或 udp:<端口>,ack=...
+#   ADJUSTBIAS_STREAM_PORT=<端口>（GUI 中勾选“实时调节”）
+set -u
+
+CONFIG=""
+PID_FILE=""
+FIFO=""
+UDP_PORT=""
+ACK_FILE=""
+STREAM_PORT=""
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --pid)  PID_FILE="$2"; shift 2 ;;
+        --fifo) FIFO="$2"; shift 2 ;;
+        --udp)  UDP_PORT="$2"; shift 2 ;;
+        --ack)  ACK_FILE="$2"; shift 2 ;;
+        --stream) STREAM_PORT="$2"; shift 2 ;;
+        -h|--help) sed -n '2,12p' "$0"; exit 0 ;;
+        *) CONFIG="$1"; shift ;;
+    esac
+done
+
+if [ -z "$CONFIG" ]; then
+    echo "usage: $0 <config> [--pid FILE] [--fifo PATH] [--udp PORT] [--ack FILE] [--stream PORT]" >&2
+    exit 2
+fi
+
+RELOADS=0
+CHILDREN=()
+
+reload() {
+    RELOADS=$((RELOADS + 1))
+    local hash
+    hash=$(sha256sum -- "$CONFIG" 2>/dev/null | cut -d' ' -f1)
+    echo "[$(date +%H:%M:%S.%3N)] reload #$RELOADS via $1 (sha256 ${hash:-missing})"
+    grep -E '^[a-z_]+=' -- "$CONFIG" 2>/dev/null | sed 's/^/    /'
+    if [ -n "$ACK_FILE" ]; then
+        printf '%s %s\n' "$RELOADS" "$hash" > "$ACK_FILE.tmp" && mv -f "$ACK_FILE.tmp" "$ACK_FILE"
+    fi
+}
+
+cleanup() {
+    # 监听子进程（含管道中的 python3）与当前的 sleep 都是本进程的直接子进程
+    pkill -P $$ 2>/dev/null
+    for pid in "${CHILDREN[@]}"; do
+        kill "$pid" 2>/dev/null
+    done
+    [ -n "$PID_FILE" ] && rm -f "$PID_FILE"
+    [ -n "$FIFO" ] && rm -f "$FIFO"
+    exit 0
+}
+trap cleanup INT TERM
+
+# FIFO 与 UDP 监听器运行在子进程中，收到一行后向主进程发送 USR1，由主进程统一执行 reload
+if [ -n "$FIFO" ]; then
+    [ -p "$FIFO" ] || { rm -f "$FIFO"; mkfifo "$FIFO"; }
+    (
+        while true; do
+            # 以读写方式打开，最后一个写端关闭时 read 不会反复得到 EOF
+            while IFS= read -r line; do
+                echo "fifo: $line" >&2
+                kill -USR1 $$
+            done <> "$FIFO"
+        done
+    ) &
+    CHILDREN+=($!)
+fi
+
+if [ -n "$UDP_PORT" ]; then
+    python3 -u -c '
+import socket, sys
+s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+s.bind(("127.0.0.1", int(sys.argv[1])))
+while True:
+    data, _ = s.recvfrom(4096)
+    print(data.decode(errors="replace").strip(), flush=True)
+' "$UDP_PORT" | while IFS= read -r line; do
+        echo "udp: $line" >&2
+        kill -USR1 $$
+    done &
+    CHILDREN+=($!)
+fi
+
+# 实时调节端口：每条 "SET <参数> <值> <序号> <时间>" 立即回复 "ACK <序号>"
+if [ -n "$STREAM_PORT" ]; then
+    python3 -u -c '
+import socket, sys, threading
+def serve(conn):
+    try:
+        with conn, conn.makefile("rb") as lines:
+            for raw in lines:
+                parts = raw.decode(errors="replace").split()
+                if len(parts) >= 4 and parts[0] == "SET":
+                    print("stream: %s = %s (seq %s)" % (parts[1], parts[2], parts[3]), file=sys.stderr, flush=True)
+                    conn.sendall(("ACK %s\n" % parts[3]).encode())
+    except OSError:
+        pass  # 客户端断开
+srv = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+srv.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+srv.bind(("127.0.0.1", int(sys.argv[1])))
+srv.listen(4)
+while True:
+    conn, _ = srv.accept()
+    conn.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    threading.Thread(target=serve, args=(conn,), daemon=True).start()
+' "$STREAM_PORT" &
+    CHILDREN+=($!)
+fi
+
+trap 'reload SIGHUP' HUP
+trap 'reload message' USR1
+
+if [ -n "$PID_FILE" ]; then
+    echo $$ > "$PID_FILE"
+fi
+
+echo "fake controller pid $$ watching $CONFIG (pid=${PID_FILE:--} fifo=${FIFO:--} udp=${UDP_PORT:--} stream=${STREAM_PORT:--})"
+reload startup
+
+# sleep 放在后台并用 wait 等待，信号到达时 trap 能立即执行
+while true; do
+    sleep 3600 &
+    SLEEPER=$!
+    wait $SLEEPER
+    kill $SLEEPER 2>/dev/null
+done
@@ -0,0 +1,173 @@
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include "NetworkProxy.h"
+
+// ===== adjustBias_netproxy =====
+// 独立运行的网络损伤代理，用于把 GUI / adjustBias_bench 指向一条“模拟的机器人 Wi-Fi 链路”。
+//
+// 用法:
+//   adjustBias_netproxy --upstream 192.168.1.6:22 [--listen 2222] [--bind 127.0.0.1]
+//                       [--profile wifi-lossy] [--rtt MS] [--jitter MS] [--bw KBPS]
+//                       [--loss PCT] [--rto MS] [--half-open PCT] [--half-open-after MS]
+//                       [--switch-after SEC --switch-to PROFILE]
+//                       [--stats-file stats.csv] [--duration SEC]
+//
+// GUI 只支持 22 端口，可使用 --bind 127.0.0.2 --listen 22，然后在界面中输入 127.0.0.2。
+
+namespace {
+
+std::atomic<bool> g_stop{false};
+
+void onSignal(int) { g_stop.store(true); }
+
+void printUsage() {
+    std::cout << "usage: adjustBias_netproxy --upstream HOST:PORT [--listen PORT] [--bind ADDR]\n"
+                 "         [--profile NAME] [--rtt MS] [--jitter MS] [--bw KBPS] [--loss PCT] [--rto MS]\n"
+                 "         [--half-open PCT] [--half-open-after MS] [--switch-after SEC --switch-to NAME]\n"
+                 "         [--stats-file FILE] [--duration SEC]\n"
+                 "profiles:";
+    for (const auto& name : NetworkProxy::namedProfiles()) {
+        std::cout << " " << name;
+    }
+    std::cout << std::endl;
+}
+
+void printStats(std::ostream& out, double elapsedSec, const NetworkProxy::Stats& s) {
+    out << elapsedSec << "," << s.forwardedBytes << "," << s.connections << "," << s.activeConnections << ","
+        << s.lossEvents << "," << s.halfOpenConnections << "," << s.blackholedBytes << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string upstreamHost;
+    int upstreamPort = 22;
+    int listenPort = 2222;
+    std::string bindAddress = "127.0.0.1";
+    std::string statsFile;
+    std::string switchTo;
+    int switchAfterSec = 0;
+    int durationSec = 0;
+    NetworkProxy::Profile profile;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("missing value for " + arg);
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--upstream") {
+                std::string value = next();
+                size_t colon = value.rfind(':');
+                upstreamHost = value.substr(0, colon);
+                if (colon != std::string::npos) {
+                    upstreamPort = std::stoi(value.substr(colon + 1));
+                }
+            } else if (arg == "--listen") {
+                listenPort = std::stoi(next());
+            } else if (arg == "--bind") {
+                bindAddress = next();
+            } else if (arg == "--profile") {
+                std::string name = next();
+                if (!NetworkProxy::namedProfile(name, profile)) {
+                    throw std::invalid_argument("unknown profile: " + name);
+                }
+            } else if (arg == "--rtt") {
+                profile.rttMs = std::stoi(next());
+            } else if (arg == "--jitter") {
+                profile.jitterMs = std::stoi(next());
+            } else if (arg == "--bw") {
+                profile.bandwidthKbps = std::stoll(next());
+            } else if (arg == "--loss") {
+                profile.lossPercent = std::stod(next());
+            } else if (arg == "--rto") {
+                profile.retransmitTimeoutMs = std::stoi(next());
+            } else if (arg == "--half-open") {
+                profile.halfOpenPercent = std::stod(next());
+            } else if (arg == "--half-open-after") {
+                profile.halfOpenAfterMs = std::stoi(next());
+            } else if (arg == "--switch-after") {
+                switchAfterSec = std::stoi(next());
+            } else if (arg == "--switch-to") {
+                switchTo = next();
+            } else if (arg == "--stats-file") {
+                statsFile = next();
+            } else if (arg == "--duration") {
+                durationSec = std::stoi(next());
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return 0;
+            } else {
+                throw std::invalid_argument("unknown argument: " + arg);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        printUsage();
+        return 2;
+    }
+
+    if (upstreamHost.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    NetworkProxy::Profile switchProfile;
+    if (!switchTo.empty() && !NetworkProxy::namedProfile(switchTo, switchProfile)) {
+        std::cerr << "error: unknown profile: " << switchTo << std::endl;
+        return 2;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    NetworkProxy proxy(upstreamHost, upstreamPort, profile);
+    try {
+        proxy.start(listenPort, bindAddress);
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "proxy " << bindAddress << ":" << proxy.getListenPort() << " -> " << upstreamHost << ":" << upstreamPort
+              << " rtt=" << profile.rttMs << "ms jitter=" << profile.jitterMs << "ms bw=" << profile.bandwidthKbps
+              << "kbps loss=" << profile.lossPercent << "% half-open=" << profile.halfOpenPercent << "%" << std::endl;
+
+    std::ofstream stats;
+    if (!statsFile.empty()) {
+        stats.open(statsFile, std::ios::trunc);
+        stats << "elapsed_s,forwarded_bytes,connections,active_connections,loss_events,half_open,blackholed_bytes"
+              << std::endl;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    bool switched = false;
+    while (!g_stop.load()) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+        if (!switched && !switchTo.empty() && elapsed >= switchAfterSec) {
+            proxy.setProfile(switchProfile);
+            switched = true;
+            std::cout << "switched profile to " << switchTo << std::endl;
+        }
+        if (stats.is_open()) {
+            printStats(stats, elapsed, proxy.getStats());
+        }
+        if (durationSec > 0 && elapsed >= durationSec) {
+            break;
+        }
+    }
+
+    NetworkProxy::Stats s = proxy.getStats();
+    proxy.stop();
+    std::cout << "forwarded=" << s.forwardedBytes << "B connections=" << s.connections << " loss_events=" << s.lossEvents
+              << " half_open=" << s.halfOpenConnections << " blackholed=" << s.blackholedBytes << "B" << std::endl;
+    return 0;
+}
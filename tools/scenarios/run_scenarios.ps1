@@ -0,0 +1,102 @@
+<#
+.SYNOPSIS
+    在每种网络损伤场景下运行 adjustBias_bench，记录加载/保存的延迟与吞吐量。
+
+.DESCRIPTION
+    对每个场景：启动 adjustBias_netproxy（指向 -Upstream），把 adjustBias_bench 指向代理端口，
+    运行连接 / loadConfig / updateMultipleParameters / atomicWriteRemoteFile 基准，
+    输出 Google Benchmark JSON、代理统计 CSV，最后汇总为 summary.csv。
+    超过 -TimeoutSec 仍未结束的场景记为 timeout（例如 dead-link 下握手会无限阻塞）。
+
+.EXAMPLE
+    .\run_scenarios.ps1 -BinDir ..\..\build\bin -Upstream 127.0.0.1:22 -User ubuntu -Password 123
+    .\run_scenarios.ps1 -BinDir ..\..\build\bin -Upstream 192.168.1.6:22 -Profiles wifi-lossy,flaky-half-open
+#>
+param(
+    [string]$BinDir = "..\..\build\bin",
+    [string]$Upstream = "127.0.0.1:22",
+    [string]$User = $env:USERNAME,
+    [string]$Password = "",
+    [string[]]$Profiles = @("lan", "wifi-good", "wifi-lossy", "wifi-congested", "flaky-half-open", "dead-link"),
+    [int]$ListenPort = 2222,
+    [int]$Repetitions = 3,
+    [int]$TimeoutSec = 300,
+    [string]$Filter = "BM_(SSHConnect|LoadConfig|UpdateMultipleParameters|AtomicWriteRemoteFile)",
+    [string]$OutDir = "scenario_results"
+)
+
+$ErrorActionPreference = "Stop"
+$proxyExe = Join-Path $BinDir "adjustBias_netproxy"
+$benchExe = Join-Path $BinDir "adjustBias_bench"
+New-Item -ItemType Directory -Force -Path $OutDir | Out-Null
+$summary = @()
+# adjustBias_bench 读取的进程内损伤变量（BenchEnvironment.cpp）
+$impairmentVars = @(
+    "ADJUSTBIAS_BENCH_PROFILE", "ADJUSTBIAS_BENCH_RTT_MS", "ADJUSTBIAS_BENCH_JITTER_MS",
+    "ADJUSTBIAS_BENCH_BW_KBPS", "ADJUSTBIAS_BENCH_LOSS_PCT")
+
+# 脚本会改写的环境变量：先保存原值，结束（含异常 / Ctrl+C）时在 finally 中恢复，原本未设置的则删除
+$touchedVars = @("ADJUSTBIAS_BENCH_HOST", "ADJUSTBIAS_BENCH_PORT", "ADJUSTBIAS_BENCH_USER", "ADJUSTBIAS_BENCH_PASSWORD") + $impairmentVars
+$savedEnv = @{}
+foreach ($name in $touchedVars) {
+    $savedEnv[$name] = [Environment]::GetEnvironmentVariable($name, "Process")
+}
+
+try {
+    foreach ($scenario in $Profiles) {
+        Write-Host "=== scenario: $scenario ===" -ForegroundColor Cyan
+        $benchJson = Join-Path $OutDir "$scenario.json"
+        $proxyCsv = Join-Path $OutDir "$scenario.proxy.csv"
+
+        $proxy = Start-Process -FilePath $proxyExe -PassThru -NoNewWindow -ArgumentList @(
+            "--upstream", $Upstream, "--listen", $ListenPort, "--profile", $scenario, "--stats-file", $proxyCsv)
+        Start-Sleep -Milliseconds 500
+
+        # 基准直连代理端口，代理负责注入损伤；清除所有进程内损伤变量（包括调用方环境中已有的），避免损伤叠加
+        $env:ADJUSTBIAS_BENCH_HOST = "127.0.0.1"
+        $env:ADJUSTBIAS_BENCH_PORT = "$ListenPort"
+        $env:ADJUSTBIAS_BENCH_USER = $User
+        $env:ADJUSTBIAS_BENCH_PASSWORD = $Password
+        foreach ($name in $impairmentVars) {
+            Remove-Item "Env:$name" -ErrorAction SilentlyContinue
+        }
+
+        $bench = Start-Process -FilePath $benchExe -PassThru -NoNewWindow -ArgumentList @(
+            "--benchmark_filter=$Filter", "--benchmark_repetitions=$Repetitions",
+            "--benchmark_report_aggregates_only=true",
+            "--benchmark_out=$benchJson", "--benchmark_out_format=json")
+
+        $finished = $bench.WaitForExit($TimeoutSec * 1000)
+        if (-not $finished) {
+            Stop-Process -Id $bench.Id -Force
+            $summary += [pscustomobject]@{ profile = $scenario; benchmark = "*"; mean_ms = ""; ops_per_s = ""; mb_per_s = ""; status = "timeout" }
+        }
+        Stop-Process -Id $proxy.Id -Force -ErrorAction SilentlyContinue
+
+        if ($finished -and (Test-Path $benchJson)) {
+            $result = Get-Content $benchJson -Raw | ConvertFrom-Json
+            foreach ($b in $result.benchmarks | Where-Object { $_.aggregate_name -eq "mean" }) {
+                $ms = [double]$b.real_time
+                $status = if ($b.error_occurred) { "error: $($b.error_message)" } else { "ok" }
+                $mbps = if ($b.bytes_per_second) { [math]::Round($b.bytes_per_second / 1MB, 3) } else { "" }
+                $summary += [pscustomobject]@{
+                    profile   = $scenario
+                    benchmark = $b.run_name
+                    mean_ms   = [math]::Round($ms, 2)
+                    ops_per_s = if ($ms -gt 0) { [math]::Round(1000.0 / $ms, 2) } else { "" }
+                    mb_per_s  = $mbps
+                    status    = $status
+                }
+            }
+        }
+    }
+} finally {
+    foreach ($name in $touchedVars) {
+        [Environment]::SetEnvironmentVariable($name, $savedEnv[$name], "Process")
+    }
+}
+
+$summaryPath = Join-Path $OutDir "summary.csv"
+$summary | Export-Csv -Path $summaryPath -NoTypeInformation -Encoding UTF8
+$summary | Format-Table -AutoSize
+Write-Host "summary written to $summaryPath"